@@ -13,10 +13,19 @@ SOURCES += \
     src/core/type.cpp \
     src/core/gameengine.cpp \
     src/core/savesystem.cpp \
+    src/core/speciescatalog.cpp \
     src/battle/battlesystem.cpp \
+    src/battle/battlelogsink.cpp \
+    src/battle/battlesignaladapter.cpp \
+    src/battle/battlereplay.cpp \
     src/battle/skill.cpp \
     src/battle/specialskills.cpp \
+    src/battle/skillregistry.cpp \
     src/battle/effect.cpp \
+    src/battle/aisearch.cpp \
+    src/battle/mctssearch.cpp \
+    src/battle/zobristhash.cpp \
+    src/battle/expectiminimax.cpp \
     src/ui/mainwindow.cpp \
     src/ui/battlescene.cpp \
     src/ui/preparescene.cpp \
@@ -30,10 +39,27 @@ HEADERS += \
     src/core/type.h \
     src/core/gameengine.h \
     src/core/savesystem.h \
+    src/core/speciescatalog.h \
     src/battle/battlesystem.h \
+    src/battle/battlerandom.h \
+    src/battle/battlestate.h \
+    src/battle/battlehistory.h \
+    src/battle/battleevent.h \
+    src/battle/battlelogsink.h \
+    src/battle/stringinterner.h \
+    src/battle/battleobserver.h \
+    src/battle/battleturnchanges.h \
+    src/battle/battlesignaladapter.h \
+    src/battle/battlevarint.h \
+    src/battle/battlereplay.h \
     src/battle/skill.h \
     src/battle/specialskills.h \
+    src/battle/skillregistry.h \
     src/battle/effect.h \
+    src/battle/aisearch.h \
+    src/battle/mctssearch.h \
+    src/battle/zobristhash.h \
+    src/battle/expectiminimax.h \
     src/ui/mainwindow.h \
     src/ui/battlescene.h \
     src/ui/preparescene.h \
@@ -47,8 +73,10 @@ FORMS += \
     src/ui/preparescene.ui
 
 # 资源文件
+# data/species.qrc内嵌精灵数据JSON；qmake构建不产出species.shcat，启动时由SpeciesCatalog编译内嵌的JSON
 RESOURCES += \
-    src/resources/resources.qrc
+    src/resources/resources.qrc \
+    data/species.qrc
 
 # 默认规则，使新编译器的警告作为错误
 QMAKE_CXXFLAGS += -Wall -Wextra -pedantic
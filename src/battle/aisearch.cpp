@@ -0,0 +1,178 @@
+// src/battle/aisearch.cpp
+#include "aisearch.h"
+#include "mctssearch.h"
+#include "expectiminimax.h"
+#include "../core/creature.h"
+
+namespace {
+
+// 队伍剩余HP占比
+double teamHealth(const QVector<Creature *> &team)
+{
+    int current = 0;
+    int maximum = 0;
+    for (const Creature *creature : team)
+    {
+        if (!creature) continue;
+        current += qMax(0, creature->getCurrentHP());
+        maximum += creature->getMaxHP();
+    }
+    return maximum > 0 ? static_cast<double>(current) / maximum : 0.0;
+}
+
+} // namespace
+
+AISearch::AISearch(BattleSystem &battle, const OpponentAIConfig &config)
+    : m_config(config),
+      m_seed(battle.getAIRandom().next()),
+      m_valid(false),
+      m_stopRequested(false)
+{
+    if (!battle.exportState(m_rootState))
+    {
+        return;
+    }
+
+    for (int side = 0; side < 2; ++side)
+    {
+        const QVector<Creature *> team = (side == 0) ? battle.getPlayerTeam() : battle.getOpponentTeam();
+        QVector<CreatureSpec> &specs = (side == 0) ? m_playerSpecs : m_opponentSpecs;
+        for (const Creature *creature : team)
+        {
+            if (!creature || creature->getSpeciesId() == SpeciesId::NONE)
+            {
+                return; // 无法在搜索线程中重建这只精灵
+            }
+            specs.append(CreatureSpec{creature->getSpeciesId(), creature->getLevel(), creature->getBaseStats(),
+                                      creature->getTalent(), creature->getMaxPP()});
+        }
+    }
+
+    m_rootMoves = legalMoves(battle, false);
+    m_valid = !m_rootMoves.isEmpty();
+}
+
+AISearch::~AISearch()
+{
+}
+
+std::shared_ptr<AISearch> AISearch::create(BattleSystem &battle, const OpponentAIConfig &config)
+{
+    switch (config.algorithm)
+    {
+    case AISearchAlgorithm::EXPECTIMINIMAX:
+        return std::make_shared<ExpectiminimaxSearch>(battle, config);
+    case AISearchAlgorithm::MCTS:
+    default:
+        return std::make_shared<MctsSearch>(battle, config);
+    }
+}
+
+bool AISearch::isValid() const
+{
+    return m_valid;
+}
+
+void AISearch::requestStop()
+{
+    m_stopRequested.store(true);
+}
+
+QVector<BattleMove> AISearch::legalMoves(const BattleSystem &battle, bool forPlayer)
+{
+    QVector<BattleMove> moves;
+    const QVector<Creature *> team = forPlayer ? battle.getPlayerTeam() : battle.getOpponentTeam();
+    Creature *active = forPlayer ? battle.getPlayerActiveCreature() : battle.getOpponentActiveCreature();
+    if (!active) return moves;
+
+    // 换人：当前精灵濒死时这是唯一的选择
+    for (int i = 0; i < team.size(); ++i)
+    {
+        if (team[i] && team[i] != active && !team[i]->isDead())
+        {
+            moves.append(BattleMove{BattleAction::SWITCH_CREATURE, i});
+        }
+    }
+    if (active->isDead())
+    {
+        return moves;
+    }
+    if (!active->canAct())
+    {
+        // 因状态无法行动：提交任意行动都会被战斗系统记为跳过
+        return QVector<BattleMove>{BattleMove{BattleAction::USE_SKILL, 0}};
+    }
+
+    for (int i = 0; i < active->getSkillCount(); ++i)
+    {
+        Skill *skill = active->getSkill(i);
+        if (skill && active->getCurrentPP() >= skill->getPPCost())
+        {
+            moves.append(BattleMove{BattleAction::USE_SKILL, i});
+        }
+    }
+    Skill *fifthSkill = active->getFifthSkill();
+    if (fifthSkill && active->getCurrentPP() >= fifthSkill->getPPCost())
+    {
+        moves.append(BattleMove{BattleAction::USE_SKILL, -1});
+    }
+    if (active->getCurrentPP() < active->getMaxPP())
+    {
+        moves.append(BattleMove{BattleAction::RESTORE_PP, -1});
+    }
+    return moves;
+}
+
+double AISearch::evaluate(const BattleSystem &battle)
+{
+    switch (battle.getBattleResult())
+    {
+    case BattleResult::OPPONENT_WIN:
+        return 1.0;
+    case BattleResult::PLAYER_WIN:
+    case BattleResult::ESCAPE:
+        return 0.0;
+    case BattleResult::DRAW:
+        return 0.5;
+    default:
+        break;
+    }
+    // 未分胜负：按双方剩余HP占比估值
+    return 0.5 + 0.5 * (teamHealth(battle.getOpponentTeam()) - teamHealth(battle.getPlayerTeam()));
+}
+
+void AISearch::applyMoves(BattleSystem &battle, const BattleMove &playerMove, const BattleMove &aiMove)
+{
+    battle.playerSubmittedAction(playerMove.action, playerMove.param);
+    battle.opponentSubmittedAction(aiMove.action, aiMove.param);
+}
+
+AISearch::MirrorBattle::MirrorBattle(const AISearch &search)
+{
+    for (int side = 0; side < 2; ++side)
+    {
+        const QVector<CreatureSpec> &specs = (side == 0) ? search.m_playerSpecs : search.m_opponentSpecs;
+        QVector<Creature *> &team = (side == 0) ? m_playerTeam : m_opponentTeam;
+        for (const CreatureSpec &spec : specs)
+        {
+            Creature *creature = Creature::createSpecies(spec.species, spec.level);
+            creature->setBaseStats(spec.baseStats);
+            creature->setTalent(spec.talent);
+            creature->setMaxPP(spec.maxPP);
+            team.append(creature);
+        }
+    }
+
+    m_battle.reset(new BattleSystem());
+    m_battle->setBattleLogEnabled(false);
+    m_battle->setStateHashEnabled(false);
+    m_battle->initBattle(m_playerTeam, m_opponentTeam, true); // PvP模式：双方都通过提交接口行动
+    m_battle->importState(search.m_rootState);
+}
+
+AISearch::MirrorBattle::~MirrorBattle()
+{
+    m_battle.reset(); // 先销毁战斗，再释放它引用的精灵
+    qDeleteAll(m_playerTeam);
+    qDeleteAll(m_opponentTeam);
+}
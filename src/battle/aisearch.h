@@ -0,0 +1,82 @@
+// src/battle/aisearch.h
+#ifndef AISEARCH_H
+#define AISEARCH_H
+
+#include <QVector>
+#include <QString>
+#include <atomic>
+#include <memory>
+#include "battlesystem.h"
+
+// 对手AI搜索的公共部分
+// 在战斗所在线程上构造：导出根快照、记录双方队伍。
+// 之后的模拟都在搜索线程自建的镜像战斗中进行，不会触碰原战斗。
+class AISearch
+{
+public:
+    AISearch(BattleSystem &battle, const OpponentAIConfig &config);
+    virtual ~AISearch();
+
+    // 按配置创建对应算法的搜索
+    static std::shared_ptr<AISearch> create(BattleSystem &battle, const OpponentAIConfig &config);
+
+    // 能否镜像当前战斗（要求所有精灵都由模板创建）
+    bool isValid() const;
+
+    // 执行搜索并返回对手（AI一方）的行动；可在任意线程调用，会阻塞到搜索结束
+    virtual BattleMove run() = 0;
+
+    // 请求提前结束搜索（线程安全）
+    void requestStop();
+
+    // 一方当前可选的行动：可用技能、恢复PP、换上其他可战斗的精灵；当前精灵濒死时只能换人
+    static QVector<BattleMove> legalMoves(const BattleSystem &battle, bool forPlayer);
+
+    // AI（对手）视角的局面价值，取值[0, 1]
+    static double evaluate(const BattleSystem &battle);
+
+    // 双方同时提交行动，镜像战斗为PvP模式，双方都提交后立即结算
+    static void applyMoves(BattleSystem &battle, const BattleMove &playerMove, const BattleMove &aiMove);
+
+protected:
+    // 镜像战斗：用模板重建的双方队伍组成的一场PvP战斗，关闭日志并已导入根快照
+    // 每个搜索线程各自创建一个
+    class MirrorBattle
+    {
+    public:
+        explicit MirrorBattle(const AISearch &search);
+        ~MirrorBattle();
+
+        BattleSystem &getBattle() { return *m_battle; }
+
+    private:
+        QVector<Creature *> m_playerTeam;
+        QVector<Creature *> m_opponentTeam;
+        std::unique_ptr<BattleSystem> m_battle;
+    };
+
+    bool isStopRequested() const { return m_stopRequested.load(std::memory_order_relaxed); }
+
+    OpponentAIConfig m_config;
+    BattleState m_rootState;
+    QVector<BattleMove> m_rootMoves; // AI一方在根局面的可选行动
+    quint64 m_seed;                  // 由战斗随机流派生，固定种子时搜索可复现
+
+private:
+    // 创建镜像战斗所需的精灵描述
+    struct CreatureSpec
+    {
+        SpeciesId species;
+        int level;
+        BaseStats baseStats;
+        Talent talent;
+        int maxPP;
+    };
+
+    bool m_valid;
+    QVector<CreatureSpec> m_playerSpecs;
+    QVector<CreatureSpec> m_opponentSpecs;
+    std::atomic<bool> m_stopRequested;
+};
+
+#endif // AISEARCH_H
@@ -0,0 +1,93 @@
+// src/battle/battleevent.h
+#ifndef BATTLEEVENT_H
+#define BATTLEEVENT_H
+
+#include <QtGlobal>
+#include <type_traits>
+
+// 结构化的战斗事件
+// 战斗过程中只记录事件类型和几个整数（精灵用 (阵营, 队伍下标) 表示，技能用技能槽下标），
+// 不拼接任何文本；需要显示时再由 BattleSystem::formatBattleEvent 转成文字/HTML。
+// 无人读取日志的模拟战斗因此每条事件只需写入一个定长记录。
+
+// 每场战斗预先分配的事件容量，超出后按需扩容
+const int BATTLE_EVENT_RESERVE = 1024;
+
+// 事件类型，注释为格式化后的文字（%来源 %目标 %技能 %数值）
+enum class BattleEventKind : quint8
+{
+    TEXT,                       // 自由文本，value为文本池下标
+    BATTLE_STARTED,             // 战斗开始!
+    TURN_STARTED,               // --- 第 N 回合 ---
+    ACTION_PHASE,               // 行动处理阶段...
+    TURN_EFFECTS_PHASE,         // 回合结束效果结算...
+    BATTLE_ENDED_BY_EFFECTS,    // 战斗因回合开始/结束效果结束（value: 0开始 1结束，amount为结果代码）
+    BATTLE_CLEANUP,             // 战斗结束，正在清理状态效果...
+    RESTORING_CREATURES,        // 恢复所有精灵状态...
+    CREATURES_RESTORED,         // 所有精灵的状态已恢复。
+    ACTION_SUBMITTED,           // %来源 选择了行动.
+    CANNOT_ACT,                 // %来源 无法行动!（value为BattleEventReason）
+    OPPONENT_SWITCH_PLANNED,    // 对手换上了 %目标.
+    OPPONENT_RESTORE_PP_PLANNED, // 对手试图恢复PP.
+    OPPONENT_SKILL_PLANNED,     // 对手准备使用 %技能.
+    OPPONENT_NO_CREATURES,      // 对手没有其他可战斗的精灵了!
+    NO_USABLE_ACTION,           // %来源 无计可施!
+    UNKNOWN_SKILL,              // %来源 试图使用未知技能!
+    NOT_ENOUGH_PP,              // %来源 的 %技能 因PP不足使用失败!
+    NO_TARGET,                  // %来源 的技能 %技能 没有有效目标!
+    SKILL_USED,                 // %来源 使用了 %技能!
+    SKILL_DAMAGE,               // %来源的%技能对%目标造成了%数值点伤害！（value为相性×100）
+    SKILL_MISSED,               // %来源 的 %技能 未能命中 %目标!
+    FAINTED,                    // %来源 倒下了!
+    SWITCHED,                   // 你/对手换上了 %来源!
+    SWITCH_FAILED,              // 切换精灵失败
+    ITEM_USED,                  // %来源 使用了道具
+    PP_RESTORED,                // %来源 恢复了%数值点PP!
+    PP_RESTORE_FAILED,          // %来源 试图恢复PP但失败了
+    ESCAPE_BLOCKED,             // PvP战斗中无法逃跑!
+    ESCAPED,                    // 成功逃脱!
+    ESCAPE_FAILED,              // 逃跑失败!
+    HEALED,                     // %目标 恢复了%数值点生命值!
+    DAMAGED,                    // %目标 (因status状态)受到了%数值点伤害!
+    STAT_STAGE_CHANGED,         // %目标 的stat提高/降低了 N 级!（value为原等级，amount为新等级）
+    STATUS_CHANGED,             // %目标 陷入了 status 状态! / 状态解除了（value为原状态）
+    EFFECT_APPLIED,             // %目标 受到了「文本」的效果
+    TURN_EFFECT_APPLIED,        // %目标 获得了持续效果「文本」(%数值回合)
+    EFFECT_CLEARED,             // %目标 的 文本 被清除了!
+    STATUS_IMMUNE               // %目标 免疫了 status 状态!
+};
+
+const int BATTLE_EVENT_KIND_COUNT = static_cast<int>(BattleEventKind::STATUS_IMMUNE) + 1;
+
+// CANNOT_ACT 的原因
+enum class BattleEventReason : quint8
+{
+    BLOCKED,        // 提交行动时无法行动
+    SPECIAL_STATUS, // AI精灵因特殊状态无法行动
+    FAINTED,        // 已濒死
+    STATUS          // 结算时因状态无法行动
+};
+
+// 事件附加标记
+const quint8 BATTLE_EVENT_STAB = 0x01; // 属性一致加成
+
+// 一条战斗事件，定长且可按值拷贝
+struct BattleEvent
+{
+    BattleEventKind kind;
+    qint8 sourceSide;  // 0玩家 1对手 -1无
+    qint8 sourceIndex; // 在队伍中的下标
+    qint8 targetSide;
+    qint8 targetIndex;
+    qint8 skillIndex;  // 技能槽下标，-1为第五技能（仅技能相关事件有效）
+    quint8 status;     // StatusCondition
+    quint8 stat;       // StatType
+    quint8 flags;      // BATTLE_EVENT_* 标记
+    qint16 turn;       // 发生时的回合数
+    qint32 amount;     // 伤害、治疗、PP、新等级等数值
+    qint32 value;      // 附加数值（原等级、原状态、相性、文本池下标等）
+};
+
+static_assert(std::is_trivially_copyable<BattleEvent>::value, "BattleEvent必须可以直接按值拷贝");
+
+#endif // BATTLEEVENT_H
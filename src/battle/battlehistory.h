@@ -0,0 +1,68 @@
+// src/battle/battlehistory.h
+#ifndef BATTLEHISTORY_H
+#define BATTLEHISTORY_H
+
+#include "battlestate.h"
+
+// 最近若干回合的场上快照（环形缓冲）
+// BattleSystem在开战时与每回合结算结束时各记录一份，快照是定长的POD，
+// 写入只是覆盖最旧的槽位，不做任何堆分配；按回合号查找为常数时间。
+// 用于鹿管鹿管鹿鹿时间到了的“时间悖论”等需要把场上精灵恢复到之前某回合的效果。
+
+const int BATTLE_HISTORY_CAPACITY = 8; // 保存的回合数
+
+// 某回合结束时的场上状态
+struct TurnSnapshot
+{
+    qint32 turn; // 已结算完毕的回合（0为开战时）
+    quint8 teamSize[2];
+    qint8 activeIndex[2];
+    CreatureState creatures[2][BATTLE_STATE_MAX_TEAM_SIZE]; // 只有HP/PP/能力等级/异常状态/种类私有状态有效
+};
+
+class BattleHistory
+{
+public:
+    BattleHistory() : m_next(0), m_count(0) {}
+
+    void clear()
+    {
+        m_next = 0;
+        m_count = 0;
+    }
+
+    // 取出下一个写入槽位（覆盖最旧的快照），由调用方填写
+    TurnSnapshot &push()
+    {
+        TurnSnapshot &snapshot = m_snapshots[m_next];
+        m_next = (m_next + 1) % BATTLE_HISTORY_CAPACITY;
+        if (m_count < BATTLE_HISTORY_CAPACITY) ++m_count;
+        return snapshot;
+    }
+
+    int getCount() const { return m_count; }
+
+    const TurnSnapshot *getLatest() const
+    {
+        return m_count > 0 ? &m_snapshots[(m_next + BATTLE_HISTORY_CAPACITY - 1) % BATTLE_HISTORY_CAPACITY] : nullptr;
+    }
+
+    // 某回合结束时的快照，已被覆盖或从未记录时返回nullptr
+    // 快照按回合连续写入，因此直接由回合差算出槽位
+    const TurnSnapshot *findTurn(int turn) const
+    {
+        const TurnSnapshot *latest = getLatest();
+        if (!latest) return nullptr;
+        const int age = latest->turn - turn;
+        if (age < 0 || age >= m_count) return nullptr;
+        const TurnSnapshot &snapshot = m_snapshots[(m_next + BATTLE_HISTORY_CAPACITY - 1 - age) % BATTLE_HISTORY_CAPACITY];
+        return snapshot.turn == turn ? &snapshot : nullptr;
+    }
+
+private:
+    TurnSnapshot m_snapshots[BATTLE_HISTORY_CAPACITY];
+    int m_next;  // 下一个写入的槽位
+    int m_count; // 有效快照数
+};
+
+#endif // BATTLEHISTORY_H
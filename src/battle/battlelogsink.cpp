@@ -0,0 +1,240 @@
+// src/battle/battlelogsink.cpp
+#include "battlelogsink.h"
+#include "battlevarint.h"
+#include <cstring>
+
+// --- BattleLogSink ---
+
+BattleLogSink::~BattleLogSink()
+{
+}
+
+int BattleLogSink::addText(const QString &text)
+{
+    Q_UNUSED(text);
+    return -1;
+}
+
+void BattleLogSink::reset()
+{
+}
+
+// --- FullLogSink ---
+
+FullLogSink::FullLogSink()
+{
+    m_events.reserve(BATTLE_EVENT_RESERVE);
+}
+
+void FullLogSink::record(const BattleEvent &event)
+{
+    m_events.push_back(event);
+}
+
+int FullLogSink::addText(const QString &text)
+{
+    return static_cast<int>(m_texts.intern(text));
+}
+
+void FullLogSink::reset()
+{
+    m_events.clear(); // 保留已分配的容量
+    m_texts.clear();
+}
+
+const std::vector<BattleEvent> &FullLogSink::getEvents() const
+{
+    return m_events;
+}
+
+QString FullLogSink::getText(int index) const
+{
+    return index >= 0 ? m_texts.getString(static_cast<quint32>(index)) : QString();
+}
+
+// --- CompactLogSink ---
+
+namespace {
+
+// 字段掩码
+const quint8 COMPACT_TURN = 0x01;
+const quint8 COMPACT_SOURCE = 0x02;
+const quint8 COMPACT_TARGET = 0x04;
+const quint8 COMPACT_SKILL = 0x08;
+const quint8 COMPACT_CONDITION = 0x10; // status与stat
+const quint8 COMPACT_FLAGS = 0x20;
+const quint8 COMPACT_AMOUNT = 0x40;
+const quint8 COMPACT_VALUE = 0x80;
+
+// 精灵位置打包为一个字节：高4位阵营，低4位队伍下标
+char packSlot(qint8 side, qint8 index)
+{
+    return static_cast<char>((side << 4) | (index & 0x0F));
+}
+
+} // namespace
+
+CompactLogSink::CompactLogSink()
+    : m_eventCount(0),
+      m_lastTurn(0)
+{
+    m_data.reserve(BATTLE_EVENT_RESERVE * 4);
+}
+
+void CompactLogSink::record(const BattleEvent &event)
+{
+    quint8 mask = 0;
+    if (event.turn != m_lastTurn) mask |= COMPACT_TURN;
+    if (event.sourceSide >= 0) mask |= COMPACT_SOURCE;
+    if (event.targetSide >= 0) mask |= COMPACT_TARGET;
+    if (event.skillIndex != -1) mask |= COMPACT_SKILL;
+    if (event.status != 0 || event.stat != 0) mask |= COMPACT_CONDITION;
+    if (event.flags != 0) mask |= COMPACT_FLAGS;
+    if (event.amount != 0) mask |= COMPACT_AMOUNT;
+    if (event.value != 0) mask |= COMPACT_VALUE;
+
+    m_data.append(static_cast<char>(event.kind));
+    m_data.append(static_cast<char>(mask));
+    if (mask & COMPACT_TURN) writeVarint(m_data, event.turn);
+    if (mask & COMPACT_SOURCE) m_data.append(packSlot(event.sourceSide, event.sourceIndex));
+    if (mask & COMPACT_TARGET) m_data.append(packSlot(event.targetSide, event.targetIndex));
+    if (mask & COMPACT_SKILL) m_data.append(static_cast<char>(event.skillIndex));
+    if (mask & COMPACT_CONDITION)
+    {
+        m_data.append(static_cast<char>(event.status));
+        m_data.append(static_cast<char>(event.stat));
+    }
+    if (mask & COMPACT_FLAGS) m_data.append(static_cast<char>(event.flags));
+    if (mask & COMPACT_AMOUNT) writeVarint(m_data, event.amount);
+    if (mask & COMPACT_VALUE) writeVarint(m_data, event.value);
+
+    m_lastTurn = event.turn;
+    ++m_eventCount;
+}
+
+void CompactLogSink::reset()
+{
+    m_data.clear();
+    m_eventCount = 0;
+    m_lastTurn = 0;
+}
+
+const QByteArray &CompactLogSink::getData() const
+{
+    return m_data;
+}
+
+int CompactLogSink::getEventCount() const
+{
+    return m_eventCount;
+}
+
+bool CompactLogSink::decode(const QByteArray &data, std::vector<BattleEvent> &events)
+{
+    events.clear();
+    qint16 turn = 0;
+    int pos = 0;
+    while (pos < data.size())
+    {
+        if (pos + 2 > data.size()) return false;
+        BattleEvent event;
+        std::memset(&event, 0, sizeof(event));
+        const quint8 kind = static_cast<quint8>(data[pos++]);
+        const quint8 mask = static_cast<quint8>(data[pos++]);
+        if (kind >= BATTLE_EVENT_KIND_COUNT) return false;
+        event.kind = static_cast<BattleEventKind>(kind);
+        event.sourceSide = event.sourceIndex = -1;
+        event.targetSide = event.targetIndex = -1;
+        event.skillIndex = -1;
+
+        qint32 number = 0;
+        if (mask & COMPACT_TURN)
+        {
+            if (!readVarint(data, pos, number)) return false;
+            turn = static_cast<qint16>(number);
+        }
+        event.turn = turn;
+        // 剩余的定长字段所需字节数
+        const int fixedBytes = ((mask & COMPACT_SOURCE) ? 1 : 0) + ((mask & COMPACT_TARGET) ? 1 : 0) +
+                               ((mask & COMPACT_SKILL) ? 1 : 0) + ((mask & COMPACT_CONDITION) ? 2 : 0) +
+                               ((mask & COMPACT_FLAGS) ? 1 : 0);
+        if (pos + fixedBytes > data.size()) return false;
+        if (mask & COMPACT_SOURCE)
+        {
+            const quint8 slot = static_cast<quint8>(data[pos++]);
+            event.sourceSide = static_cast<qint8>(slot >> 4);
+            event.sourceIndex = static_cast<qint8>(slot & 0x0F);
+        }
+        if (mask & COMPACT_TARGET)
+        {
+            const quint8 slot = static_cast<quint8>(data[pos++]);
+            event.targetSide = static_cast<qint8>(slot >> 4);
+            event.targetIndex = static_cast<qint8>(slot & 0x0F);
+        }
+        if (mask & COMPACT_SKILL) event.skillIndex = static_cast<qint8>(data[pos++]);
+        if (mask & COMPACT_CONDITION)
+        {
+            event.status = static_cast<quint8>(data[pos++]);
+            event.stat = static_cast<quint8>(data[pos++]);
+        }
+        if (mask & COMPACT_FLAGS) event.flags = static_cast<quint8>(data[pos++]);
+        if ((mask & COMPACT_AMOUNT) && !readVarint(data, pos, event.amount)) return false;
+        if ((mask & COMPACT_VALUE) && !readVarint(data, pos, event.value)) return false;
+        events.push_back(event);
+    }
+    return true;
+}
+
+// --- CounterLogSink ---
+
+CounterLogSink::CounterLogSink()
+{
+    reset();
+}
+
+void CounterLogSink::record(const BattleEvent &event)
+{
+    ++m_counts[static_cast<int>(event.kind)];
+    if (event.targetSide < 0 || event.targetSide > 1) return;
+    switch (event.kind)
+    {
+    case BattleEventKind::SKILL_DAMAGE:
+    case BattleEventKind::DAMAGED:
+        m_damageTaken[event.targetSide] += event.amount;
+        break;
+    case BattleEventKind::HEALED:
+        m_healingReceived[event.targetSide] += event.amount;
+        break;
+    default:
+        break;
+    }
+}
+
+void CounterLogSink::reset()
+{
+    std::memset(m_counts, 0, sizeof(m_counts));
+    m_damageTaken[0] = m_damageTaken[1] = 0;
+    m_healingReceived[0] = m_healingReceived[1] = 0;
+}
+
+quint32 CounterLogSink::getCount(BattleEventKind kind) const
+{
+    return m_counts[static_cast<int>(kind)];
+}
+
+quint32 CounterLogSink::getTotalCount() const
+{
+    quint32 total = 0;
+    for (quint32 count : m_counts) total += count;
+    return total;
+}
+
+qint64 CounterLogSink::getDamageTaken(int side) const
+{
+    return (side == 0 || side == 1) ? m_damageTaken[side] : 0;
+}
+
+qint64 CounterLogSink::getHealingReceived(int side) const
+{
+    return (side == 0 || side == 1) ? m_healingReceived[side] : 0;
+}
@@ -0,0 +1,97 @@
+// src/battle/battlelogsink.h
+#ifndef BATTLELOGSINK_H
+#define BATTLELOGSINK_H
+
+#include <QByteArray>
+#include <QString>
+#include <vector>
+#include "battleevent.h"
+#include "stringinterner.h"
+
+// 战斗日志的接收者
+// BattleSystem把每条事件交给当前的接收者，由接收者决定保留多少信息。
+// 不需要日志时接收者为空指针（空接收者），每条事件只剩一次指针判断。
+class BattleLogSink
+{
+public:
+    virtual ~BattleLogSink();
+
+    virtual void record(const BattleEvent &event) = 0;
+    // 保存事件引用的文本（效果描述、自由文本），返回写入BattleEvent::value的编号；不保存文本时返回-1
+    virtual int addText(const QString &text);
+    // 新的一场战斗开始
+    virtual void reset();
+};
+
+// 日志级别，对应BattleSystem内置的几种接收者
+enum class BattleLogLevel
+{
+    FULL,     // 完整日志：保留全部事件和文本，可格式化显示，并发出battleEventAdded（界面使用）
+    COMPACT,  // 紧凑二进制：事件按变长编码追加到字节数组，用于大量保存
+    COUNTERS, // 只统计各类事件的次数与伤害/治疗总量
+    NONE      // 空接收者：不记录任何内容
+};
+
+// 完整日志
+class FullLogSink : public BattleLogSink
+{
+public:
+    FullLogSink();
+
+    void record(const BattleEvent &event) override;
+    int addText(const QString &text) override;
+    void reset() override;
+
+    const std::vector<BattleEvent> &getEvents() const;
+    QString getText(int index) const;
+
+private:
+    std::vector<BattleEvent> m_events; // 预分配BATTLE_EVENT_RESERVE条，reset不释放
+    StringInterner m_texts;            // 事件引用的文本，效果描述等重复出现的文本只保存一份
+};
+
+// 紧凑二进制日志
+// 每条事件：类型1字节 + 字段掩码1字节 + 与默认值不同的字段；回合只在变化时写入，数值为zigzag变长整数。
+// 典型事件只占3~5字节（定长的BattleEvent为20字节）。文本不保存。
+class CompactLogSink : public BattleLogSink
+{
+public:
+    CompactLogSink();
+
+    void record(const BattleEvent &event) override;
+    void reset() override;
+
+    const QByteArray &getData() const;
+    int getEventCount() const;
+
+    // 把getData()的内容还原成事件，数据损坏时返回false
+    static bool decode(const QByteArray &data, std::vector<BattleEvent> &events);
+
+private:
+    QByteArray m_data;
+    int m_eventCount;
+    qint16 m_lastTurn;
+};
+
+// 计数日志
+class CounterLogSink : public BattleLogSink
+{
+public:
+    CounterLogSink();
+
+    void record(const BattleEvent &event) override;
+    void reset() override;
+
+    quint32 getCount(BattleEventKind kind) const;
+    quint32 getTotalCount() const;
+    // side阵营（0玩家 1对手）的精灵受到的伤害/治疗总量，含技能伤害与状态伤害
+    qint64 getDamageTaken(int side) const;
+    qint64 getHealingReceived(int side) const;
+
+private:
+    quint32 m_counts[BATTLE_EVENT_KIND_COUNT];
+    qint64 m_damageTaken[2];
+    qint64 m_healingReceived[2];
+};
+
+#endif // BATTLELOGSINK_H
@@ -0,0 +1,60 @@
+// src/battle/battleobserver.h
+#ifndef BATTLEOBSERVER_H
+#define BATTLEOBSERVER_H
+
+#include "../core/ability.h"
+#include "battleevent.h"
+#include "battleturnchanges.h"
+
+class Creature;
+class Skill;
+enum class BattleResult;
+enum class BattleAction;
+
+// 战斗观察者
+// BattleSystem通过普通的虚函数调用通知观察者，不经过Qt的元对象系统，
+// 没有观察者时每个通知点只是遍历一个空数组。所有回调默认什么也不做，只需重写关心的事件。
+// 回调在BattleSystem所在的线程上同步调用；需要Qt信号的界面使用BattleSignalAdapter。
+class BattleObserver
+{
+public:
+    virtual ~BattleObserver() {}
+
+    virtual void onBattleStarted() {}
+    virtual void onBattleEnded(BattleResult result) { Q_UNUSED(result); }
+    virtual void onTurnStarted(int turn) { Q_UNUSED(turn); }
+    virtual void onTurnEnded(int turn) { Q_UNUSED(turn); } // 一个完整回合（双方行动后）的结束
+    virtual void onPlayerActionConfirmed() {}   // 玩家已提交本回合行动
+    virtual void onOpponentActionConfirmed() {} // 对手/AI已提交本回合行动
+    // 一方的行动被接受（在结算之前通知）；AI因无法行动而跳过时记为USE_SKILL 0，重新提交时同样会被跳过
+    virtual void onActionSubmitted(bool isPlayer, BattleAction action, int param1, int param2)
+    {
+        Q_UNUSED(isPlayer); Q_UNUSED(action); Q_UNUSED(param1); Q_UNUSED(param2);
+    }
+
+    // 技能结算完毕：hit为是否命中，damage为造成的伤害（非攻击技能为0）
+    virtual void onSkillUsed(Creature *user, Creature *target, Skill *skill, bool hit, int damage)
+    {
+        Q_UNUSED(user); Q_UNUSED(target); Q_UNUSED(skill); Q_UNUSED(hit); Q_UNUSED(damage);
+    }
+    virtual void onDamageCaused(Creature *creature, int damage) { Q_UNUSED(creature); Q_UNUSED(damage); }
+    virtual void onHealingReceived(Creature *creature, int amount) { Q_UNUSED(creature); Q_UNUSED(amount); }
+    virtual void onStatusChanged(Creature *creature, StatusCondition oldStatus, StatusCondition newStatus)
+    {
+        Q_UNUSED(creature); Q_UNUSED(oldStatus); Q_UNUSED(newStatus);
+    }
+    virtual void onStatStageChanged(Creature *creature, StatType stat, int oldStage, int newStage)
+    {
+        Q_UNUSED(creature); Q_UNUSED(stat); Q_UNUSED(oldStage); Q_UNUSED(newStage);
+    }
+    virtual void onCreatureSwitched(Creature *oldCreature, Creature *newCreature, bool isPlayer)
+    {
+        Q_UNUSED(oldCreature); Q_UNUSED(newCreature); Q_UNUSED(isPlayer);
+    }
+    // 日志接收者记录了一条事件（空接收者时不会调用）
+    virtual void onBattleEvent(const BattleEvent &event) { Q_UNUSED(event); }
+    // 一个回合结算完毕（在onTurnEnded/onBattleEnded的最终通知之前）；结算中的事件也已逐条通知过
+    virtual void onTurnChanges(const BattleTurnChanges &changes) { Q_UNUSED(changes); }
+};
+
+#endif // BATTLEOBSERVER_H
@@ -0,0 +1,94 @@
+// src/battle/battlerandom.h
+#ifndef BATTLERANDOM_H
+#define BATTLERANDOM_H
+
+#include <QtGlobal>
+
+// 战斗随机数流
+// 每个BattleSystem持有一个独立实例，所有战斗内随机判定（暴击、伤害浮动、命中、效果几率、
+// 多段次数、睡眠苏醒、逃跑）都从这里取数；AI选招使用由同一种子派生的另一条流，
+// 因此AI的决策方式不影响战斗本身的随机序列，回放时可以直接提交录下的AI行动：
+//   1. 并行模拟时各场战斗互不争用全局生成器；
+//   2. 记录种子即可逐位复现整场战斗。
+// 算法为 xoshiro256**，种子经 splitmix64 扩展为256位内部状态。
+class BattleRandom
+{
+public:
+    explicit BattleRandom(quint64 seed = 0) { this->seed(seed); }
+
+    // 重新设定种子，内部状态完全由种子决定
+    void seed(quint64 seed)
+    {
+        m_seed = seed;
+        quint64 x = seed;
+        for (quint64 &word : m_state) {
+            word = splitMix64(x);
+        }
+    }
+
+    quint64 getSeed() const { return m_seed; }
+
+    // 读取/恢复内部状态，供 BattleState 快照使用
+    void getState(quint64 state[4]) const
+    {
+        for (int i = 0; i < 4; ++i) state[i] = m_state[i];
+    }
+    void setState(const quint64 state[4])
+    {
+        for (int i = 0; i < 4; ++i) m_state[i] = state[i];
+    }
+
+    // 生成下一个64位随机数
+    quint64 next()
+    {
+        const quint64 result = rotl(m_state[1] * 5, 7) * 9;
+        const quint64 t = m_state[1] << 17;
+
+        m_state[2] ^= m_state[0];
+        m_state[3] ^= m_state[1];
+        m_state[1] ^= m_state[2];
+        m_state[0] ^= m_state[3];
+        m_state[2] ^= t;
+        m_state[3] = rotl(m_state[3], 45);
+
+        return result;
+    }
+
+    // 与 QRandomGenerator::bounded 语义一致：返回 [0, highest)
+    int bounded(int highest)
+    {
+        if (highest <= 1) return 0;
+        // 乘法取高位（Lemire），避免取模的除法开销；对战斗中<=100的范围偏差可忽略
+        const quint64 r = next() >> 32;
+        return int((r * quint64(highest)) >> 32);
+    }
+
+    // 与 QRandomGenerator::bounded 语义一致：返回 [lowest, highest)
+    int bounded(int lowest, int highest)
+    {
+        return lowest + bounded(highest - lowest);
+    }
+
+    // 没有战斗上下文时（如在战斗外直接调用精灵的回合逻辑）使用的线程局部随机流
+    static BattleRandom &threadFallback()
+    {
+        static thread_local BattleRandom fallback(0x5348414E48414931ULL);
+        return fallback;
+    }
+
+private:
+    static quint64 rotl(quint64 x, int k) { return (x << k) | (x >> (64 - k)); }
+
+    static quint64 splitMix64(quint64 &x)
+    {
+        quint64 z = (x += 0x9E3779B97F4A7C15ULL);
+        z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+        z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+        return z ^ (z >> 31);
+    }
+
+    quint64 m_seed;
+    quint64 m_state[4];
+};
+
+#endif // BATTLERANDOM_H
@@ -0,0 +1,511 @@
+// src/battle/battlereplay.cpp
+#include "battlereplay.h"
+#include "battlesystem.h"
+#include "battlevarint.h"
+#include "battleturnchanges.h"
+#include <QStringList>
+
+namespace {
+
+const char REPLAY_MAGIC[4] = {'S', 'H', 'R', 'P'};
+const quint8 REPLAY_FLAG_PVP = 0x01;
+const quint8 REPLAY_UNKNOWN_SPECIES = 0xFF;
+
+// 精灵描述的字段标记
+const quint8 CREATURE_CUSTOM_STATS = 0x01;
+const quint8 CREATURE_HP = 0x02;     // 初始HP不是满值
+const quint8 CREATURE_PP = 0x04;     // 初始PP不是满值
+const quint8 CREATURE_STATUS = 0x08; // 带着异常状态入场
+
+// 行动记录头字节
+const quint8 ACTION_SIDE = 0x80;
+const quint8 ACTION_PARAM2 = 0x40;
+const quint8 ACTION_PARAM1 = 0x20;
+const quint8 ACTION_TYPE_MASK = 0x07;
+
+const StatType STAT_ORDER[6] = {StatType::HP, StatType::ATTACK, StatType::SP_ATTACK,
+                                StatType::DEFENSE, StatType::SP_DEFENSE, StatType::SPEED};
+
+bool sameStats(const BaseStats &a, const BaseStats &b)
+{
+    for (StatType stat : STAT_ORDER)
+    {
+        if (a.getStat(stat) != b.getStat(stat)) return false;
+    }
+    return true;
+}
+
+bool sameTalent(const Talent &a, const Talent &b)
+{
+    for (StatType stat : STAT_ORDER)
+    {
+        if (a.getGrowthRate(stat) != b.getGrowthRate(stat)) return false;
+    }
+    return true;
+}
+
+ReplayCreature describeCreature(const Creature *creature)
+{
+    ReplayCreature desc;
+    desc.speciesKey = creature->getSpeciesKey();
+    desc.level = creature->getLevel();
+    desc.baseStats = creature->getBaseStats();
+    desc.talent = creature->getTalent();
+    desc.maxPP = creature->getMaxPP();
+    desc.currentHP = creature->getCurrentHP();
+    desc.currentPP = creature->getCurrentPP();
+    desc.statusCondition = static_cast<quint8>(creature->getStatusCondition());
+
+    // 与同等级的种类默认值相同时不必写出属性
+    Creature *reference = Creature::createSpecies(creature->getSpeciesId(), desc.level);
+    desc.customStats = !reference || !sameStats(reference->getBaseStats(), desc.baseStats) ||
+                       !sameTalent(reference->getTalent(), desc.talent) || reference->getMaxPP() != desc.maxPP;
+    delete reference;
+    return desc;
+}
+
+void writeCreature(QByteArray &data, const ReplayCreature &creature, const Creature *reference)
+{
+    // 种类下标即SpeciesId的数值；只有内置种类的编号固定，数据目录追加的种类按键名写入
+    const int speciesIndex = static_cast<int>(Creature::findSpecies(creature.speciesKey));
+    if (speciesIndex < SPECIES_COUNT && speciesIndex < REPLAY_UNKNOWN_SPECIES)
+    {
+        data.append(static_cast<char>(speciesIndex));
+    }
+    else
+    {
+        const QByteArray key = creature.speciesKey.toUtf8();
+        data.append(static_cast<char>(REPLAY_UNKNOWN_SPECIES));
+        writeVarint(data, key.size());
+        data.append(key);
+    }
+    data.append(static_cast<char>(creature.level));
+
+    const int maxHP = reference ? reference->getMaxHP() : -1;
+    const int maxPP = creature.maxPP;
+    quint8 fields = 0;
+    if (creature.customStats) fields |= CREATURE_CUSTOM_STATS;
+    if (creature.customStats || creature.currentHP != maxHP) fields |= CREATURE_HP;
+    if (creature.currentPP != maxPP) fields |= CREATURE_PP;
+    if (creature.statusCondition != 0) fields |= CREATURE_STATUS;
+    data.append(static_cast<char>(fields));
+
+    if (fields & CREATURE_CUSTOM_STATS)
+    {
+        for (StatType stat : STAT_ORDER) writeVarint(data, creature.baseStats.getStat(stat));
+        for (StatType stat : STAT_ORDER) writeVarint(data, creature.talent.getGrowthRate(stat));
+        writeVarint(data, creature.maxPP);
+    }
+    if (fields & CREATURE_HP) writeVarint(data, creature.currentHP);
+    if (fields & CREATURE_PP) writeVarint(data, creature.currentPP);
+    if (fields & CREATURE_STATUS) data.append(static_cast<char>(creature.statusCondition));
+}
+
+bool readByte(const QByteArray &data, int &pos, quint8 &value)
+{
+    if (pos >= data.size()) return false;
+    value = static_cast<quint8>(data[pos++]);
+    return true;
+}
+
+bool readCreature(const QByteArray &data, int &pos, ReplayCreature &creature)
+{
+    quint8 speciesIndex = 0;
+    if (!readByte(data, pos, speciesIndex)) return false;
+    if (speciesIndex == REPLAY_UNKNOWN_SPECIES)
+    {
+        qint32 length = 0;
+        if (!readVarint(data, pos, length) || length < 0 || length > data.size() - pos) return false;
+        creature.speciesKey = QString::fromUtf8(data.mid(pos, length));
+        pos += length;
+    }
+    else
+    {
+        if (speciesIndex >= SPECIES_COUNT) return false;
+        creature.speciesKey = Creature::getSpeciesKeyById(static_cast<SpeciesId>(speciesIndex));
+    }
+
+    quint8 level = 0;
+    quint8 fields = 0;
+    if (!readByte(data, pos, level) || !readByte(data, pos, fields)) return false;
+    if (level < 1 || level > MAX_LEVEL) return false;
+    creature.level = level;
+
+    // 未写出的字段取种类默认值
+    Creature *reference = Creature::createSpecies(creature.speciesKey, creature.level);
+    if (reference)
+    {
+        creature.baseStats = reference->getBaseStats();
+        creature.talent = reference->getTalent();
+        creature.maxPP = reference->getMaxPP();
+        creature.currentHP = reference->getMaxHP();
+        creature.currentPP = reference->getMaxPP();
+        delete reference;
+    }
+    else if (!(fields & CREATURE_CUSTOM_STATS))
+    {
+        return false;
+    }
+
+    qint32 value = 0;
+    creature.customStats = (fields & CREATURE_CUSTOM_STATS) != 0;
+    if (creature.customStats)
+    {
+        for (StatType stat : STAT_ORDER)
+        {
+            if (!readVarint(data, pos, value)) return false;
+            creature.baseStats.setStat(stat, value);
+        }
+        for (StatType stat : STAT_ORDER)
+        {
+            if (!readVarint(data, pos, value)) return false;
+            creature.talent.setGrowthRate(stat, value);
+        }
+        if (!readVarint(data, pos, value)) return false;
+        creature.maxPP = value;
+        creature.currentPP = value;
+    }
+    if (fields & CREATURE_HP)
+    {
+        if (!readVarint(data, pos, value)) return false;
+        creature.currentHP = value;
+    }
+    if (fields & CREATURE_PP)
+    {
+        if (!readVarint(data, pos, value)) return false;
+        creature.currentPP = value;
+    }
+    creature.statusCondition = 0;
+    if ((fields & CREATURE_STATUS) && !readByte(data, pos, creature.statusCondition)) return false;
+    return creature.statusCondition <= static_cast<quint8>(StatusCondition::CONFUSION);
+}
+
+Creature *buildCreature(const ReplayCreature &desc)
+{
+    Creature *creature = Creature::createSpecies(desc.speciesKey, desc.level);
+    if (!creature) return nullptr;
+    if (desc.customStats)
+    {
+        creature->setBaseStats(desc.baseStats);
+        creature->setTalent(desc.talent);
+        creature->setMaxPP(desc.maxPP);
+    }
+    CreatureState state;
+    creature->exportState(state);
+    state.currentHP = desc.currentHP;
+    state.currentPP = desc.currentPP;
+    state.statusCondition = desc.statusCondition;
+    creature->importState(state);
+    return creature;
+}
+
+bool setError(QString *error, const QString &message)
+{
+    if (error) *error = message;
+    return false;
+}
+
+} // namespace
+
+// --- BattleReplay ---
+
+QByteArray BattleReplay::serialize() const
+{
+    QByteArray data;
+    data.append(REPLAY_MAGIC, sizeof(REPLAY_MAGIC));
+    data.append(static_cast<char>(BATTLE_REPLAY_VERSION));
+    data.append(static_cast<char>(isPvP ? REPLAY_FLAG_PVP : 0));
+    for (int i = 0; i < 8; ++i) data.append(static_cast<char>((seed >> (8 * i)) & 0xFF));
+
+    for (const QVector<ReplayCreature> *team : {&playerTeam, &opponentTeam})
+    {
+        data.append(static_cast<char>(team->size()));
+        for (const ReplayCreature &creature : *team)
+        {
+            Creature *reference = creature.customStats ? nullptr : buildCreature(creature);
+            writeCreature(data, creature, reference);
+            delete reference;
+        }
+    }
+
+    writeVarint(data, static_cast<qint32>(actions.size()));
+    for (const ReplayAction &action : actions)
+    {
+        quint8 head = action.action & ACTION_TYPE_MASK;
+        if (action.side) head |= ACTION_SIDE;
+        if (action.param1 != -1) head |= ACTION_PARAM1;
+        if (action.param2 != -1) head |= ACTION_PARAM2;
+        data.append(static_cast<char>(head));
+        if (action.param1 != -1) data.append(static_cast<char>(action.param1));
+        if (action.param2 != -1) data.append(static_cast<char>(action.param2));
+    }
+
+    data.append(static_cast<char>(result));
+    writeVarint(data, turnCount);
+
+    writeVarint(data, static_cast<qint32>(turnHashes.size()));
+    for (quint64 hash : turnHashes)
+    {
+        for (int i = 0; i < 8; ++i) data.append(static_cast<char>((hash >> (8 * i)) & 0xFF));
+    }
+    return data;
+}
+
+bool BattleReplay::deserialize(const QByteArray &data, BattleReplay &replay, QString *error)
+{
+    replay = BattleReplay();
+    if (data.size() < 14 || !data.startsWith(QByteArray(REPLAY_MAGIC, sizeof(REPLAY_MAGIC))))
+    {
+        return setError(error, "不是回放文件");
+    }
+    int pos = sizeof(REPLAY_MAGIC);
+    const quint8 version = static_cast<quint8>(data[pos++]);
+    if (version < 1 || version > BATTLE_REPLAY_VERSION)
+    {
+        return setError(error, QString("不支持的回放版本: %1").arg(version));
+    }
+    replay.isPvP = (static_cast<quint8>(data[pos++]) & REPLAY_FLAG_PVP) != 0;
+    for (int i = 0; i < 8; ++i) replay.seed |= static_cast<quint64>(static_cast<quint8>(data[pos++])) << (8 * i);
+
+    for (QVector<ReplayCreature> *team : {&replay.playerTeam, &replay.opponentTeam})
+    {
+        quint8 count = 0;
+        if (!readByte(data, pos, count)) return setError(error, "回放数据不完整");
+        for (int i = 0; i < count; ++i)
+        {
+            ReplayCreature creature;
+            if (!readCreature(data, pos, creature)) return setError(error, "精灵描述无效");
+            team->append(creature);
+        }
+    }
+
+    qint32 actionCount = 0;
+    // 每个行动至少占一个字节，先按剩余长度检查，避免损坏文件中的计数触发巨量分配
+    if (!readVarint(data, pos, actionCount) || actionCount < 0 || actionCount > data.size() - pos)
+        return setError(error, "回放数据不完整");
+    replay.actions.reserve(actionCount);
+    for (int i = 0; i < actionCount; ++i)
+    {
+        quint8 head = 0;
+        if (!readByte(data, pos, head)) return setError(error, "回放数据不完整");
+        ReplayAction action;
+        action.side = (head & ACTION_SIDE) ? 1 : 0;
+        action.action = head & ACTION_TYPE_MASK;
+        action.param1 = -1;
+        action.param2 = -1;
+        quint8 param = 0;
+        if (head & ACTION_PARAM1)
+        {
+            if (!readByte(data, pos, param)) return setError(error, "回放数据不完整");
+            action.param1 = static_cast<qint8>(param);
+        }
+        if (head & ACTION_PARAM2)
+        {
+            if (!readByte(data, pos, param)) return setError(error, "回放数据不完整");
+            action.param2 = static_cast<qint8>(param);
+        }
+        replay.actions.push_back(action);
+    }
+
+    qint32 turnCount = 0;
+    if (!readByte(data, pos, replay.result) || !readVarint(data, pos, turnCount)) return setError(error, "回放数据不完整");
+    replay.turnCount = turnCount;
+
+    if (version >= 2)
+    {
+        qint32 hashCount = 0;
+        // 用除法比较，避免8 * hashCount在int中溢出
+        if (!readVarint(data, pos, hashCount) || hashCount < 0 || hashCount > (data.size() - pos) / 8)
+        {
+            return setError(error, "回放数据不完整");
+        }
+        replay.turnHashes.resize(hashCount);
+        for (quint64 &hash : replay.turnHashes)
+        {
+            for (int i = 0; i < 8; ++i) hash |= static_cast<quint64>(static_cast<quint8>(data[pos++])) << (8 * i);
+        }
+    }
+    return true;
+}
+
+// --- BattleReplayRecorder ---
+
+BattleReplayRecorder::BattleReplayRecorder(BattleSystem *battle)
+    : m_battle(battle),
+      m_recording(false)
+{
+    if (m_battle) m_battle->addObserver(this);
+}
+
+BattleReplayRecorder::~BattleReplayRecorder()
+{
+    if (m_battle) m_battle->removeObserver(this);
+}
+
+void BattleReplayRecorder::onBattleStarted()
+{
+    m_replay = BattleReplay();
+    // 回放按种类重建精灵；没有种类的通用精灵（如旧存档载入的）无法重建，这样的战斗不录制
+    const QVector<Creature *> playerTeam = m_battle->getPlayerTeam();
+    const QVector<Creature *> opponentTeam = m_battle->getOpponentTeam();
+    m_recording = true;
+    for (const QVector<Creature *> *team : {&playerTeam, &opponentTeam})
+    {
+        for (Creature *creature : *team)
+        {
+            if (creature && creature->getSpeciesId() == SpeciesId::NONE) m_recording = false;
+        }
+    }
+    if (!m_recording) return;
+
+    m_replay.seed = m_battle->getRandomSeed();
+    m_replay.isPvP = m_battle->isPvPBattle();
+    for (Creature *creature : playerTeam)
+    {
+        if (creature) m_replay.playerTeam.append(describeCreature(creature));
+    }
+    for (Creature *creature : opponentTeam)
+    {
+        if (creature) m_replay.opponentTeam.append(describeCreature(creature));
+    }
+    m_replay.actions.reserve(64);
+}
+
+void BattleReplayRecorder::onBattleEnded(BattleResult result)
+{
+    if (!m_recording) return;
+    m_replay.result = static_cast<quint8>(result);
+    m_replay.turnCount = m_battle->getCurrentTurn();
+}
+
+void BattleReplayRecorder::onTurnStarted(int turn)
+{
+    if (!m_recording) return;
+    m_replay.turnCount = turn;
+}
+
+void BattleReplayRecorder::onActionSubmitted(bool isPlayer, BattleAction action, int param1, int param2)
+{
+    if (!m_recording) return;
+    m_replay.actions.push_back(ReplayAction{static_cast<quint8>(isPlayer ? 0 : 1), static_cast<quint8>(action),
+                                            static_cast<qint8>(param1), static_cast<qint8>(param2)});
+}
+
+void BattleReplayRecorder::onTurnChanges(const BattleTurnChanges &changes)
+{
+    Q_UNUSED(changes);
+    if (!m_recording) return;
+    // 状态哈希关闭时战斗系统不记录，录像中也就没有
+    const std::vector<quint64> &hashes = m_battle->getTurnHashes();
+    if (hashes.size() > m_replay.turnHashes.size()) m_replay.turnHashes.push_back(hashes.back());
+}
+
+// --- BattleReplayer ---
+
+BattleReplayer::BattleReplayer(const BattleReplay &replay)
+    : m_replay(replay),
+      m_battle(nullptr),
+      m_nextAction(0),
+      m_checkedHashes(0),
+      m_divergentTurn(0)
+{
+}
+
+BattleReplayer::~BattleReplayer()
+{
+    releaseTeams();
+}
+
+void BattleReplayer::releaseTeams()
+{
+    qDeleteAll(m_playerTeam);
+    qDeleteAll(m_opponentTeam);
+    m_playerTeam.clear();
+    m_opponentTeam.clear();
+}
+
+bool BattleReplayer::start(BattleSystem &battle, QString *error)
+{
+    releaseTeams();
+    m_battle = nullptr;
+    m_nextAction = 0;
+    m_checkedHashes = 0;
+    m_divergentTurn = 0;
+    for (int side = 0; side < 2; ++side)
+    {
+        const QVector<ReplayCreature> &descs = (side == 0) ? m_replay.playerTeam : m_replay.opponentTeam;
+        QVector<Creature *> &team = (side == 0) ? m_playerTeam : m_opponentTeam;
+        for (const ReplayCreature &desc : descs)
+        {
+            Creature *creature = buildCreature(desc);
+            if (!creature)
+            {
+                releaseTeams();
+                return setError(error, QString("未知的精灵种类: %1").arg(desc.speciesKey));
+            }
+            team.append(creature);
+        }
+    }
+
+    m_battle = &battle;
+    battle.setTurnResolutionMode(TurnResolutionMode::EXTERNAL);
+    battle.setRandomSeed(m_replay.seed);
+    battle.initBattle(m_playerTeam, m_opponentTeam, m_replay.isPvP);
+    return true;
+}
+
+bool BattleReplayer::isFinished() const
+{
+    return !m_battle || m_divergentTurn > 0 || m_battle->getBattleResult() != BattleResult::ONGOING ||
+           m_nextAction >= static_cast<int>(m_replay.actions.size());
+}
+
+bool BattleReplayer::step()
+{
+    if (isFinished()) return false;
+    const int turn = m_battle->getCurrentTurn();
+    while (!isFinished() && m_battle->getCurrentTurn() == turn)
+    {
+        const ReplayAction &action = m_replay.actions[m_nextAction++];
+        if (action.side == 0)
+        {
+            m_battle->playerSubmittedAction(static_cast<BattleAction>(action.action), action.param1, action.param2);
+        }
+        else
+        {
+            m_battle->opponentSubmittedAction(static_cast<BattleAction>(action.action), action.param1, action.param2);
+        }
+        checkTurnHashes();
+    }
+    return !isFinished();
+}
+
+void BattleReplayer::checkTurnHashes()
+{
+    const std::vector<quint64> &hashes = m_battle->getTurnHashes();
+    const int count = static_cast<int>(qMin(hashes.size(), m_replay.turnHashes.size()));
+    for (; m_checkedHashes < count; ++m_checkedHashes)
+    {
+        if (hashes[m_checkedHashes] != m_replay.turnHashes[m_checkedHashes])
+        {
+            m_divergentTurn = m_checkedHashes + 1;
+            return;
+        }
+    }
+}
+
+void BattleReplayer::run()
+{
+    while (step())
+    {
+    }
+}
+
+bool BattleReplayer::matchesRecording() const
+{
+    if (!m_battle || m_divergentTurn > 0) return false;
+    // 旧版本回放没有哈希，只比较结果与回合数
+    if (!m_replay.turnHashes.empty() && m_battle->getTurnHashes() != m_replay.turnHashes) return false;
+    return static_cast<quint8>(m_battle->getBattleResult()) == m_replay.result &&
+           m_battle->getCurrentTurn() == m_replay.turnCount;
+}
@@ -0,0 +1,128 @@
+// src/battle/battlereplay.h
+#ifndef BATTLEREPLAY_H
+#define BATTLEREPLAY_H
+
+#include <QByteArray>
+#include <QString>
+#include <QVector>
+#include <vector>
+#include "../core/ability.h"
+#include "battleobserver.h"
+
+class BattleSystem;
+
+// 战斗回放
+// 一场战斗完全由随机种子、双方初始队伍和双方依次提交的行动决定（AI选招使用独立的随机流，
+// 不影响战斗随机序列），因此回放只需记录这三部分，重新提交行动即可逐位复现整场战斗。
+//
+// 二进制格式（小端）：
+//   "SHRP" 版本(1) 标记(1) 种子(8)
+//   玩家队伍数(1) 精灵描述... 对手队伍数(1) 精灵描述...
+//   行动数(varint) 行动记录...
+//   录制结束时的结果(1) 回合数(varint)
+//   回合哈希数(varint) 每回合结算后的状态哈希(8)...（版本2起）
+// 精灵描述：种类下标(1，0xFF后跟长度与UTF-8键名) 等级(1) 字段标记(1) [可选字段，varint]
+// 行动记录：头字节 = 阵营(bit7) | 有param2(bit6) | 有param1(bit5) | BattleAction(bit0-2)，
+//           之后按需各一个有符号字节；参数为-1时省略
+
+const quint8 BATTLE_REPLAY_VERSION = 2;
+
+// 初始队伍中的一只精灵
+struct ReplayCreature
+{
+    QString speciesKey;
+    int level = 1;
+    bool customStats = false; // 基础属性/天赋/PP上限与同等级的种类默认值不同
+    BaseStats baseStats;
+    Talent talent;
+    int maxPP = 0;
+    int currentHP = 0;
+    int currentPP = 0;
+    quint8 statusCondition = 0; // StatusCondition
+};
+
+// 一方提交的一个行动
+struct ReplayAction
+{
+    quint8 side;   // 0玩家 1对手
+    quint8 action; // BattleAction
+    qint8 param1;
+    qint8 param2;
+};
+
+struct BattleReplay
+{
+    quint64 seed = 0;
+    bool isPvP = false;
+    QVector<ReplayCreature> playerTeam;
+    QVector<ReplayCreature> opponentTeam;
+    std::vector<ReplayAction> actions;
+    quint8 result = 0;  // 录制结束时的BattleResult（ONGOING表示录制时战斗未结束）
+    int turnCount = 0;  // 录制结束时的回合数
+    std::vector<quint64> turnHashes; // 下标i为第i+1回合结算后的BattleSystem::computeStateHash
+
+    QByteArray serialize() const;
+    // 数据不完整或版本不支持时返回false；版本1的回放没有回合哈希
+    static bool deserialize(const QByteArray &data, BattleReplay &replay, QString *error = nullptr);
+};
+
+// 录制器：注册为战斗观察者，每次initBattle开始一份新的回放
+class BattleReplayRecorder : public BattleObserver
+{
+public:
+    explicit BattleReplayRecorder(BattleSystem *battle);
+    ~BattleReplayRecorder();
+
+    // 当前（或最近一场）战斗的回放；队伍中有无法按种类重建的精灵时不录制，回放为空（队伍为空）
+    const BattleReplay &getReplay() const { return m_replay; }
+    bool isRecording() const { return m_recording; }
+
+    void onBattleStarted() override;
+    void onBattleEnded(BattleResult result) override;
+    void onTurnStarted(int turn) override;
+    void onActionSubmitted(bool isPlayer, BattleAction action, int param1, int param2) override;
+    void onTurnChanges(const BattleTurnChanges &changes) override;
+
+private:
+    BattleSystem *m_battle;
+    BattleReplay m_replay;
+    bool m_recording; // 当前战斗是否可录制
+};
+
+// 回放器：重建初始队伍并依次提交录下的行动
+// 战斗切换到EXTERNAL模式，AI不会自行决策；精灵由回放器持有，回放器销毁后battle不能再访问这些精灵。
+class BattleReplayer
+{
+public:
+    explicit BattleReplayer(const BattleReplay &replay);
+    ~BattleReplayer();
+
+    // 重建队伍、设定种子并开始战斗；队伍无法重建时返回false
+    bool start(BattleSystem &battle, QString *error = nullptr);
+    // 单步：提交行动直到完成一个回合（或行动用完、战斗结束），返回之后是否还能继续
+    // 某回合的状态哈希与录制不一致时停在该回合
+    bool step();
+    // 全速回放到结束（或第一个分歧回合）
+    void run();
+    bool isFinished() const;
+    // 回放结束后，结果、回合数与逐回合哈希是否与录制时一致
+    bool matchesRecording() const;
+    // 第一个状态哈希与录制不一致的回合，没有分歧时为0
+    int getFirstDivergentTurn() const { return m_divergentTurn; }
+    const BattleReplay &getReplay() const { return m_replay; }
+    int getNextActionIndex() const { return m_nextAction; }
+
+private:
+    void releaseTeams();
+    void checkTurnHashes();
+
+    BattleReplay m_replay;
+    BattleSystem *m_battle;
+    QVector<Creature *> m_playerTeam;
+    QVector<Creature *> m_opponentTeam;
+    int m_nextAction;
+    int m_checkedHashes; // 已与录制比较过的回合哈希数
+    int m_divergentTurn;
+};
+
+#endif // BATTLEREPLAY_H
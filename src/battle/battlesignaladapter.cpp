@@ -0,0 +1,47 @@
+// src/battle/battlesignaladapter.cpp
+#include "battlesignaladapter.h"
+
+BattleSignalAdapter::BattleSignalAdapter(BattleSystem *battle, QObject *parent)
+    : QObject(parent),
+      m_battle(battle)
+{
+    if (m_battle) m_battle->addObserver(this);
+}
+
+BattleSignalAdapter::~BattleSignalAdapter()
+{
+    if (m_battle) m_battle->removeObserver(this); // 战斗系统可能先于适配器销毁
+}
+
+void BattleSignalAdapter::onBattleStarted() { emit battleStarted(); }
+void BattleSignalAdapter::onBattleEnded(BattleResult result) { emit battleEnded(result); }
+void BattleSignalAdapter::onTurnStarted(int turn) { emit turnStarted(turn, true); } // 每回合总是玩家先输入
+void BattleSignalAdapter::onTurnEnded(int turn) { emit turnEnded(turn); }
+void BattleSignalAdapter::onPlayerActionConfirmed() { emit playerActionConfirmed(); }
+void BattleSignalAdapter::onOpponentActionConfirmed() { emit opponentActionConfirmed(); }
+
+void BattleSignalAdapter::onSkillUsed(Creature *user, Creature *target, Skill *skill, bool hit, int damage)
+{
+    emit skillUsed(user, target, skill, hit, damage);
+}
+
+void BattleSignalAdapter::onDamageCaused(Creature *creature, int damage) { emit damageCaused(creature, damage); }
+void BattleSignalAdapter::onHealingReceived(Creature *creature, int amount) { emit healingReceived(creature, amount); }
+
+void BattleSignalAdapter::onStatusChanged(Creature *creature, StatusCondition oldStatus, StatusCondition newStatus)
+{
+    emit statusChanged(creature, oldStatus, newStatus);
+}
+
+void BattleSignalAdapter::onStatStageChanged(Creature *creature, StatType stat, int oldStage, int newStage)
+{
+    emit statStageChanged(creature, stat, oldStage, newStage);
+}
+
+void BattleSignalAdapter::onCreatureSwitched(Creature *oldCreature, Creature *newCreature, bool isPlayer)
+{
+    emit creatureSwitched(oldCreature, newCreature, isPlayer);
+}
+
+void BattleSignalAdapter::onBattleEvent(const BattleEvent &event) { emit battleEventAdded(event); }
+void BattleSignalAdapter::onTurnChanges(const BattleTurnChanges &changes) { emit turnChangesReady(changes); }
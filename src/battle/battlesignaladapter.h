@@ -0,0 +1,54 @@
+// src/battle/battlesignaladapter.h
+#ifndef BATTLESIGNALADAPTER_H
+#define BATTLESIGNALADAPTER_H
+
+#include <QObject>
+#include <QPointer>
+#include "battlesystem.h"
+
+// 把BattleObserver回调转发为Qt信号，供界面（BattleScene）用connect连接
+// 构造时注册为battle的观察者，析构时注销；只有创建了适配器的战斗才需要付出信号分发的开销。
+class BattleSignalAdapter : public QObject, public BattleObserver
+{
+    Q_OBJECT
+
+public:
+    explicit BattleSignalAdapter(BattleSystem *battle, QObject *parent = nullptr);
+    ~BattleSignalAdapter();
+
+    void onBattleStarted() override;
+    void onBattleEnded(BattleResult result) override;
+    void onTurnStarted(int turn) override;
+    void onTurnEnded(int turn) override;
+    void onPlayerActionConfirmed() override;
+    void onOpponentActionConfirmed() override;
+    void onSkillUsed(Creature *user, Creature *target, Skill *skill, bool hit, int damage) override;
+    void onDamageCaused(Creature *creature, int damage) override;
+    void onHealingReceived(Creature *creature, int amount) override;
+    void onStatusChanged(Creature *creature, StatusCondition oldStatus, StatusCondition newStatus) override;
+    void onStatStageChanged(Creature *creature, StatType stat, int oldStage, int newStage) override;
+    void onCreatureSwitched(Creature *oldCreature, Creature *newCreature, bool isPlayer) override;
+    void onBattleEvent(const BattleEvent &event) override;
+    void onTurnChanges(const BattleTurnChanges &changes) override;
+
+signals:
+    void battleStarted();
+    void battleEnded(BattleResult result);
+    void turnStarted(int turn, bool isPlayerTurn);
+    void turnEnded(int turn); // 表示一个完整回合（双方行动后）的结束
+    void skillUsed(Creature *user, Creature *target, Skill *skill, bool hit, int damage);
+    void damageCaused(Creature *creature, int damage);
+    void healingReceived(Creature *creature, int amount);
+    void statusChanged(Creature *creature, StatusCondition oldStatus, StatusCondition newStatus);
+    void statStageChanged(Creature *creature, StatType stat, int oldStage, int newStage);
+    void creatureSwitched(Creature *oldCreature, Creature *newCreature, bool isPlayer);
+    void battleEventAdded(const BattleEvent &event); // 记录了一条战斗事件，由接收方按需格式化
+    void turnChangesReady(const BattleTurnChanges &changes); // 一个回合的结算变化集（直连时引用在槽函数返回前有效）
+    void playerActionConfirmed();   // 玩家已提交本回合行动
+    void opponentActionConfirmed(); // 对手/AI已提交本回合行动
+
+private:
+    QPointer<BattleSystem> m_battle;
+};
+
+#endif // BATTLESIGNALADAPTER_H
@@ -0,0 +1,90 @@
+// src/battle/battlestate.h
+#ifndef BATTLESTATE_H
+#define BATTLESTATE_H
+
+#include <QtGlobal>
+#include <type_traits>
+
+// 扁平化的战斗状态快照
+// 所有字段都是定长的整数数组，可以直接按值拷贝（memcpy），用于AI搜索展开、悔棋/回溯等
+// 需要大量复制整场战斗的场景。精灵、技能、效果都不保存指针：
+//   - 精灵用 (阵营, 队伍下标) 表示；
+//   - 技能本身在战斗中无可变状态，行动里只记录技能槽下标（-1 为第五技能）；
+//   - 回合效果本身就是带种类标记的定长记录（TurnEffectSlot），精灵身上与快照中是同一种结构。
+// 快照可以导入任何队伍构成相同的 BattleSystem（如AI搜索线程中的镜像战斗）。
+
+const int BATTLE_STATE_MAX_TEAM_SIZE = 6;     // 与队伍上限一致（最多6只）
+const int BATTLE_STATE_MAX_EFFECT_SLOTS = 4;  // 每只精灵可同时保存的回合效果数
+const int BATTLE_STATE_STAT_STAGE_COUNT = 7;  // 物攻/特攻/物防/特防/速度/命中/闪避
+const int BATTLE_STATE_SPECIES_WORDS = 2;     // 精灵种类私有状态（如狂暴形态剩余回合）
+const int BATTLE_STATE_MAX_PENDING_ACTIONS = 2; // 本回合已提交但尚未结算的行动
+
+// 回合效果种类，每回合的行为由 executeTurnEffect 按种类分派
+enum class TurnEffectKind : quint8
+{
+    NONE = 0,
+    SPEED_DOWN,  // 空域压制：每回合速度-1
+    LIFE_SIPHON, // 生命汲取领域：伤害对方非草系精灵并回复自身
+    LEECH_SEED,  // 寄生种子：吸取HP回复给施加者
+    IMMUNITY,    // 免疫标记（ImmunityEffect）
+    TIME_HOP     // 时光跳跃免疫标记
+};
+
+const quint8 TURN_EFFECT_ON_TURN_START = 0x01;    // 在回合开始时结算（否则在回合结束时）
+const quint8 TURN_EFFECT_IMMUNE_TO_STATUS = 0x02; // 免疫标记：免疫异常状态
+
+// 一条回合效果
+struct TurnEffectSlot
+{
+    TurnEffectKind kind;
+    quint8 flags;       // TURN_EFFECT_*
+    qint16 duration;    // 剩余回合数
+    qint8 sourceSide;   // 施加者阵营：0玩家 1对手 -1无
+    qint8 sourceIndex;  // 施加者在队伍中的下标
+    qint16 param;       // 种类相关参数（免疫标记：免疫伤害的ElementType）
+};
+
+// 单只精灵的战斗状态
+struct CreatureState
+{
+    qint32 currentHP;
+    qint32 currentPP;
+    qint8 statStages[BATTLE_STATE_STAT_STAGE_COUNT]; // 按 StatType::ATTACK..EVASION 顺序
+    quint8 statusCondition;                          // StatusCondition
+    quint8 effectCount;                              // 有效的效果槽数量
+    qint32 speciesState[BATTLE_STATE_SPECIES_WORDS];
+    TurnEffectSlot effects[BATTLE_STATE_MAX_EFFECT_SLOTS];
+};
+
+// 已提交、等待结算的行动
+struct PendingActionState
+{
+    qint8 side;       // 0玩家 1对手
+    qint8 actorIndex; // 行动者在队伍中的下标
+    quint8 action;    // BattleAction
+    qint16 param1;
+    qint16 param2;
+    qint16 priority;
+};
+
+// 整场战斗的状态
+struct BattleState
+{
+    CreatureState playerTeam[BATTLE_STATE_MAX_TEAM_SIZE];
+    CreatureState opponentTeam[BATTLE_STATE_MAX_TEAM_SIZE];
+    quint64 randomState[4]; // 战斗随机数流的内部状态
+    qint32 currentTurn;
+    quint8 playerTeamSize;
+    quint8 opponentTeamSize;
+    qint8 playerActiveIndex;
+    qint8 opponentActiveIndex;
+    quint8 battleResult; // BattleResult
+    quint8 playerActionSubmitted;
+    quint8 opponentActionSubmitted;
+    quint8 pendingActionCount;
+    PendingActionState pendingActions[BATTLE_STATE_MAX_PENDING_ACTIONS];
+};
+
+static_assert(std::is_trivially_copyable<BattleState>::value, "BattleState必须可以按位拷贝");
+
+#endif // BATTLESTATE_H
@@ -1,28 +1,66 @@
 #include "battlesystem.h"
 #include "specialskills.h"
+#include "aisearch.h"
 #include <algorithm>
+#include <cstring>
 #include <QRandomGenerator>
 
+// AI选招随机流的种子由战斗种子异或此值派生
+const quint64 AI_RANDOM_SALT = 0x41495F43484F4943ULL;
+// 预留的回合哈希数，开战后只有超过这个回合数才会扩容
+const int TURN_HASH_RESERVE = 256;
+// 单回合变化集中预留的事件数
+const int TURN_CHANGE_EVENT_RESERVE = 64;
+
+namespace {
+
+// 状态哈希的混合步骤：乘法 + 移位异或，足以让单个字段的任何变化扩散到全部64位
+inline quint64 mixStateHash(quint64 hash, quint64 value)
+{
+    hash ^= value + 0x9E3779B97F4A7C15ULL;
+    hash *= 0xBF58476D1CE4E5B9ULL;
+    return hash ^ (hash >> 31);
+}
+
+} // namespace
+
 // 构造函数
 BattleSystem::BattleSystem(QObject *parent)
     : QObject(parent),
       m_battleResult(BattleResult::ONGOING),
       m_currentTurn(0),
       m_isPvP(false),
+      m_turnResolutionMode(TurnResolutionMode::INTERACTIVE),
+      m_random(QRandomGenerator::global()->generate64()), // 默认随机种子，需要复现时由外部调用setRandomSeed
+      m_aiRandom(m_random.getSeed() ^ AI_RANDOM_SALT),
+      m_battleGeneration(0),
       m_playerActiveIndex(0),
       m_opponentActiveIndex(0),
+      m_chanceForced{false, false},
+      m_logSink(&m_fullLog),
+      m_collectingTurnChanges(false),
+      m_stateHashEnabled(true),
       m_playerActionSubmittedThisTurn(false), 
       m_opponentActionSubmittedThisTurn(false)  
 {
+    // 战斗中用到的容器在这里一次性预留容量，之后各场战斗只清空不释放，
+    // 开战后的回合结算不再进行堆分配
+    m_actionQueue.reserve(BATTLE_STATE_MAX_PENDING_ACTIONS);
+    m_turnHashes.reserve(TURN_HASH_RESERVE);
+    m_turnChanges.events.reserve(TURN_CHANGE_EVENT_RESERVE);
+    m_turnChanges.creatures.reserve(2 * BATTLE_STATE_MAX_TEAM_SIZE);
 }
 
 BattleSystem::~BattleSystem()
 {
     // 注意：不要在这里删除精灵对象，因为它们可能在其他地方被使用
+    cancelAISearch(); // 等待搜索线程退出，之后不会再有结果投递到本对象
 }
 
 void BattleSystem::initBattle(QVector<Creature *> playerTeam, QVector<Creature *> opponentTeam, bool isPvP)
 {
+    cancelAISearch(); // 上一场战斗未完成的AI搜索作废
+    ++m_battleGeneration;
     m_battleResult = BattleResult::ONGOING;
     m_currentTurn = 0; // 在 processTurnInputPhase 中会自增到1
     m_isPvP = isPvP;
@@ -32,11 +70,16 @@ void BattleSystem::initBattle(QVector<Creature *> playerTeam, QVector<Creature *
     m_playerActiveIndex = 0;
     m_opponentActiveIndex = 0;
 
-    m_battleLog.clear();
+    // 内置接收者随新战斗清空，外部接收者由调用方管理
+    if (m_logSink && (m_logSink == &m_fullLog || m_logSink == m_levelSink.get())) m_logSink->reset();
     m_actionQueue.clear(); // 确保行动队列清空
+    m_turnHashes.clear();
+    m_history.clear();
+    clearForcedChanceOutcomes();
 
-    emit battleStarted();
-    addBattleLog("战斗开始!");
+    recordTurnSnapshot(); // 第0回合：开战时的状态
+    notifyObservers(&BattleObserver::onBattleStarted);
+    addBattleEvent(BattleEventKind::BATTLE_STARTED);
 
     processTurnInputPhase(); // 开始第一个回合的输入阶段
 }
@@ -53,6 +96,19 @@ int BattleSystem::getCurrentTurn() const
 
 bool BattleSystem::isPvPBattle() const { return m_isPvP; }
 
+void BattleSystem::setTurnResolutionMode(TurnResolutionMode mode) { m_turnResolutionMode = mode; }
+
+TurnResolutionMode BattleSystem::getTurnResolutionMode() const { return m_turnResolutionMode; }
+
+void BattleSystem::setRandomSeed(quint64 seed)
+{
+    m_random.seed(seed);
+    m_aiRandom.seed(seed ^ AI_RANDOM_SALT);
+}
+quint64 BattleSystem::getRandomSeed() const { return m_random.getSeed(); }
+BattleRandom &BattleSystem::getRandom() { return m_random; }
+BattleRandom &BattleSystem::getAIRandom() { return m_aiRandom; }
+
 Creature *BattleSystem::getPlayerActiveCreature() const
 {
     if (m_playerActiveIndex >= 0 && m_playerActiveIndex < m_playerTeam.size())
@@ -85,17 +141,19 @@ void BattleSystem::playerSubmittedAction(BattleAction action, int param1, int pa
     if (m_playerActionSubmittedThisTurn || m_battleResult != BattleResult::ONGOING) {
         return; // 玩家已行动或战斗已结束
     }
+    notifyObservers(&BattleObserver::onActionSubmitted, true, action, param1, param2);
 
     Creature* playerCreature = getPlayerActiveCreature();
-    if (!playerCreature || playerCreature->isDead() || !playerCreature->canAct()) {
-         if(playerCreature) addBattleLog(QString("%1 无法行动!").arg(playerCreature->getName()));
+    // 当前精灵濒死时仍允许提交换人，否则队伍无法换上后备精灵
+    bool isForcedSwitch = playerCreature && playerCreature->isDead() && action == BattleAction::SWITCH_CREATURE;
+    if (!isForcedSwitch && (!playerCreature || playerCreature->isDead() || !playerCreature->canAct())) {
+         if(playerCreature) addBattleEvent(BattleEventKind::CANNOT_ACT, playerCreature, nullptr, 0, static_cast<int>(BattleEventReason::BLOCKED));
         // 如果玩家精灵无法行动，其行动在效果上是“跳过”
         // UI层面应该阻止提交行动，但这里做一层保护
         m_playerActionSubmittedThisTurn = true; // 标记为已提交，以便回合能继续（如果AI行动）
-        emit playerActionConfirmed(); // 通知UI
-        if (!m_isPvP) {
-            // AI仍然可以行动
-            QTimer::singleShot(100, this, &BattleSystem::decideAIAction); 
+        notifyObservers(&BattleObserver::onPlayerActionConfirmed); // 通知UI
+        if (!m_isPvP && m_turnResolutionMode == TurnResolutionMode::SYNCHRONOUS) {
+            decideAIAction(); // AI仍然可以行动
         } else {
             tryProcessTurnActions(); // PvP模式下检查对方是否已行动
         }
@@ -105,84 +163,204 @@ void BattleSystem::playerSubmittedAction(BattleAction action, int param1, int pa
     queuePlayerAction(action, param1, param2); // 将玩家行动加入队列
     m_playerActionSubmittedThisTurn = true;    // 标记玩家已提交行动
     if (playerCreature) {
-        addBattleLog(QString("%1 选择了行动.").arg(playerCreature->getName()));
+        addBattleEvent(BattleEventKind::ACTION_SUBMITTED, playerCreature);
     }
-    emit playerActionConfirmed(); // 发出信号，UI可以据此更新（例如禁用按钮）
+    notifyObservers(&BattleObserver::onPlayerActionConfirmed); // 发出信号，UI可以据此更新（例如禁用按钮）
 
-    if (!m_isPvP) { // 如果是PVE模式
-        // AI在玩家提交行动后进行决策 (可以加一点延迟模拟思考)
-        QTimer::singleShot(500, this, &BattleSystem::decideAIAction); 
+    if (!m_isPvP && m_turnResolutionMode == TurnResolutionMode::SYNCHRONOUS) {
+        // 同步模式：AI立即决策，双方行动齐备后在本调用内完成回合结算
+        decideAIAction();
     } else {
-        // 如果是PVP模式，等待另一个玩家的行动 (通过类似 opponentSubmittedAction 的方法)
+        // 交互模式下AI的“思考”延迟由表现层负责，之后调用decideAIAction
+        // PVP模式则等待另一方通过 opponentSubmittedAction 提交
         tryProcessTurnActions(); // 检查是否双方都已行动
     }
 }
 
+// 对手提交行动（PvP或外部驱动）
+void BattleSystem::opponentSubmittedAction(BattleAction action, int param1, int param2) {
+    if (m_opponentActionSubmittedThisTurn || m_battleResult != BattleResult::ONGOING) {
+        return; // 对手已行动或战斗已结束
+    }
+    notifyObservers(&BattleObserver::onActionSubmitted, false, action, param1, param2);
+
+    Creature* opponentCreature = getOpponentActiveCreature();
+    bool isForcedSwitch = opponentCreature && opponentCreature->isDead() && action == BattleAction::SWITCH_CREATURE;
+    if (!isForcedSwitch && (!opponentCreature || opponentCreature->isDead() || !opponentCreature->canAct())) {
+        if (opponentCreature) addBattleEvent(BattleEventKind::CANNOT_ACT, opponentCreature, nullptr, 0, static_cast<int>(BattleEventReason::BLOCKED));
+    } else {
+        queueOpponentAction(action, param1, param2);
+        addBattleEvent(BattleEventKind::ACTION_SUBMITTED, opponentCreature);
+    }
+
+    m_opponentActionSubmittedThisTurn = true;
+    notifyObservers(&BattleObserver::onOpponentActionConfirmed);
+    tryProcessTurnActions();
+}
+
 // AI决定并提交行动
 void BattleSystem::decideAIAction() {
     if (m_opponentActionSubmittedThisTurn || m_battleResult != BattleResult::ONGOING) {
         return; // AI已行动或战斗已结束
     }
+    if (isAISearchRunning()) {
+        return; // 本回合的搜索已在进行，结果稍后提交
+    }
+    if (!m_aiConfig.isSearchEnabled()) {
+        decideRandomAIAction();
+        return;
+    }
+
+    // 搜索在调用线程上导出快照，之后的模拟都在各线程自己的镜像战斗中进行
+    std::shared_ptr<AISearch> search = AISearch::create(*this, m_aiConfig);
+    if (!search->isValid()) {
+        decideRandomAIAction(); // 无法镜像当前战斗（如精灵不是由模板创建），退回随机选招
+        return;
+    }
+
+    if (m_isPvP || m_turnResolutionMode == TurnResolutionMode::SYNCHRONOUS) {
+        submitAIMove(search->run());
+        return;
+    }
+
+    // 交互模式：在后台线程搜索，完成后回到本对象所在线程提交，界面不会卡顿
+    const int generation = m_battleGeneration;
+    const int turn = m_currentTurn;
+    m_aiSearch = search;
+    QThread *thread = QThread::create([this, search, generation, turn]() {
+        const BattleMove move = search->run();
+        QMetaObject::invokeMethod(this, [this, search, move, generation, turn]() {
+            if (m_aiSearch != search) {
+                return; // 已被取消，期间可能已开始新的搜索
+            }
+            m_aiSearch.reset();
+            if (generation != m_battleGeneration || turn != m_currentTurn ||
+                m_opponentActionSubmittedThisTurn || m_battleResult != BattleResult::ONGOING) {
+                return; // 战斗已重新开始或本回合已结算，结果作废
+            }
+            submitAIMove(move);
+        }, Qt::QueuedConnection);
+    });
+    connect(thread, &QThread::finished, thread, &QObject::deleteLater);
+    m_aiSearchThread = thread;
+    thread->start();
+}
+
+// 提交搜索得到的AI行动
+void BattleSystem::submitAIMove(const BattleMove &move) {
+    notifyObservers(&BattleObserver::onActionSubmitted, false, move.action, move.param, -1);
+    Creature *aiCreature = getOpponentActiveCreature();
+    bool forcedSwitch = aiCreature && aiCreature->isDead() && move.action == BattleAction::SWITCH_CREATURE;
+    if (!forcedSwitch && (!aiCreature || aiCreature->isDead() || !aiCreature->canAct())) {
+        if (aiCreature) addBattleEvent(BattleEventKind::CANNOT_ACT, aiCreature, nullptr, 0, static_cast<int>(BattleEventReason::SPECIAL_STATUS));
+    } else {
+        queueOpponentAction(move.action, move.param);
+        if (move.action == BattleAction::SWITCH_CREATURE) {
+            Creature *next = (move.param >= 0 && move.param < m_opponentTeam.size()) ? m_opponentTeam[move.param] : nullptr;
+            if (next) addBattleEvent(BattleEventKind::OPPONENT_SWITCH_PLANNED, aiCreature, next);
+        } else if (move.action == BattleAction::RESTORE_PP) {
+            addBattleEvent(BattleEventKind::OPPONENT_RESTORE_PP_PLANNED, aiCreature);
+        } else {
+            Skill *chosenSkill = (move.param == -1) ? aiCreature->getFifthSkill() : aiCreature->getSkill(move.param);
+            if (chosenSkill) addSkillEvent(BattleEventKind::OPPONENT_SKILL_PLANNED, aiCreature, move.param);
+        }
+    }
+
+    m_opponentActionSubmittedThisTurn = true;
+    notifyObservers(&BattleObserver::onOpponentActionConfirmed);
+    tryProcessTurnActions();
+}
+
+// 取消正在进行的异步搜索并等待线程结束
+void BattleSystem::cancelAISearch() {
+    if (m_aiSearch) m_aiSearch->requestStop();
+    if (m_aiSearchThread) m_aiSearchThread->wait();
+    m_aiSearch.reset();
+}
 
+bool BattleSystem::isAISearchRunning() const { return m_aiSearch != nullptr; }
+
+void BattleSystem::setOpponentAIConfig(const OpponentAIConfig &config) { m_aiConfig = config; }
+
+OpponentAIConfig BattleSystem::getOpponentAIConfig() const { return m_aiConfig; }
+
+OpponentAIConfig OpponentAIConfig::forDifficulty(int difficulty) {
+    OpponentAIConfig config;
+    if (difficulty <= 0) {
+        return config; // 随机选招
+    }
+    // 难度1单线程短时思考；更高难度使用全部核心并延长思考时间
+    config.timeBudgetMs = qMin(25 * difficulty * difficulty, 800);
+    config.threadCount = (difficulty == 1) ? 1 : 0;
+    config.maxRolloutTurns = 20 + 5 * difficulty;
+    return config;
+}
+
+// 随机选择一个可用技能（未启用搜索时的默认AI）
+void BattleSystem::decideRandomAIAction() {
     Creature *aiCreature = getOpponentActiveCreature();
     bool actionTakenByAI = false; // 标记AI是否成功选择了一个行动
+    BattleMove chosenMove{BattleAction::USE_SKILL, 0}; // 通知观察者的行动，未入队时即为跳过
 
     if (!aiCreature || aiCreature->isDead()) { // 如果AI当前精灵濒死
         // 尝试切换精灵
         for (int i = 0; i < m_opponentTeam.size(); ++i) {
             if (m_opponentTeam[i] && !m_opponentTeam[i]->isDead()) {
                 queueOpponentAction(BattleAction::SWITCH_CREATURE, i); // param1 是队伍中的索引
-                addBattleLog(QString("对手换上了 %1.").arg(m_opponentTeam[i]->getName()));
+                chosenMove = BattleMove{BattleAction::SWITCH_CREATURE, i};
+                addBattleEvent(BattleEventKind::OPPONENT_SWITCH_PLANNED, aiCreature, m_opponentTeam[i]);
                 actionTakenByAI = true;
                 break;
             }
         }
         if (!actionTakenByAI) {
-            addBattleLog("对手没有其他可战斗的精灵了!");
+            addBattleEvent(BattleEventKind::OPPONENT_NO_CREATURES);
         }
     } else if (!aiCreature->canAct()) { // 如果AI精灵因状态无法行动
-        addBattleLog(QString("%1 因特殊状态无法行动!").arg(aiCreature->getName()));
+        addBattleEvent(BattleEventKind::CANNOT_ACT, aiCreature, nullptr, 0, static_cast<int>(BattleEventReason::SPECIAL_STATUS));
         actionTakenByAI = true; // 视为“跳过”行动
     } else { // AI精灵可以行动，选择技能
-        QVector<int> usableSkillIndices;
+        int usableSkillIndices[MAX_SKILL_COUNT + 1]; // 每回合都会调用，用定长数组避免分配
+        int usableSkillCount = 0;
         // 检查普通技能
-        if (aiCreature->getSkillCount() > 0) {
-            for (int i = 0; i < aiCreature->getSkillCount(); ++i) {
-                Skill* s = aiCreature->getSkill(i);
-                if (s && aiCreature->getCurrentPP() >= s->getPPCost()) {
-                    usableSkillIndices.append(i);
-                }
+        for (int i = 0; i < aiCreature->getSkillCount() && i < MAX_SKILL_COUNT; ++i) {
+            Skill* s = aiCreature->getSkill(i);
+            if (s && aiCreature->getCurrentPP() >= s->getPPCost()) {
+                usableSkillIndices[usableSkillCount++] = i;
             }
         }
         // 检查第五技能
         Skill* fifthSkill = aiCreature->getFifthSkill();
         if (fifthSkill && aiCreature->getCurrentPP() >= fifthSkill->getPPCost()) {
-            usableSkillIndices.append(-1); // 用-1代表第五技能
+            usableSkillIndices[usableSkillCount++] = -1; // 用-1代表第五技能
         }
 
-        if (!usableSkillIndices.isEmpty()) { // 如果有可用的技能
-            int choice = QRandomGenerator::global()->bounded(usableSkillIndices.size());
+        if (usableSkillCount > 0) { // 如果有可用的技能
+            int choice = m_aiRandom.bounded(usableSkillCount);
             int skillIndexToUse = usableSkillIndices[choice];
             queueOpponentAction(BattleAction::USE_SKILL, skillIndexToUse);
+            chosenMove = BattleMove{BattleAction::USE_SKILL, skillIndexToUse};
             
             Skill* chosenSkill = (skillIndexToUse == -1) ? fifthSkill : aiCreature->getSkill(skillIndexToUse);
-            if(chosenSkill) addBattleLog(QString("对手准备使用 %1.").arg(chosenSkill->getName()));
+            if(chosenSkill) addSkillEvent(BattleEventKind::OPPONENT_SKILL_PLANNED, aiCreature, skillIndexToUse);
             actionTakenByAI = true;
         } else { // 没有可用的技能 (例如PP耗尽)
             // AI可以尝试恢复PP或使用“挣扎”（如果实现了）
             if (aiCreature->getCurrentPP() < aiCreature->getMaxPP()) {
                 queueOpponentAction(BattleAction::RESTORE_PP);
-                addBattleLog(QString("对手试图恢复PP."));
+                chosenMove = BattleMove{BattleAction::RESTORE_PP, -1};
+                addBattleEvent(BattleEventKind::OPPONENT_RESTORE_PP_PLANNED, aiCreature);
                 actionTakenByAI = true;
             } else {
-                 addBattleLog(QString("%1 无计可施!").arg(aiCreature->getName()));
+                 addBattleEvent(BattleEventKind::NO_USABLE_ACTION, aiCreature);
                  actionTakenByAI = true; // 视为“跳过”
             }
         }
     }
 
+    notifyObservers(&BattleObserver::onActionSubmitted, false, chosenMove.action, chosenMove.param, -1);
     m_opponentActionSubmittedThisTurn = true; // 标记AI已提交行动
-    emit opponentActionConfirmed();           // 发出信号 (UI可选地响应)
+    notifyObservers(&BattleObserver::onOpponentActionConfirmed);           // 发出信号 (UI可选地响应)
     tryProcessTurnActions();                  // 检查是否双方都已行动，以开始结算
 }
 
@@ -202,7 +380,7 @@ void BattleSystem::processTurnInputPhase() {
     }
     // 只有在非第一回合时，才触发上一回合的 turnEnded
     if (m_currentTurn > 0) { 
-         emit turnEnded(m_currentTurn);
+         notifyObservers(&BattleObserver::onTurnEnded, m_currentTurn);
     }
 
     m_currentTurn++; // 回合数增加
@@ -211,20 +389,34 @@ void BattleSystem::processTurnInputPhase() {
     m_actionQueue.clear();                     // 清空上一回合的行动队列
 
     // 发出新回合开始信号，true 表示现在是玩家的输入时机
-    emit turnStarted(m_currentTurn, true); 
-    addBattleLog(QString("--- 第 %1 回合 ---").arg(m_currentTurn));
+    notifyObservers(&BattleObserver::onTurnStarted, m_currentTurn); 
+    addBattleEvent(BattleEventKind::TURN_STARTED);
 }
 
 // 回合执行阶段
 void BattleSystem::processTurnExecutePhase() {
     if (m_battleResult != BattleResult::ONGOING) return; // 如果战斗已结束，则不处理
 
-    addBattleLog("行动处理阶段...");
+    beginTurnChanges();
+    resolveTurn();
+    recordTurnSnapshot();
+    m_turnChanges.stateHash = m_stateHashEnabled ? computeStateHash() : 0;
+    if (m_stateHashEnabled) m_turnHashes.push_back(m_turnChanges.stateHash);
+    publishTurnChanges(); // 整个回合的变化一次性交给观察者
+
+    // 如果战斗仍然在进行中，则准备下一回合的输入
+    if (m_battleResult == BattleResult::ONGOING) {
+        processTurnInputPhase();
+    }
+}
+
+void BattleSystem::resolveTurn() {
+    addBattleEvent(BattleEventKind::ACTION_PHASE);
 
     processTurnStartEffects(); // 处理回合开始时的效果
     if (checkBattleEnd()) { // 检查回合开始效果是否导致战斗结束
-        emit battleEnded(m_battleResult);
-        addBattleLog(QString("战斗因回合开始效果结束. 结果代码: %1").arg((int)m_battleResult));
+        notifyObservers(&BattleObserver::onBattleEnded, m_battleResult);
+        addBattleEvent(BattleEventKind::BATTLE_ENDED_BY_EFFECTS, nullptr, nullptr, static_cast<int>(m_battleResult), 0);
         return;
     }
 
@@ -240,15 +432,61 @@ void BattleSystem::processTurnExecutePhase() {
 
     processTurnEndEffects(); // 处理回合结束时的效果
     if (checkBattleEnd()) { // 检查回合结束效果是否导致战斗结束
-        emit battleEnded(m_battleResult);
-        addBattleLog(QString("战斗因回合结束效果结束. 结果代码: %1").arg((int)m_battleResult));
-        return;
+        notifyObservers(&BattleObserver::onBattleEnded, m_battleResult);
+        addBattleEvent(BattleEventKind::BATTLE_ENDED_BY_EFFECTS, nullptr, nullptr, static_cast<int>(m_battleResult), 1);
     }
+}
 
-    // 如果战斗仍然在进行中，则准备下一回合的输入
-    if (m_battleResult == BattleResult::ONGOING) {
-        processTurnInputPhase();
+void BattleSystem::beginTurnChanges() {
+    // 没有观察者（模拟器、AI搜索中的镜像战斗）时不收集
+    if (m_observers.isEmpty()) return;
+    m_collectingTurnChanges = true;
+    m_turnChanges.turn = m_currentTurn;
+    m_turnChanges.events.clear();
+    m_turnChanges.creatures.clear();
+    m_turnChanges.activeBefore[0] = static_cast<qint8>(m_playerActiveIndex);
+    m_turnChanges.activeBefore[1] = static_cast<qint8>(m_opponentActiveIndex);
+    for (int side = 0; side < 2; ++side) {
+        const QVector<Creature *> &team = (side == 0) ? m_playerTeam : m_opponentTeam;
+        for (int i = 0; i < team.size() && i < BATTLE_STATE_MAX_TEAM_SIZE; ++i) {
+            if (team[i]) team[i]->exportState(m_turnStartStates[side][i]);
+        }
+    }
+}
+
+void BattleSystem::publishTurnChanges() {
+    if (!m_collectingTurnChanges) return;
+    m_collectingTurnChanges = false;
+    m_turnChanges.activeAfter[0] = static_cast<qint8>(m_playerActiveIndex);
+    m_turnChanges.activeAfter[1] = static_cast<qint8>(m_opponentActiveIndex);
+    m_turnChanges.result = static_cast<quint8>(m_battleResult);
+
+    CreatureState after;
+    for (int side = 0; side < 2; ++side) {
+        const QVector<Creature *> &team = (side == 0) ? m_playerTeam : m_opponentTeam;
+        for (int i = 0; i < team.size() && i < BATTLE_STATE_MAX_TEAM_SIZE; ++i) {
+            if (!team[i]) continue;
+            team[i]->exportState(after);
+            const CreatureState &before = m_turnStartStates[side][i];
+            CreatureTurnChange change;
+            change.side = static_cast<qint8>(side);
+            change.index = static_cast<qint8>(i);
+            change.fields = 0;
+            if (before.currentHP != after.currentHP) change.fields |= TURN_CHANGE_HP;
+            if (before.currentPP != after.currentPP) change.fields |= TURN_CHANGE_PP;
+            if (before.statusCondition != after.statusCondition) change.fields |= TURN_CHANGE_STATUS;
+            if (std::memcmp(before.statStages, after.statStages, sizeof(before.statStages)) != 0) change.fields |= TURN_CHANGE_STAT_STAGES;
+            if (change.fields == 0) continue;
+            change.statusBefore = before.statusCondition;
+            change.statusAfter = after.statusCondition;
+            change.hpBefore = before.currentHP;
+            change.hpAfter = after.currentHP;
+            change.ppBefore = before.currentPP;
+            change.ppAfter = after.currentPP;
+            m_turnChanges.creatures.push_back(change);
+        }
     }
+    notifyObservers(&BattleObserver::onTurnChanges, m_turnChanges);
 }
 
 bool BattleSystem::checkBattleEnd() {
@@ -289,7 +527,7 @@ bool BattleSystem::checkBattleEnd() {
         // 先标记战斗结束状态，这样其他过程中的检查可以知道战斗已结束
         m_battleResult = newResultState;
         
-        addBattleLog("战斗结束，正在清理状态效果...");
+        addBattleEvent(BattleEventKind::BATTLE_CLEANUP);
         
         // 先清理所有回合效果，防止它们在战斗结束后继续执行
         for (Creature *creature : m_playerTeam) {
@@ -307,21 +545,78 @@ bool BattleSystem::checkBattleEnd() {
         // 确保所有队列和挂起的动作都被清空
         m_actionQueue.clear();
         
-        addBattleLog("恢复所有精灵状态...");
+        addBattleEvent(BattleEventKind::RESTORING_CREATURES);
         // 在战斗结束前恢复所有精灵的状态
         restoreCreaturesAfterBattle();
         
         // 最后发送战斗结束信号
-        emit battleEnded(m_battleResult);
+        notifyObservers(&BattleObserver::onBattleEnded, m_battleResult);
         return true;
     }
     
     return false;
 }
 
-QVector<BattleLogEntry> BattleSystem::getBattleLog() const
+const std::vector<BattleEvent> &BattleSystem::getBattleEvents() const
+{
+    return m_fullLog.getEvents();
+}
+
+QStringList BattleSystem::getBattleLog(bool html) const
+{
+    QStringList log;
+    log.reserve(static_cast<int>(m_fullLog.getEvents().size()));
+    for (const BattleEvent &event : m_fullLog.getEvents())
+    {
+        log.append(formatBattleEvent(event, html));
+    }
+    return log;
+}
+
+void BattleSystem::addObserver(BattleObserver *observer)
+{
+    if (observer && !m_observers.contains(observer)) m_observers.append(observer);
+}
+
+void BattleSystem::removeObserver(BattleObserver *observer)
+{
+    m_observers.removeAll(observer);
+}
+
+void BattleSystem::setBattleLogLevel(BattleLogLevel level)
+{
+    switch (level)
+    {
+    case BattleLogLevel::FULL:
+        m_logSink = &m_fullLog;
+        break;
+    case BattleLogLevel::COMPACT:
+        m_levelSink.reset(new CompactLogSink());
+        m_logSink = m_levelSink.get();
+        break;
+    case BattleLogLevel::COUNTERS:
+        m_levelSink.reset(new CounterLogSink());
+        m_logSink = m_levelSink.get();
+        break;
+    case BattleLogLevel::NONE:
+        m_logSink = nullptr;
+        break;
+    }
+}
+
+void BattleSystem::setLogSink(BattleLogSink *sink)
 {
-    return m_battleLog;
+    m_logSink = sink;
+}
+
+BattleLogSink *BattleSystem::getLogSink() const
+{
+    return m_logSink;
+}
+
+void BattleSystem::setBattleLogEnabled(bool enabled)
+{
+    setBattleLogLevel(enabled ? BattleLogLevel::FULL : BattleLogLevel::NONE);
 }
 
 int BattleSystem::calculateDamage(Creature *attacker, Creature *defender, Skill *skill)
@@ -330,17 +625,35 @@ int BattleSystem::calculateDamage(Creature *attacker, Creature *defender, Skill
     {
         return 0;
     }
+    if (skill->getCategory() != SkillCategory::PHYSICAL && skill->getCategory() != SkillCategory::SPECIAL)
+    {
+        return 0; // 非攻击技能
+    }
 
-    // 基础伤害计算
-    int damage = 0;
-    double typeEffectiveness = 1.0;
-    bool isCritical = false;
+    // 两次随机判定总是都会进行，保证随机流的消耗与结果无关
+    bool isCritical = m_random.bounded(100) < CRITICAL_HIT_PERCENT;
+    int randomFactor = m_random.bounded(DAMAGE_ROLL_MIN, DAMAGE_ROLL_MAX + 1);
 
-    // 检查是否是PhantomAssassinateSkill并应强制暴击
-    if (PhantomAssassinateSkill* phantomSkill = dynamic_cast<PhantomAssassinateSkill*>(skill)) {
-        if (phantomSkill->shouldForceCriticalHit(attacker, defender)) {
-            isCritical = true; // 强制暴击
-        }
+    if (const ChanceOutcome *forced = getForcedChanceOutcome(attacker))
+    {
+        isCritical = forced->critical;
+        randomFactor = forced->damageRoll;
+    }
+    // 第五技能的必定暴击条件（如绝影刺杀）沿用原有数值，不额外施加暴击倍率
+    return calculateDamage(attacker, defender, skill, isCritical, randomFactor);
+}
+
+int BattleSystem::calculateDamage(Creature *attacker, Creature *defender, Skill *skill, bool critical, int damageRoll) const
+{
+    // 应用随机变化 (85%-100%)
+    return calculateDamageBeforeRoll(attacker, defender, skill, critical) * damageRoll / 100;
+}
+
+int BattleSystem::calculateDamageBeforeRoll(Creature *attacker, Creature *defender, Skill *skill, bool critical) const
+{
+    if (!attacker || !defender || !skill)
+    {
+        return 0;
     }
 
     // 根据技能类别选择攻击和防御数值
@@ -363,7 +676,7 @@ int BattleSystem::calculateDamage(Creature *attacker, Creature *defender, Skill
     }
 
     // 计算基础伤害
-    damage = ((2 * attacker->getLevel() / 5 + 2) * skill->getPower() * attackStat / defenseStat) / 50 + 2;
+    int damage = ((2 * attacker->getLevel() / 5 + 2) * skill->getPower() * attackStat / defenseStat) / 50 + 2;
 
     // 计算STAB加成
     if (attacker->hasTypeAdvantage(skill->getType()))
@@ -372,22 +685,68 @@ int BattleSystem::calculateDamage(Creature *attacker, Creature *defender, Skill
     }
 
     // 计算属性相性
-    typeEffectiveness = attacker->getTypeEffectivenessAgainst(defender, skill->getType());
-    damage *= typeEffectiveness;
+    damage *= attacker->getTypeEffectivenessAgainst(defender, skill->getType());
 
     // 计算暴击
-    int critChance = QRandomGenerator::global()->bounded(100);
-    if (critChance < 6)
-    {                  // 6%的暴击率
-        damage *= 1.8; // 暴击伤害为正常的1.8倍
-        isCritical = true;
+    if (critical)
+    {
+        damage *= CRITICAL_HIT_MULTIPLIER;
     }
+    return damage;
+}
 
-    // 应用随机变化 (85%-100%)
-    int randomFactor = QRandomGenerator::global()->bounded(85, 101);
-    damage = damage * randomFactor / 100;
+DamageDistribution BattleSystem::getDamageDistribution(Creature *attacker, Creature *defender, Skill *skill) const
+{
+    DamageDistribution distribution;
+    if (!attacker || !defender || !skill ||
+        (skill->getCategory() != SkillCategory::PHYSICAL && skill->getCategory() != SkillCategory::SPECIAL))
+    {
+        return distribution;
+    }
 
-    return damage;
+    distribution.isAttack = true;
+    // 与executeActionQueue一致：先经过Skill::use中技能自身的命中判定，再经过checkSkillHit
+    distribution.hitProbability = skill->getHitChance() / 100.0 * getSkillHitChance(attacker, defender, skill) / 100.0;
+    distribution.criticalProbability = CRITICAL_HIT_PERCENT / 100.0;
+    distribution.stabMultiplier = attacker->hasTypeAdvantage(skill->getType()) ? 1.5 : 1.0;
+    distribution.typeEffectiveness = attacker->getTypeEffectivenessAgainst(defender, skill->getType());
+    if (MultiHitSkill *multiHit = dynamic_cast<MultiHitSkill *>(skill))
+    {
+        distribution.minHits = multiHit->getMinHits();
+        distribution.maxHits = multiHit->getMaxHits();
+    }
+
+    // 暴击与否各算一次浮动前伤害，16档浮动只需一次乘除
+    const int defenderHP = defender->getCurrentHP();
+    double expectedOnHit = 0.0;
+    double koOnHit = 0.0;
+    distribution.minDamage = -1;
+    for (int critical = 0; critical < 2; ++critical)
+    {
+        const double weight = critical ? distribution.criticalProbability : 1.0 - distribution.criticalProbability;
+        const int beforeRoll = calculateDamageBeforeRoll(attacker, defender, skill, critical != 0);
+        int koRolls = 0;
+        int damageSum = 0;
+        for (int roll = 0; roll < DAMAGE_ROLL_COUNT; ++roll)
+        {
+            const int damage = beforeRoll * (DAMAGE_ROLL_MIN + roll) / 100;
+            distribution.damage[critical][roll] = damage;
+            damageSum += damage;
+            if (damage >= defenderHP) ++koRolls;
+        }
+        if (weight <= 0.0) continue; // 不可能出现的分支不计入范围
+        // 浮动单调不减，首尾即为该分支的最小/最大值
+        const int low = distribution.damage[critical][0];
+        const int high = distribution.damage[critical][DAMAGE_ROLL_COUNT - 1];
+        distribution.minDamage = (distribution.minDamage < 0) ? low : qMin(distribution.minDamage, low);
+        distribution.maxDamage = qMax(distribution.maxDamage, high);
+        expectedOnHit += weight * damageSum / DAMAGE_ROLL_COUNT;
+        koOnHit += weight * koRolls / DAMAGE_ROLL_COUNT;
+    }
+    distribution.minDamage = qMax(0, distribution.minDamage);
+    distribution.expectedDamage = distribution.hitProbability * expectedOnHit;
+    distribution.koProbability = distribution.hitProbability * koOnHit;
+    return distribution;
 }
 
 bool BattleSystem::checkSkillHit(Creature *attacker, Creature *defender, Skill *skill)
@@ -402,6 +761,26 @@ bool BattleSystem::checkSkillHit(Creature *attacker, Creature *defender, Skill *
     {
         return true;
     }
+    if (const ChanceOutcome *forced = getForcedChanceOutcome(attacker))
+    {
+        return forced->hit;
+    }
+
+    // 检查是否命中
+    int hitChance = m_random.bounded(100);
+    return hitChance < getSkillHitChance(attacker, defender, skill);
+}
+
+int BattleSystem::getSkillHitChance(Creature *attacker, Creature *defender, Skill *skill) const
+{
+    if (!attacker || !defender || !skill)
+    {
+        return 0;
+    }
+    if (skill->isAlwaysHit())
+    {
+        return 100;
+    }
 
     // 计算命中率
     int accuracy = skill->getAccuracy();
@@ -414,9 +793,29 @@ bool BattleSystem::checkSkillHit(Creature *attacker, Creature *defender, Skill *
     double evasionMod = StatStages::calculateModifier(StatType::EVASION, defender->getStatStages().getStage(StatType::EVASION));
     accuracy = static_cast<int>(accuracy / evasionMod);
 
-    // 检查是否命中
-    int hitChance = QRandomGenerator::global()->bounded(100);
-    return hitChance < accuracy;
+    return qBound(0, accuracy, 100);
+}
+
+void BattleSystem::setForcedChanceOutcome(bool forPlayer, const ChanceOutcome &outcome)
+{
+    const int side = forPlayer ? 0 : 1;
+    m_forcedChance[side] = outcome;
+    m_chanceForced[side] = true;
+}
+
+void BattleSystem::clearForcedChanceOutcomes()
+{
+    m_chanceForced[0] = false;
+    m_chanceForced[1] = false;
+}
+
+const ChanceOutcome *BattleSystem::getForcedChanceOutcome(const Creature *attacker) const
+{
+    // 只作用于指定时的出场精灵：回合中途换上的精灵照常随机
+    if (!attacker) return nullptr;
+    if (m_chanceForced[0] && attacker == getPlayerActiveCreature()) return &m_forcedChance[0];
+    if (m_chanceForced[1] && attacker == getOpponentActiveCreature()) return &m_forcedChance[1];
+    return nullptr;
 }
 
 void BattleSystem::queuePlayerAction(BattleAction action, int param1, int param2) {
@@ -480,13 +879,13 @@ void BattleSystem::executeActionQueue() {
         if (m_battleResult != BattleResult::ONGOING) break; // 如果战斗中途结束，停止处理后续行动
 
         Creature* actor = item.actor;
-        // 检查行动者状态
-        if (!actor || actor->isDead()) {
-            addBattleLog(QString("%1 无法行动 (已濒死)!").arg(actor ? actor->getName() : "一个精灵"));
+        // 检查行动者状态（濒死精灵只能执行换人）
+        if (!actor || (actor->isDead() && item.action != BattleAction::SWITCH_CREATURE)) {
+            addBattleEvent(BattleEventKind::CANNOT_ACT, actor, nullptr, 0, static_cast<int>(BattleEventReason::FAINTED));
             continue;
         }
-        if (!actor->canAct()) {
-            addBattleLog(QString("%1 因状态无法行动!").arg(actor->getName()));
+        if (!actor->isDead() && !actor->canAct()) {
+            addBattleEvent(BattleEventKind::CANNOT_ACT, actor, nullptr, 0, static_cast<int>(BattleEventReason::STATUS));
             // 精灵的 onTurnStart() 或状态效果逻辑可能已经打印了更具体的信息
             continue;
         }
@@ -504,12 +903,12 @@ void BattleSystem::executeActionQueue() {
                 else if (item.param1 >= 0 && item.param1 < actor->getSkillCount()) skillToUse = actor->getSkill(item.param1);
 
                 if (!skillToUse) {
-                    addBattleLog(QString("%1 试图使用未知技能!").arg(actor->getName()));
+                    addBattleEvent(BattleEventKind::UNKNOWN_SKILL, actor);
                     continue; // 跳过此无效行动
                 }
                 // 检查PP是否足够
                 if (actor->getCurrentPP() < skillToUse->getPPCost()){
-                    addBattleLog(QString("%1 的 %2 因PP不足使用失败!").arg(actor->getName()).arg(skillToUse->getName()));
+                    addSkillEvent(BattleEventKind::NOT_ENOUGH_PP, actor, item.param1);
                     continue;
                 }
                 
@@ -524,11 +923,11 @@ void BattleSystem::executeActionQueue() {
 
                 // 再次检查目标有效性（例如，如果对方在我方选择技能后恰好切换或濒死）
                 if (!target || (target->isDead() && skillToUse->getCategory() != SkillCategory::STATUS)) { 
-                    addBattleLog(QString("%1 的技能 %2 没有有效目标!").arg(actor->getName()).arg(skillToUse->getName()));
+                    addSkillEvent(BattleEventKind::NO_TARGET, actor, item.param1);
                     continue;
                 }
                 
-                addBattleLog(QString("%1 使用了 %2!").arg(actor->getName()).arg(skillToUse->getName()));
+                addSkillEvent(BattleEventKind::SKILL_USED, actor, item.param1, target);
                 actor->consumePP(skillToUse->getPPCost()); // 消耗PP
 
                 // Skill::use 主要负责命中判定和应用非伤害效果
@@ -539,47 +938,43 @@ void BattleSystem::executeActionQueue() {
                             int damage = calculateDamage(actor, target, skillToUse); // BattleSystem计算伤害
                             target->takeDamage(damage); // 应用伤害
 
-                            // 添加更详细的战斗日志 - 修复格式问题
-                            QString stabBonusText = actor->hasTypeAdvantage(skillToUse->getType()) ? "（属性一致加成）" : "";
-                            double effectiveness = actor->getTypeEffectivenessAgainst(target, skillToUse->getType());
-                            QString effectText = "";
-                            if (effectiveness > 1.5) effectText = "效果拔群！"; 
-                            else if (effectiveness == 1.5) effectText = "效果绝佳！";
-                            else if (effectiveness < 1.0 && effectiveness > 0.0) effectText = "效果不理想。";
-                            else if (effectiveness == 0.0) effectText = "没有效果。";
-                            
-                            // 使用正确的参数顺序添加战斗日志
-                            addBattleLog(QString("%1的%2对%3造成了%4点伤害！%5 %6")
-                                .arg(actor->getName())
-                                .arg(skillToUse->getName())
-                                .arg(target->getName())
-                                .arg(damage)
-                                .arg(stabBonusText)
-                                .arg(effectText), 
-                                actor, target);
+                            // 记录伤害事件，属性一致加成与相性在显示时再转成文字
+                            if (isBattleLogEnabled()) {
+                                BattleEvent event = makeEvent(BattleEventKind::SKILL_DAMAGE, actor, target);
+                                event.skillIndex = static_cast<qint8>(item.param1);
+                                event.amount = damage;
+                                event.value = qRound(actor->getTypeEffectivenessAgainst(target, skillToUse->getType()) * 100);
+                                if (actor->hasTypeAdvantage(skillToUse->getType())) event.flags |= BATTLE_EVENT_STAB;
+                                appendEvent(event);
+                            }
                                 
-                            // 发出伤害信号，但不触发额外的伤害日志
-                            emit damageCaused(target, damage);
+                            // 通知观察者，但不触发额外的伤害日志
+                            notifyObservers(&BattleObserver::onDamageCaused, target, damage);
+                            notifyObservers(&BattleObserver::onSkillUsed, actor, target, skillToUse, true, damage);
 
                             // 检查目标是否因此次伤害而濒死
                             if (target->isDead()) {
-                                addBattleLog(QString("%1 倒下了!").arg(target->getName()));
-                                if (checkBattleEnd()) { emit battleEnded(m_battleResult); return; } // 战斗结束则返回
+                                addBattleEvent(BattleEventKind::FAINTED, target);
+                                if (checkBattleEnd()) { notifyObservers(&BattleObserver::onBattleEnded, m_battleResult); return; } // 战斗结束则返回
                                 // TODO: 如果目标是当前活跃精灵且濒死，应提示切换（如果是AI，则AI决策切换）
                             }
                         } else {
-                            addBattleLog(QString("%1 的 %2 未能命中 %3!").arg(actor->getName()).arg(skillToUse->getName()).arg(target->getName()));
+                            addSkillEvent(BattleEventKind::SKILL_MISSED, actor, item.param1, target);
+                            notifyObservers(&BattleObserver::onSkillUsed, actor, target, skillToUse, false, 0);
                         }
+                    } else {
+                        notifyObservers(&BattleObserver::onSkillUsed, actor, target, skillToUse, true, 0);
                     }
                     // 状态技能或攻击技能附带的非伤害效果已在 Skill::use -> Effect::apply 中处理
                     // 检查目标是否因技能效果（如中毒、诅咒等间接伤害）而濒死
                     if (target && target->isDead() && (skillToUse->getCategory() == SkillCategory::STATUS || skillToUse->getCategory() == SkillCategory::PHYSICAL || skillToUse->getCategory() == SkillCategory::SPECIAL) ) {
                          // 此检查可能有些多余，但保留以防万一
-                         if (checkBattleEnd()) { emit battleEnded(m_battleResult); return; }
+                         if (checkBattleEnd()) { notifyObservers(&BattleObserver::onBattleEnded, m_battleResult); return; }
                     }
                 } else {
                     // Skill::use 返回 false 通常意味着未命中或不满足使用条件（已在内部log）
                     // addBattleLog(QString("%1的%2使用失败或未命中!").arg(actor->getName()).arg(skillToUse->getName())); // 此log可能重复
+                    notifyObservers(&BattleObserver::onSkillUsed, actor, target, skillToUse, false, 0);
                 }
                 break;
             }
@@ -591,57 +986,57 @@ void BattleSystem::executeActionQueue() {
                         m_playerTeam[switchToIndex] && !m_playerTeam[switchToIndex]->isDead() && 
                         m_playerActiveIndex != switchToIndex) {
                         m_playerActiveIndex = switchToIndex;
-                        addBattleLog(QString("你换上了 %1!").arg(getPlayerActiveCreature()->getName()));
-                        emit creatureSwitched(oldCreature, getPlayerActiveCreature(), true);
+                        addBattleEvent(BattleEventKind::SWITCHED, getPlayerActiveCreature(), oldCreature);
+                        notifyObservers(&BattleObserver::onCreatureSwitched, oldCreature, getPlayerActiveCreature(), true);
                         getPlayerActiveCreature()->resetStatStages(); // 新上场精灵重置能力等级
                     } else {
-                        addBattleLog("切换精灵失败 (选择无效或精灵已濒死).");
+                        addBattleEvent(BattleEventKind::SWITCH_FAILED, actor);
                     }
                 } else { // 如果是对手切换
                     if (switchToIndex >= 0 && switchToIndex < m_opponentTeam.size() && 
                         m_opponentTeam[switchToIndex] && !m_opponentTeam[switchToIndex]->isDead() && 
                         m_opponentActiveIndex != switchToIndex) {
                         m_opponentActiveIndex = switchToIndex;
-                        addBattleLog(QString("对手换上了 %1!").arg(getOpponentActiveCreature()->getName()));
-                        emit creatureSwitched(oldCreature, getOpponentActiveCreature(), false);
+                        addBattleEvent(BattleEventKind::SWITCHED, getOpponentActiveCreature(), oldCreature);
+                        notifyObservers(&BattleObserver::onCreatureSwitched, oldCreature, getOpponentActiveCreature(), false);
                         getOpponentActiveCreature()->resetStatStages(); // 新上场精灵重置能力等级
                     } else {
-                         addBattleLog("对手切换精灵失败.");
+                         addBattleEvent(BattleEventKind::SWITCH_FAILED, actor);
                     }
                 }
                 break;
             }
             case BattleAction::USE_ITEM: { // 处理使用道具逻辑（当前为占位）
-                addBattleLog(QString("%1 使用了道具 (功能待实现).").arg(actor->getName()));
+                addBattleEvent(BattleEventKind::ITEM_USED, actor);
                 break;
             }
             case BattleAction::RESTORE_PP: { // 处理恢复PP逻辑
                 if (actor && actor->canAct() && actor->getCurrentPP() < actor->getMaxPP()) {
                     actor->restorePP(4); // 实际恢复PP
-                    addBattleLog(QString("<font color='blue'>%1 恢复了4点PP!</font>").arg(actor->getName()), actor);
-                    // UI更新将通过 battleLogUpdated 或其他特定信号（如PP变化信号，如果添加的话）触发
-                    // BattleScene的onBattleLogUpdated会调用updatePlayerUI和updateSkillButtons
+                    addBattleEvent(BattleEventKind::PP_RESTORED, actor, nullptr, 4);
+                    // UI更新将通过 battleEventAdded 或其他特定信号（如PP变化信号，如果添加的话）触发
+                    // BattleScene的onBattleEventAdded会调用updatePlayerUI和updateSkillButtons
                 } else if (actor) {
-                    addBattleLog(QString("%1 试图恢复PP但失败了(PP已满或无法行动)!").arg(actor->getName()), actor);
+                    addBattleEvent(BattleEventKind::PP_RESTORE_FAILED, actor);
                 }
                 break;
             }
             case BattleAction::ESCAPE: { // 处理逃跑逻辑
                 if (m_isPvP) {
-                    addBattleLog("PvP战斗中无法逃跑!");
+                    addBattleEvent(BattleEventKind::ESCAPE_BLOCKED, actor);
                 } else {
                     // 逃跑成功率提高到75%（示例）
-                    if (QRandomGenerator::global()->bounded(100) < 75) { 
+                    if (m_random.bounded(100) < 75) { 
                         m_battleResult = BattleResult::ESCAPE;
-                        addBattleLog("成功逃脱!");
+                        addBattleEvent(BattleEventKind::ESCAPED, actor);
                         
                         // 添加这行：在逃跑成功时也恢复所有精灵的状态
                         restoreCreaturesAfterBattle();
                         
-                        emit battleEnded(m_battleResult); // 逃跑成功，战斗立即结束
+                        notifyObservers(&BattleObserver::onBattleEnded, m_battleResult); // 逃跑成功，战斗立即结束
                         return; // 停止处理后续行动
                     } else {
-                        addBattleLog("逃跑失败!");
+                        addBattleEvent(BattleEventKind::ESCAPE_FAILED, actor);
                     }
                 }
                 break;
@@ -649,7 +1044,7 @@ void BattleSystem::executeActionQueue() {
         }
         // 每次行动执行完毕后，都检查战斗是否结束
         if (checkBattleEnd() && m_battleResult != BattleResult::ONGOING) { // checkBattleEnd 会设置 m_battleResult
-             emit battleEnded(m_battleResult); // 如果战斗结束，发出信号
+             notifyObservers(&BattleObserver::onBattleEnded, m_battleResult); // 如果战斗结束，发出信号
              return; // 战斗结束，不再处理队列中剩余的行动
         }
     }
@@ -658,23 +1053,23 @@ void BattleSystem::executeActionQueue() {
 void BattleSystem::processTurnStartEffects() {
     if (m_battleResult != BattleResult::ONGOING) return;
     
-    addBattleLog("回合结束效果结算...");
+    addBattleEvent(BattleEventKind::TURN_EFFECTS_PHASE);
     Creature* playerC = getPlayerActiveCreature();
     Creature* opponentC = getOpponentActiveCreature();
     
     if (playerC && !playerC->isDead()) {
-        playerC->onTurnEnd(this);
+        playerC->onTurnStart(this);
         // 每次效果处理后检查战斗状态
         if (m_battleResult != BattleResult::ONGOING) return;
     }
     
     if (opponentC && !opponentC->isDead()) {
-        opponentC->onTurnEnd(this);
+        opponentC->onTurnStart(this);
     }
 }
 
 void BattleSystem::processTurnEndEffects() {
-    addBattleLog("回合结束效果结算...");
+    addBattleEvent(BattleEventKind::TURN_EFFECTS_PHASE);
     Creature* playerC = getPlayerActiveCreature();
     Creature* opponentC = getOpponentActiveCreature();
     if (playerC && !playerC->isDead()) playerC->onTurnEnd(this);
@@ -683,135 +1078,299 @@ void BattleSystem::processTurnEndEffects() {
     if (opponentC && !opponentC->isDead()) opponentC->onTurnEnd(this);
 }
 
+BattleEvent BattleSystem::makeEvent(BattleEventKind kind, const Creature *source, const Creature *target) const
+{
+    BattleEvent event;
+    std::memset(&event, 0, sizeof(event));
+    event.kind = kind;
+    event.turn = static_cast<qint16>(m_currentTurn);
+    event.skillIndex = -1;
+    locateCreature(source, event.sourceSide, event.sourceIndex);
+    locateCreature(target, event.targetSide, event.targetIndex);
+    return event;
+}
+
+void BattleSystem::appendEvent(const BattleEvent &event)
+{
+    m_logSink->record(event);
+    if (m_collectingTurnChanges) m_turnChanges.events.push_back(event);
+    notifyObservers(&BattleObserver::onBattleEvent, event);
+}
+
+void BattleSystem::recordEvent(BattleEventKind kind, Creature *source, Creature *target, int amount, int value)
+{
+    BattleEvent event = makeEvent(kind, source, target);
+    event.amount = amount;
+    event.value = value;
+    appendEvent(event);
+}
+
+void BattleSystem::addSkillEvent(BattleEventKind kind, Creature *actor, int skillIndex, Creature *target, int amount)
+{
+    if (!m_logSink) return;
+
+    BattleEvent event = makeEvent(kind, actor, target);
+    event.skillIndex = static_cast<qint8>(skillIndex);
+    event.amount = amount;
+    appendEvent(event);
+}
+
 void BattleSystem::addBattleLog(const QString &message, Creature *source, Creature *target)
 {
-    BattleLogEntry entry;
-    entry.message = message;
-    entry.turn = m_currentTurn;
+    if (!m_logSink) return;
 
+    BattleEvent event = makeEvent(BattleEventKind::TEXT, source, target);
+    event.value = m_logSink->addText(message);
+    appendEvent(event);
+}
+
+QString BattleSystem::formatBattleEvent(const BattleEvent &event, bool html) const
+{
+    const Creature *source = creatureAt(event.sourceSide, event.sourceIndex);
+    const Creature *target = creatureAt(event.targetSide, event.targetIndex);
+    const QString sourceName = source ? source->getName() : QString("一个精灵");
+    const QString targetName = target ? target->getName() : QString("一个精灵");
+    QString skillName;
     if (source)
     {
-        entry.sourceCreature = source->getName();
+        const Skill *skill = (event.skillIndex == -1) ? source->getFifthSkill() : source->getSkill(event.skillIndex);
+        skillName = skill ? skill->getName() : QString("未知技能");
     }
-
-    if (target)
+    auto eventText = [this, &event]() { return m_fullLog.getText(event.value); };
+    const StatusCondition status = static_cast<StatusCondition>(event.status);
+    // 只有界面显示时才加颜色标签
+    auto colored = [html](const QString &message, const QString &color) {
+        return html ? QString("<font color='%1'>%2</font>").arg(color, message) : message;
+    };
+
+    switch (event.kind)
+    {
+    case BattleEventKind::TEXT:
+        return eventText();
+    case BattleEventKind::BATTLE_STARTED:
+        return "战斗开始!";
+    case BattleEventKind::TURN_STARTED:
+        return QString("--- 第 %1 回合 ---").arg(event.turn);
+    case BattleEventKind::ACTION_PHASE:
+        return "行动处理阶段...";
+    case BattleEventKind::TURN_EFFECTS_PHASE:
+        return "回合结束效果结算...";
+    case BattleEventKind::BATTLE_ENDED_BY_EFFECTS:
+        return QString("战斗因回合%1效果结束. 结果代码: %2").arg(event.value == 0 ? "开始" : "结束").arg(event.amount);
+    case BattleEventKind::BATTLE_CLEANUP:
+        return "战斗结束，正在清理状态效果...";
+    case BattleEventKind::RESTORING_CREATURES:
+        return "恢复所有精灵状态...";
+    case BattleEventKind::CREATURES_RESTORED:
+        return "所有精灵的状态已恢复。";
+    case BattleEventKind::ACTION_SUBMITTED:
+        return QString("%1 选择了行动.").arg(sourceName);
+    case BattleEventKind::CANNOT_ACT:
+        switch (static_cast<BattleEventReason>(event.value))
+        {
+        case BattleEventReason::SPECIAL_STATUS:
+            return QString("%1 因特殊状态无法行动!").arg(sourceName);
+        case BattleEventReason::FAINTED:
+            return QString("%1 无法行动 (已濒死)!").arg(sourceName);
+        case BattleEventReason::STATUS:
+            return QString("%1 因状态无法行动!").arg(sourceName);
+        default:
+            return QString("%1 无法行动!").arg(sourceName);
+        }
+    case BattleEventKind::OPPONENT_SWITCH_PLANNED:
+        return QString("对手换上了 %1.").arg(targetName);
+    case BattleEventKind::OPPONENT_RESTORE_PP_PLANNED:
+        return "对手试图恢复PP.";
+    case BattleEventKind::OPPONENT_SKILL_PLANNED:
+        return QString("对手准备使用 %1.").arg(skillName);
+    case BattleEventKind::OPPONENT_NO_CREATURES:
+        return "对手没有其他可战斗的精灵了!";
+    case BattleEventKind::NO_USABLE_ACTION:
+        return QString("%1 无计可施!").arg(sourceName);
+    case BattleEventKind::UNKNOWN_SKILL:
+        return QString("%1 试图使用未知技能!").arg(sourceName);
+    case BattleEventKind::NOT_ENOUGH_PP:
+        return QString("%1 的 %2 因PP不足使用失败!").arg(sourceName, skillName);
+    case BattleEventKind::NO_TARGET:
+        return QString("%1 的技能 %2 没有有效目标!").arg(sourceName, skillName);
+    case BattleEventKind::SKILL_USED:
+        return QString("%1 使用了 %2!").arg(sourceName, skillName);
+    case BattleEventKind::SKILL_DAMAGE:
     {
-        entry.targetCreature = target->getName();
+        const QString stabBonusText = (event.flags & BATTLE_EVENT_STAB) ? "（属性一致加成）" : "";
+        QString effectText;
+        if (event.value > 150) effectText = "效果拔群！";
+        else if (event.value == 150) effectText = "效果绝佳！";
+        else if (event.value < 100 && event.value > 0) effectText = "效果不理想。";
+        else if (event.value == 0) effectText = "没有效果。";
+        return QString("%1的%2对%3造成了%4点伤害！%5 %6")
+            .arg(sourceName, skillName, targetName)
+            .arg(event.amount)
+            .arg(stabBonusText, effectText);
     }
-
-    m_battleLog.append(entry);
-    emit battleLogUpdated(message);
+    case BattleEventKind::SKILL_MISSED:
+        return QString("%1 的 %2 未能命中 %3!").arg(sourceName, skillName, targetName);
+    case BattleEventKind::FAINTED:
+        return html ? QString("<font color='red'><b>%1 倒下了!</b></font>").arg(sourceName)
+                    : QString("%1 倒下了!").arg(sourceName);
+    case BattleEventKind::SWITCHED:
+        return QString(event.sourceSide == 0 ? "你换上了 %1!" : "对手换上了 %1!").arg(sourceName);
+    case BattleEventKind::SWITCH_FAILED:
+        return event.sourceSide == 0 ? "切换精灵失败 (选择无效或精灵已濒死)." : "对手切换精灵失败.";
+    case BattleEventKind::ITEM_USED:
+        return QString("%1 使用了道具 (功能待实现).").arg(sourceName);
+    case BattleEventKind::PP_RESTORED:
+        return colored(QString("%1 恢复了%2点PP!").arg(sourceName).arg(event.amount), "blue");
+    case BattleEventKind::PP_RESTORE_FAILED:
+        return QString("%1 试图恢复PP但失败了(PP已满或无法行动)!").arg(sourceName);
+    case BattleEventKind::ESCAPE_BLOCKED:
+        return "PvP战斗中无法逃跑!";
+    case BattleEventKind::ESCAPED:
+        return "成功逃脱!";
+    case BattleEventKind::ESCAPE_FAILED:
+        return "逃跑失败!";
+    case BattleEventKind::HEALED:
+        return QString("%1 恢复了%2点生命值!").arg(targetName).arg(event.amount);
+    case BattleEventKind::DAMAGED:
+        // 根据伤害来源输出不同的文字
+        if (status != StatusCondition::NONE)
+        {
+            return QString("%1 因%2状态受到了%3点伤害!").arg(targetName, getStatusConditionName(status)).arg(event.amount);
+        }
+        return QString("%1 受到了%2点伤害!").arg(targetName).arg(event.amount);
+    case BattleEventKind::STAT_STAGE_CHANGED:
+    {
+        const bool raised = event.amount > event.value;
+        return colored(QString("%1 的%2%3 %4级!")
+                           .arg(targetName, getStatTypeName(static_cast<StatType>(event.stat)), raised ? "提高了" : "降低了")
+                           .arg(qAbs(event.amount - event.value)),
+                       raised ? "blue" : "red");
+    }
+    case BattleEventKind::STATUS_CHANGED:
+    {
+        if (status == StatusCondition::NONE)
+        {
+            return QString("%1 的 %2 状态解除了!").arg(targetName, getStatusConditionName(static_cast<StatusCondition>(event.value)));
+        }
+        QString message = colored(QString("%1 陷入了 %2 状态!").arg(targetName, getStatusConditionName(status)), "#AA00AA");
+        // 附上状态效果的具体说明
+        QString detail;
+        switch (status)
+        {
+        case StatusCondition::BURN:      detail = QString("烧伤使%1的攻击降低，并每回合受到伤害。").arg(targetName); break;
+        case StatusCondition::POISON:    detail = QString("中毒使%1每回合受到伤害。").arg(targetName); break;
+        case StatusCondition::PARALYZE:  detail = QString("麻痹使%1速度降低，并可能无法行动。").arg(targetName); break;
+        case StatusCondition::SLEEP:     detail = QString("%1陷入了睡眠，暂时无法行动。").arg(targetName); break;
+        case StatusCondition::CONFUSION: detail = QString("%1陷入了混乱，可能会攻击自己。").arg(targetName); break;
+        case StatusCondition::FREEZE:    detail = QString("%1被冻结，无法行动。").arg(targetName); break;
+        case StatusCondition::FEAR:      detail = QString("%1陷入恐惧，可能无法行动。").arg(targetName); break;
+        case StatusCondition::TIRED:     detail = QString("%1因疲惫而行动变慢。").arg(targetName); break;
+        case StatusCondition::BLEED:     detail = QString("%1正在流血，会持续受到伤害。").arg(targetName); break;
+        default: break;
+        }
+        if (!detail.isEmpty()) message += (html ? "<br>" : "\n") + detail;
+        return message;
+    }
+    case BattleEventKind::EFFECT_APPLIED:
+        return QString("%1 受到了「%2」的效果").arg(targetName, eventText());
+    case BattleEventKind::TURN_EFFECT_APPLIED:
+        return QString("%1 获得了持续效果「%2」(%3回合)").arg(targetName, eventText()).arg(event.amount);
+    case BattleEventKind::EFFECT_CLEARED:
+        return QString("%1 的 %2 被清除了!").arg(targetName, eventText());
+    case BattleEventKind::STATUS_IMMUNE:
+        return QString("%1 免疫了 %2 状态!").arg(targetName, getStatusConditionName(status));
+    }
+    return QString();
 }
-// 触发技能使用信号
 
 void BattleSystem::triggerHealingReceived(Creature* creature, int amount) {
     if (amount > 0) {
-        // 添加战斗日志
-        addBattleLog(QString("%1 恢复了%2点生命值!").arg(creature->getName()).arg(amount), nullptr, creature);
+        addBattleEvent(BattleEventKind::HEALED, nullptr, creature, amount);
         // 发出信号
-        emit healingReceived(creature, amount);
+        notifyObservers(&BattleObserver::onHealingReceived, creature, amount);
     }
 }
 
 void BattleSystem::triggerDamageCaused(Creature* creature, int amount, StatusCondition fromStatus) {
     if (amount > 0) {
-        // 根据伤害来源输出不同的日志
-        if (fromStatus != StatusCondition::NONE) {
-            QString statusName = getStatusConditionName(fromStatus);
-            addBattleLog(QString("%1 因%2状态受到了%3点伤害!").arg(creature->getName()).arg(statusName).arg(amount), nullptr, creature);
-        } else {
-            // 普通伤害日志
-            addBattleLog(QString("%1 受到了%2点伤害!").arg(creature->getName()).arg(amount), nullptr, creature);
+        // 伤害来源（如中毒）记录在事件里，显示时区分
+        if (m_logSink) {
+            BattleEvent event = makeEvent(BattleEventKind::DAMAGED, nullptr, creature);
+            event.amount = amount;
+            event.status = static_cast<quint8>(fromStatus);
+            appendEvent(event);
         }
-        
+
         // 发出信号
-        emit damageCaused(creature, amount);
+        notifyObservers(&BattleObserver::onDamageCaused, creature, amount);
     }
 }
 
 void BattleSystem::triggerStatStageChanged(Creature* target, StatType stat, int oldStage, int newStage) {
     if (oldStage == newStage) return;
-    
-    QString statName = getStatTypeName(stat);
-    int change = abs(newStage - oldStage);
-    QString color = newStage > oldStage ? "blue" : "red";
-    QString changeDirection = newStage > oldStage ? "提高了" : "降低了";
-    
-    addBattleLog(QString("<font color='%1'>%2 的%3%4 %5级!</font>").arg(color).arg(target->getName()).arg(statName).arg(changeDirection).arg(change), nullptr, target);
-    
-    emit statStageChanged(target, stat, oldStage, newStage);
+
+    if (m_logSink) {
+        BattleEvent event = makeEvent(BattleEventKind::STAT_STAGE_CHANGED, nullptr, target);
+        event.stat = static_cast<quint8>(stat);
+        event.value = oldStage;
+        event.amount = newStage;
+        appendEvent(event);
+    }
+
+    notifyObservers(&BattleObserver::onStatStageChanged, target, stat, oldStage, newStage);
 }
 
 void BattleSystem::triggerStatusChanged(Creature* target, StatusCondition oldCondition, StatusCondition newCondition) {
 
     if (oldCondition == newCondition) return;
-    
-    if (newCondition == StatusCondition::NONE) {
-        addBattleLog(QString("%1 的 %2 状态解除了!").arg(target->getName()).arg(getStatusConditionName(oldCondition)));
-    } else {
-        addBattleLog(QString("<font color='#AA00AA'>%1 陷入了 %2 状态!</font>").arg(target->getName()).arg(getStatusConditionName(newCondition)));
-        
-        // 添加状态效果的具体说明
-        switch (newCondition) {
-            case StatusCondition::BURN:
-                addBattleLog(QString("烧伤使%1的攻击降低，并每回合受到伤害。").arg(target->getName()));
-                break;
-            case StatusCondition::POISON:
-                addBattleLog(QString("中毒使%1每回合受到伤害。").arg(target->getName()));
-                break;
-            case StatusCondition::PARALYZE:
-                addBattleLog(QString("麻痹使%1速度降低，并可能无法行动。").arg(target->getName()));
-                break;
-            case StatusCondition::SLEEP:
-                addBattleLog(QString("%1陷入了睡眠，暂时无法行动。").arg(target->getName()));
-                break;
-            case StatusCondition::CONFUSION:
-                addBattleLog(QString("%1陷入了混乱，可能会攻击自己。").arg(target->getName()));
-                break;
-            case StatusCondition::FREEZE:
-                addBattleLog(QString("%1被冻结，无法行动。").arg(target->getName()));
-                break;
-            case StatusCondition::FEAR:
-                addBattleLog(QString("%1陷入恐惧，可能无法行动。").arg(target->getName()));
-                break;
-            case StatusCondition::TIRED:
-                addBattleLog(QString("%1因疲惫而行动变慢。").arg(target->getName()));
-                break;
-            case StatusCondition::BLEED:
-                addBattleLog(QString("%1正在流血，会持续受到伤害。").arg(target->getName()));
-                break;
-            default:
-                break;
-        }
+
+    if (m_logSink) {
+        BattleEvent event = makeEvent(BattleEventKind::STATUS_CHANGED, nullptr, target);
+        event.status = static_cast<quint8>(newCondition);
+        event.value = static_cast<int>(oldCondition);
+        appendEvent(event);
     }
-    
-    emit statusChanged(target, oldCondition, newCondition);
+
+    notifyObservers(&BattleObserver::onStatusChanged, target, oldCondition, newCondition);
 }
 
 void BattleSystem::triggerEffectApplied(Creature* source, Creature* target, Effect* effect, bool success) {
     if (!effect || !target) return;
     
     if (success) {
-        QString targetDesc = effect->isTargetSelf() ? source->getName() : target->getName();
-        addBattleLog(QString("%1 受到了「%2」的效果").arg(targetDesc).arg(effect->getDescription()), source, target);
+        if (m_logSink) {
+            BattleEvent event = makeEvent(BattleEventKind::EFFECT_APPLIED, source, effect->isTargetSelf() ? source : target);
+            event.value = m_logSink->addText(effect->getDescription());
+            appendEvent(event);
+        }
     } else {
         // 可能显示效果应用失败的原因
     }
 }
 
-void BattleSystem::triggerTurnEffectApplied(Creature* source, Creature* target, TurnBasedEffect* effect) {
-    if (!effect || !target) return;
-    
-    Creature* actualTarget = effect->isTargetSelf() ? source : target;
-    addBattleLog(QString("%1 获得了持续效果「%2」(%3回合)").arg(actualTarget->getName()).arg(effect->getDescription()).arg(effect->getDuration()), source, actualTarget);
+void BattleSystem::triggerTurnEffectApplied(Creature* source, Creature* target, const TurnEffectSlot& effect) {
+    if (!target || !m_logSink) return;
+
+    BattleEvent event = makeEvent(BattleEventKind::TURN_EFFECT_APPLIED, source, target);
+    event.amount = effect.duration;
+    event.value = m_logSink->addText(getTurnEffectDescription(effect));
+    appendEvent(event);
 }
 
 void BattleSystem::triggerEffectCleared(Creature* target, const QString& effectType) {
-    addBattleLog(QString("%1 的 %2 被清除了!").arg(target->getName()).arg(effectType));
+    if (!m_logSink) return;
+
+    BattleEvent event = makeEvent(BattleEventKind::EFFECT_CLEARED, nullptr, target);
+    event.value = m_logSink->addText(effectType);
+    appendEvent(event);
 }
 
 void BattleSystem::triggerStatusBlockedByImmunity(Creature* target, StatusCondition condition) {
-    addBattleLog(QString("%1 免疫了 %2 状态!").arg(target->getName()).arg(getStatusConditionName(condition)));
+    if (!m_logSink) return;
+
+    BattleEvent event = makeEvent(BattleEventKind::STATUS_IMMUNE, nullptr, target);
+    event.status = static_cast<quint8>(condition);
+    appendEvent(event);
 }
 
 QString BattleSystem::getStatTypeName(StatType stat) const {
@@ -843,6 +1402,221 @@ QString BattleSystem::getStatusConditionName(StatusCondition condition) const {
     }
 }
 
+// 查找精灵所在的阵营(0玩家/1对手)和队伍下标
+bool BattleSystem::locateCreature(const Creature *creature, qint8 &side, qint8 &index) const
+{
+    side = -1;
+    index = -1;
+    if (!creature) return false;
+    int i = m_playerTeam.indexOf(const_cast<Creature *>(creature));
+    if (i >= 0)
+    {
+        side = 0;
+        index = static_cast<qint8>(i);
+        return true;
+    }
+    i = m_opponentTeam.indexOf(const_cast<Creature *>(creature));
+    if (i >= 0)
+    {
+        side = 1;
+        index = static_cast<qint8>(i);
+        return true;
+    }
+    return false;
+}
+
+Creature *BattleSystem::creatureAt(int side, int index) const
+{
+    const QVector<Creature *> &team = (side == 0) ? m_playerTeam : m_opponentTeam;
+    return (index >= 0 && index < team.size()) ? team[index] : nullptr;
+}
+
+bool BattleSystem::exportState(BattleState &state) const
+{
+    if (m_playerTeam.size() > BATTLE_STATE_MAX_TEAM_SIZE || m_opponentTeam.size() > BATTLE_STATE_MAX_TEAM_SIZE ||
+        m_actionQueue.size() > BATTLE_STATE_MAX_PENDING_ACTIONS)
+    {
+        return false;
+    }
+
+    std::memset(&state, 0, sizeof(state)); // 未使用的槽位和填充字节清零，保证相同状态导出的字节一致
+    state.currentTurn = m_currentTurn;
+    state.playerTeamSize = static_cast<quint8>(m_playerTeam.size());
+    state.opponentTeamSize = static_cast<quint8>(m_opponentTeam.size());
+    state.playerActiveIndex = static_cast<qint8>(m_playerActiveIndex);
+    state.opponentActiveIndex = static_cast<qint8>(m_opponentActiveIndex);
+    state.battleResult = static_cast<quint8>(m_battleResult);
+    state.playerActionSubmitted = m_playerActionSubmittedThisTurn ? 1 : 0;
+    state.opponentActionSubmitted = m_opponentActionSubmittedThisTurn ? 1 : 0;
+    m_random.getState(state.randomState);
+
+    for (int side = 0; side < 2; ++side)
+    {
+        const QVector<Creature *> &team = (side == 0) ? m_playerTeam : m_opponentTeam;
+        CreatureState *creatureStates = (side == 0) ? state.playerTeam : state.opponentTeam;
+        for (int i = 0; i < team.size(); ++i)
+        {
+            Creature *creature = team[i];
+            if (!creature) continue;
+            creature->exportState(creatureStates[i]); // 回合效果槽随精灵状态一起按值拷贝
+        }
+    }
+
+    state.pendingActionCount = static_cast<quint8>(m_actionQueue.size());
+    for (int i = 0; i < m_actionQueue.size(); ++i)
+    {
+        const ActionQueueItem &item = m_actionQueue[i];
+        PendingActionState &pending = state.pendingActions[i];
+        locateCreature(item.actor, pending.side, pending.actorIndex);
+        pending.action = static_cast<quint8>(item.action);
+        pending.param1 = static_cast<qint16>(item.param1);
+        pending.param2 = static_cast<qint16>(item.param2);
+        pending.priority = static_cast<qint16>(item.priority);
+    }
+    return true;
+}
+
+void BattleSystem::recordTurnSnapshot()
+{
+    TurnSnapshot &snapshot = m_history.push();
+    snapshot.turn = m_currentTurn;
+    snapshot.activeIndex[0] = static_cast<qint8>(m_playerActiveIndex);
+    snapshot.activeIndex[1] = static_cast<qint8>(m_opponentActiveIndex);
+    for (int side = 0; side < 2; ++side)
+    {
+        const QVector<Creature *> &team = (side == 0) ? m_playerTeam : m_opponentTeam;
+        const int size = qMin(static_cast<int>(team.size()), BATTLE_STATE_MAX_TEAM_SIZE);
+        snapshot.teamSize[side] = static_cast<quint8>(size);
+        for (int i = 0; i < size; ++i)
+        {
+            if (team[i]) team[i]->exportState(snapshot.creatures[side][i]);
+        }
+    }
+}
+
+bool BattleSystem::rewindToTurn(int turn)
+{
+    const TurnSnapshot *snapshot = m_history.findTurn(turn);
+    if (!snapshot) return false;
+
+    CreatureState state;
+    for (int side = 0; side < 2; ++side)
+    {
+        const QVector<Creature *> &team = (side == 0) ? m_playerTeam : m_opponentTeam;
+        const int size = qMin(static_cast<int>(team.size()), static_cast<int>(snapshot->teamSize[side]));
+        for (int i = 0; i < size; ++i)
+        {
+            Creature *creature = team[i];
+            if (!creature) continue;
+            // 只回退场上状态，保留当前的种类私有状态（如时间悖论自身的计时）
+            const CreatureState &recorded = snapshot->creatures[side][i];
+            creature->exportState(state);
+            state.currentHP = recorded.currentHP;
+            state.currentPP = recorded.currentPP;
+            std::memcpy(state.statStages, recorded.statStages, sizeof(state.statStages));
+            state.statusCondition = recorded.statusCondition;
+            creature->importState(state);
+        }
+    }
+    return true;
+}
+
+quint64 BattleSystem::computeStateHash() const
+{
+    quint64 hash = mixStateHash(0, static_cast<quint64>(m_currentTurn));
+    hash = mixStateHash(hash, static_cast<quint64>(m_battleResult));
+    hash = mixStateHash(hash, (static_cast<quint64>(m_playerActiveIndex & 0xFF) << 8) | (m_opponentActiveIndex & 0xFF));
+
+    quint64 randomState[4];
+    m_random.getState(randomState);
+    for (quint64 word : randomState) hash = mixStateHash(hash, word);
+
+    CreatureState creatureState;
+    for (int side = 0; side < 2; ++side)
+    {
+        const QVector<Creature *> &team = (side == 0) ? m_playerTeam : m_opponentTeam;
+        hash = mixStateHash(hash, static_cast<quint64>(team.size()));
+        for (Creature *creature : team)
+        {
+            if (!creature) continue;
+            creature->exportState(creatureState);
+            hash = mixStateHash(hash, (static_cast<quint64>(static_cast<quint32>(creatureState.currentHP)) << 32) |
+                                          static_cast<quint32>(creatureState.currentPP));
+            quint64 stages = creatureState.statusCondition;
+            for (qint8 stage : creatureState.statStages) stages = (stages << 8) | static_cast<quint8>(stage);
+            hash = mixStateHash(hash, stages);
+            for (qint32 word : creatureState.speciesState) hash = mixStateHash(hash, static_cast<quint32>(word));
+
+            hash = mixStateHash(hash, creatureState.effectCount);
+            for (int e = 0; e < creatureState.effectCount; ++e)
+            {
+                const TurnEffectSlot &effect = creatureState.effects[e];
+                hash = mixStateHash(hash, (static_cast<quint64>(effect.kind) << 56) |
+                                              (static_cast<quint64>(effect.flags) << 48) |
+                                              (static_cast<quint64>(static_cast<quint16>(effect.param)) << 32) |
+                                              (static_cast<quint64>(static_cast<quint8>(effect.sourceSide)) << 24) |
+                                              (static_cast<quint64>(static_cast<quint8>(effect.sourceIndex)) << 16) |
+                                              static_cast<quint16>(effect.duration));
+            }
+        }
+    }
+
+    for (const ActionQueueItem &item : m_actionQueue)
+    {
+        qint8 side = -1;
+        qint8 index = -1;
+        locateCreature(item.actor, side, index);
+        hash = mixStateHash(hash, (static_cast<quint64>(static_cast<quint8>(side)) << 56) |
+                                      (static_cast<quint64>(static_cast<quint8>(index)) << 48) |
+                                      (static_cast<quint64>(item.action) << 40) |
+                                      (static_cast<quint64>(static_cast<quint16>(item.param1)) << 24) |
+                                      (static_cast<quint64>(static_cast<quint16>(item.param2)) << 8));
+    }
+    return hash;
+}
+
+bool BattleSystem::importState(const BattleState &state)
+{
+    if (state.playerTeamSize != m_playerTeam.size() || state.opponentTeamSize != m_opponentTeam.size())
+    {
+        return false; // 快照不属于当前这场战斗
+    }
+
+    m_currentTurn = state.currentTurn;
+    m_playerActiveIndex = state.playerActiveIndex;
+    m_opponentActiveIndex = state.opponentActiveIndex;
+    m_battleResult = static_cast<BattleResult>(state.battleResult);
+    m_playerActionSubmittedThisTurn = state.playerActionSubmitted != 0;
+    m_opponentActionSubmittedThisTurn = state.opponentActionSubmitted != 0;
+    m_random.setState(state.randomState);
+
+    for (int side = 0; side < 2; ++side)
+    {
+        const QVector<Creature *> &team = (side == 0) ? m_playerTeam : m_opponentTeam;
+        const CreatureState *creatureStates = (side == 0) ? state.playerTeam : state.opponentTeam;
+        for (int i = 0; i < team.size(); ++i)
+        {
+            Creature *creature = team[i];
+            if (!creature) continue;
+            creature->importState(creatureStates[i]); // 包括回合效果槽
+        }
+    }
+
+    m_actionQueue.clear();
+    for (int i = 0; i < state.pendingActionCount; ++i)
+    {
+        const PendingActionState &pending = state.pendingActions[i];
+        ActionQueueItem item;
+        item.actor = creatureAt(pending.side, pending.actorIndex);
+        item.action = static_cast<BattleAction>(pending.action);
+        item.param1 = pending.param1;
+        item.param2 = pending.param2;
+        item.priority = pending.priority;
+        m_actionQueue.append(item);
+    }
+    return true;
+}
+
 void BattleSystem::restoreCreaturesAfterBattle()
 {
     // 恢复玩家队伍中所有精灵
@@ -873,5 +1647,5 @@ void BattleSystem::restoreCreaturesAfterBattle()
     }
 
     // 记录恢复日志
-    addBattleLog("所有精灵的状态已恢复。");
+    addBattleEvent(BattleEventKind::CREATURES_RESTORED);
 }
\ No newline at end of file
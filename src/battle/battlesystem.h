@@ -4,8 +4,18 @@
 #include <QObject>
 #include <QVector>
 #include <QPair>
-#include <QTimer> 
+#include <QPointer>
+#include <QThread>
+#include <QStringList>
+#include <memory>
+#include <vector>
 #include "../core/creature.h"
+#include "battlerandom.h"
+#include "battlestate.h"
+#include "battlehistory.h"
+#include "battleevent.h"
+#include "battlelogsink.h"
+#include "battleobserver.h"
 
 // 战斗操作枚举
 enum class BattleAction
@@ -27,15 +37,86 @@ enum class BattleResult
     ESCAPE        // 逃跑成功
 };
 
-// 战斗日志条目结构
-struct BattleLogEntry
+// 回合结算模式
+enum class TurnResolutionMode
 {
-    QString message;        // 日志消息
-    int turn;               // 回合数
-    QString sourceCreature; // 源精灵名称
-    QString targetCreature; // 目标精灵名称
+    INTERACTIVE, // 交互模式：人机对战时AI决策由表现层（BattleScene）在演出延迟后调用decideAIAction
+    SYNCHRONOUS, // 同步模式：玩家提交后AI立即决策并内联结算回合，无需事件循环（用于批量模拟）
+    EXTERNAL     // 外部驱动：双方行动都由调用方提交，AI不会自动决策（用于回放）
 };
 
+// 一方在一个回合内的行动选择
+struct BattleMove
+{
+    BattleAction action; // 行动类型
+    int param;           // 技能下标(-1为第五技能)或换上的精灵下标
+};
+
+// 伤害与命中判定的常量
+const int CRITICAL_HIT_PERCENT = 6; // 暴击率(%)
+const double CRITICAL_HIT_MULTIPLIER = 1.8;
+const int DAMAGE_ROLL_MIN = 85;     // 伤害随机浮动下限(%)
+const int DAMAGE_ROLL_MAX = 100;    // 伤害随机浮动上限(%)
+
+const int DAMAGE_ROLL_COUNT = DAMAGE_ROLL_MAX - DAMAGE_ROLL_MIN + 1; // 16档
+
+// 一次技能使用的完整伤害分布，不消耗随机数
+// 按当前双方的能力、能力等级与HP计算；伤害表覆盖暴击与否 × 16档浮动的全部组合
+struct DamageDistribution
+{
+    bool isAttack = false;            // 非攻击技能时其余字段无意义
+    double hitProbability = 0.0;      // 技能自身与战斗系统的命中判定都通过的概率
+    double criticalProbability = 0.0; // 命中后暴击的概率（必定暴击时为1）
+    double stabMultiplier = 1.0;      // 属性一致加成
+    double typeEffectiveness = 1.0;   // 属性相性
+    int minHits = 1;                  // 多段技能的段数范围（现行规则每次使用只结算一段伤害）
+    int maxHits = 1;
+    int damage[2][DAMAGE_ROLL_COUNT] = {}; // [是否暴击][浮动 DAMAGE_ROLL_MIN + i]
+    int minDamage = 0;                // 命中时的最小/最大伤害
+    int maxDamage = 0;
+    double expectedDamage = 0.0;      // 计入命中率的期望伤害
+    double koProbability = 0.0;       // 按防守方当前HP计算的击倒概率
+};
+
+// 强制的随机判定结果：AI搜索把命中/暴击/伤害浮动当作概率节点逐一枚举时使用
+struct ChanceOutcome
+{
+    bool hit = true;        // 是否命中（同时作用于技能自身与战斗系统的命中判定）
+    bool critical = false;  // 是否暴击
+    int damageRoll = DAMAGE_ROLL_MAX; // 伤害浮动(%)
+};
+
+// 对手AI使用的搜索算法
+enum class AISearchAlgorithm
+{
+    MCTS,           // 蒙特卡洛树搜索：按时间预算采样
+    EXPECTIMINIMAX  // 期望极小极大：限定深度，结果确定
+};
+
+// 对手AI配置
+// timeBudgetMs与maxIterations都不大于0时使用随机选招
+struct OpponentAIConfig
+{
+    AISearchAlgorithm algorithm = AISearchAlgorithm::MCTS;
+    int timeBudgetMs = 0;         // 每步思考时间（毫秒）
+    int maxIterations = 0;        // MCTS每个线程的迭代上限（0为不限，用于可复现的模拟）
+    int threadCount = 0;          // MCTS根并行线程数（0为使用全部核心）
+    int maxRolloutTurns = 30;     // MCTS随机模拟的最大回合数
+    double exploration = 1.4;     // MCTS的UCB1探索系数
+    int maxDepth = 2;             // 期望极小极大的最大搜索回合数（迭代加深，超时则用上一层的结果）
+    int damageRollBuckets = 2;    // 期望极小极大把16档伤害浮动合并成的概率分支数
+    int transpositionTableBits = 16; // 置换表大小为 2^bits 项
+
+    bool isSearchEnabled() const
+    {
+        return timeBudgetMs > 0 || maxIterations > 0 || (algorithm == AISearchAlgorithm::EXPECTIMINIMAX && maxDepth > 0);
+    }
+    // 按难度生成配置：0为随机选招，难度越高思考时间越长
+    static OpponentAIConfig forDifficulty(int difficulty);
+};
+
+class AISearch;
+
 // 战斗系统类
 class BattleSystem : public QObject
 {
@@ -51,6 +132,18 @@ public:
     int getCurrentTurn() const;
     bool isPvPBattle() const;
 
+    // 回合结算模式，默认为交互模式
+    void setTurnResolutionMode(TurnResolutionMode mode);
+    TurnResolutionMode getTurnResolutionMode() const;
+
+    // 本场战斗的随机数流，技能/效果/精灵的随机判定都通过它进行
+    // 在initBattle之前设置种子，即可逐位复现整场战斗
+    void setRandomSeed(quint64 seed);
+    quint64 getRandomSeed() const;
+    BattleRandom &getRandom();
+    // AI选招（随机选招、搜索种子）使用的随机流，由同一种子派生，不计入BattleState快照
+    BattleRandom &getAIRandom();
+
     Creature *getPlayerActiveCreature() const;
     Creature *getOpponentActiveCreature() const;
     QVector<Creature *> getPlayerTeam() const;
@@ -58,14 +151,52 @@ public:
 
     // 新的行动提交流程
     void playerSubmittedAction(BattleAction action, int param1 = -1, int param2 = -1);
-    // PvP模式下，你会有类似的 opponentSubmittedAction。对于PvE：
-    void decideAIAction(); // AI决定并提交其行动
+    // PvP模式或外部驱动（如模拟器、回放）直接提交对手行动
+    void opponentSubmittedAction(BattleAction action, int param1 = -1, int param2 = -1);
+    // 对于PvE：
+    void decideAIAction(); // AI决定并提交其行动（启用搜索时在交互模式下异步完成）
+    void setOpponentAIConfig(const OpponentAIConfig &config);
+    OpponentAIConfig getOpponentAIConfig() const;
+    bool isAISearchRunning() const;
 
     bool checkBattleEnd(); // 改为 public，方便外部潜在检查，但主要还是内部使用
-    QVector<BattleLogEntry> getBattleLog() const;
+    // 战斗观察者：战斗过程中的各类事件以虚函数回调的方式同步通知，不转移所有权
+    // 需要Qt信号时使用BattleSignalAdapter
+    void addObserver(BattleObserver *observer);
+    void removeObserver(BattleObserver *observer);
+    // 是否正在收集本回合结算的变化集（只在有观察者时收集），期间的事件稍后随onTurnChanges整体发布
+    bool isCollectingTurnChanges() const { return m_collectingTurnChanges; }
+
+    // 日志接收者：按级别使用内置接收者，默认为FULL；每场战斗可以不同
+    void setBattleLogLevel(BattleLogLevel level);
+    // 使用外部接收者（不转移所有权，initBattle不会重置它）；nullptr即空接收者
+    void setLogSink(BattleLogSink *sink);
+    BattleLogSink *getLogSink() const;
+    // 等同于setBattleLogLevel(FULL / NONE)（AI搜索中的模拟战斗关闭日志）
+    void setBattleLogEnabled(bool enabled);
+    bool isBattleLogEnabled() const { return m_logSink != nullptr; }
+
+    // 完整日志中的全部事件，按发生顺序（其他级别下为空）
+    const std::vector<BattleEvent> &getBattleEvents() const;
+    // 把完整日志中的事件格式化为日志文字；html为true时带颜色标签（战斗界面使用）
+    QString formatBattleEvent(const BattleEvent &event, bool html = true) const;
+    // 格式化后的完整战斗日志
+    QStringList getBattleLog(bool html = true) const;
 
     int calculateDamage(Creature *attacker, Creature *defender, Skill *skill);
     bool checkSkillHit(Creature *attacker, Creature *defender, Skill *skill);
+    // 不消耗随机数的确定性版本：给定暴击与伤害浮动(%)时的伤害
+    int calculateDamage(Creature *attacker, Creature *defender, Skill *skill, bool critical, int damageRoll) const;
+    // calculateDamage所有可能结果的分布，供AI估值、技能按钮提示与平衡性工具使用
+    DamageDistribution getDamageDistribution(Creature *attacker, Creature *defender, Skill *skill) const;
+    // checkSkillHit的命中率(%)，已计入命中/闪避等级；必中技能为100
+    int getSkillHitChance(Creature *attacker, Creature *defender, Skill *skill) const;
+
+    // 为一方当前出场精灵指定本回合的命中/暴击/伤害浮动结果，其余随机判定照常取自随机流
+    void setForcedChanceOutcome(bool forPlayer, const ChanceOutcome &outcome);
+    void clearForcedChanceOutcomes();
+    // attacker的命中结果是否被指定，未指定时返回nullptr
+    const ChanceOutcome *getForcedChanceOutcome(const Creature *attacker) const;
     
     // 触发战斗事件
     void triggerHealingReceived(Creature* creature, int amount);
@@ -73,9 +204,15 @@ public:
     void triggerStatusChanged(Creature* target, StatusCondition oldCondition, StatusCondition newCondition);
     void triggerStatStageChanged(Creature* target, StatType stat, int oldStage, int newStage);
     void triggerEffectApplied(Creature* source, Creature* target, Effect* effect, bool success);
-    void triggerTurnEffectApplied(Creature* source, Creature* target, TurnBasedEffect* effect);
+    void triggerTurnEffectApplied(Creature* source, Creature* target, const TurnEffectSlot& effect);
     void triggerEffectCleared(Creature* target, const QString& effectType);
     void triggerStatusBlockedByImmunity(Creature* target, StatusCondition condition);
+    // 记录一条事件；source/target不在本场战斗中时记为无。空接收者时只有一次指针判断
+    void addBattleEvent(BattleEventKind kind, Creature *source = nullptr, Creature *target = nullptr, int amount = 0, int value = 0)
+    {
+        if (m_logSink) recordEvent(kind, source, target, amount, value);
+    }
+    // 记录一条自由文本（没有对应事件类型的少见消息）
     void addBattleLog(const QString &message, Creature *source = nullptr, Creature *target = nullptr);
 
     QString getStatusConditionName(StatusCondition condition) const;
@@ -84,32 +221,49 @@ public:
     // 战斗结束恢复战斗前的精灵状态
     void restoreCreaturesAfterBattle();
 
+    // 扁平状态快照：导出/导入整场战斗的可变状态（不含战斗日志）
+    // 队伍超出BattleState容量时导出失败返回false
+    bool exportState(BattleState &state) const;
+    bool importState(const BattleState &state);
+    // 精灵与(阵营0玩家/1对手, 队伍下标)互相转换，回合效果记录施加者时使用
+    bool locateCreature(const Creature *creature, qint8 &side, qint8 &index) const;
+    Creature *creatureAt(int side, int index) const;
 
-public slots:
+    // 逐回合状态哈希（锁步校验）：每次回合结算结束时对整场战斗的可变状态计算64位哈希，
+    // 两端或回放器逐回合比较即可找出第一个出现分歧的回合。
+    // 只取决于状态本身（不含指针等与进程相关的值），不同机器上相同状态的哈希相同
+    quint64 computeStateHash() const;
+    // 本场战斗已结算回合的哈希，下标i对应第i+1回合
+    const std::vector<quint64> &getTurnHashes() const { return m_turnHashes; }
+    // 默认开启；AI搜索中的镜像战斗关闭以节省开销
+    void setStateHashEnabled(bool enabled) { m_stateHashEnabled = enabled; }
+
+    // 最近几回合结束时的场上快照（开战时记为第0回合）
+    const BattleHistory &getHistory() const { return m_history; }
+    // 把双方所有精灵的HP/PP/能力等级/异常状态恢复到第turn回合结束时；
+    // 出场精灵、随机数流、回合数与种类私有状态不变。快照已不在缓冲中时返回false
+    bool rewindToTurn(int turn);
 
-signals:
-    void battleStarted();
-    void battleEnded(BattleResult result);
-    void turnStarted(int turn, bool isPlayerTurn); 
-    void turnEnded(int turn); // 表示一个完整回合（双方行动后）的结束
-    void skillUsed(Creature *user, Creature *target, Skill *skill, bool hit, int damage);
-    void damageCaused(Creature *creature, int damage);
-    void healingReceived(Creature *creature, int amount);
-    void statusChanged(Creature *creature, StatusCondition oldStatus, StatusCondition newStatus);
-    void statStageChanged(Creature *creature, StatType stat, int oldStage, int newStage);
-    void creatureSwitched(Creature *oldCreature, Creature *newCreature, bool isPlayer);
-    void battleLogUpdated(const QString &message);
-    void playerActionConfirmed();   // 玩家已提交本回合行动
-    void opponentActionConfirmed(); // 对手/AI已提交本回合行动
 
 private:
+    friend class BattleBenchAccess; // 基准工具（src/tools/shanhaibench.cpp）直接测量行动排序与回合结算
+
     BattleResult m_battleResult;
     int m_currentTurn;
     bool m_isPvP;
+    TurnResolutionMode m_turnResolutionMode;
+    BattleRandom m_random;
+    BattleRandom m_aiRandom;
+    OpponentAIConfig m_aiConfig;
+    std::shared_ptr<AISearch> m_aiSearch;     // 正在进行的异步搜索
+    QPointer<QThread> m_aiSearchThread;
+    int m_battleGeneration;                   // 每次initBattle自增，丢弃过期的搜索结果
     QVector<Creature *> m_playerTeam;
     QVector<Creature *> m_opponentTeam;
     int m_playerActiveIndex;
     int m_opponentActiveIndex;
+    ChanceOutcome m_forcedChance[2];          // 0玩家 1对手
+    bool m_chanceForced[2];
 
     struct ActionQueueItem {
         Creature *actor;
@@ -119,7 +273,35 @@ private:
         int priority;
     };
     QVector<ActionQueueItem> m_actionQueue;
-    QVector<BattleLogEntry> m_battleLog;
+    FullLogSink m_fullLog;                        // 内置的完整日志
+    std::unique_ptr<BattleLogSink> m_levelSink;   // COMPACT/COUNTERS级别时创建的接收者
+    BattleLogSink *m_logSink;                     // 当前接收者，nullptr为空接收者
+    QVector<BattleObserver *> m_observers;
+    BattleTurnChanges m_turnChanges;          // 本回合结算的变化集，数组容量跨回合复用
+    CreatureState m_turnStartStates[2][BATTLE_STATE_MAX_TEAM_SIZE]; // 结算前的精灵状态
+    bool m_collectingTurnChanges;
+    std::vector<quint64> m_turnHashes;
+    bool m_stateHashEnabled;
+    BattleHistory m_history;
+    void recordTurnSnapshot();
+
+    // 依次调用各观察者的回调；遍历的是副本，回调中增删观察者不影响本次通知
+    template <typename Callback, typename... Args>
+    void notifyObservers(Callback callback, const Args &... args)
+    {
+        if (m_observers.isEmpty()) return;
+        const QVector<BattleObserver *> observers = m_observers;
+        for (BattleObserver *observer : observers) (observer->*callback)(args...);
+    }
+
+    // 填好事件的公共字段（回合、来源、目标），其余字段由调用方设置后交给appendEvent
+    BattleEvent makeEvent(BattleEventKind kind, const Creature *source = nullptr, const Creature *target = nullptr) const;
+    void appendEvent(const BattleEvent &event);
+    void recordEvent(BattleEventKind kind, Creature *source, Creature *target, int amount, int value);
+    void addSkillEvent(BattleEventKind kind, Creature *actor, int skillIndex, Creature *target = nullptr, int amount = 0);
+
+    // 伤害公式中随机浮动之前的部分（含属性一致、相性与暴击）
+    int calculateDamageBeforeRoll(Creature *attacker, Creature *defender, Skill *skill, bool critical) const;
 
     //回合流程控制
     bool m_playerActionSubmittedThisTurn;
@@ -134,9 +316,15 @@ private:
     void processTurnEndEffects();
 
     //回合处理方法
+    void decideRandomAIAction();      // 随机选择可用技能
+    void submitAIMove(const BattleMove &move);
+    void cancelAISearch();
     void tryProcessTurnActions();     // 检查是否双方都已行动，如果是则开始结算
     void processTurnInputPhase();     // 设置进入行动输入阶段
     void processTurnExecutePhase();   // 执行已提交的行动并结束当前回合的结算
+    void resolveTurn();               // 结算回合开始效果、行动队列与回合结束效果
+    void beginTurnChanges();          // 记录结算前的状态，开始收集变化集
+    void publishTurnChanges();        // 计算状态差异并通知观察者
 
 };
 
@@ -0,0 +1,55 @@
+// src/battle/battleturnchanges.h
+#ifndef BATTLETURNCHANGES_H
+#define BATTLETURNCHANGES_H
+
+#include <vector>
+#include "battleevent.h"
+
+// 一个回合结算（双方行动 + 回合开始/结束效果）的变化集
+// BattleSystem在结算结束后一次性发布：结算中产生的全部事件按顺序排列，
+// 再附上结算前后各精灵显示相关字段的差异。界面据此一次性刷新控件，
+// 并按事件顺序安排动画，而不必在每条事件上各自刷新。
+
+// CreatureTurnChange::fields 的标记
+const quint8 TURN_CHANGE_HP = 0x01;
+const quint8 TURN_CHANGE_PP = 0x02;
+const quint8 TURN_CHANGE_STATUS = 0x04;
+const quint8 TURN_CHANGE_STAT_STAGES = 0x08;
+
+// 一只精灵在本回合中的变化（只记录发生了变化的精灵）
+struct CreatureTurnChange
+{
+    qint8 side;  // 0玩家 1对手
+    qint8 index; // 在队伍中的下标
+    quint8 fields; // TURN_CHANGE_* 标记
+    quint8 statusBefore; // StatusCondition
+    quint8 statusAfter;
+    qint32 hpBefore;
+    qint32 hpAfter;
+    qint32 ppBefore;
+    qint32 ppAfter;
+};
+
+struct BattleTurnChanges
+{
+    int turn = 0;
+    std::vector<BattleEvent> events;          // 结算中产生的事件，按发生顺序
+    std::vector<CreatureTurnChange> creatures; // 状态发生变化的精灵
+    qint8 activeBefore[2] = {-1, -1};         // 结算前双方出场精灵下标
+    qint8 activeAfter[2] = {-1, -1};          // 结算后双方出场精灵下标
+    quint8 result = 0;                        // 结算后的BattleResult
+    quint64 stateHash = 0;                    // 结算后的状态哈希（BattleSystem::computeStateHash）
+
+    bool isActiveChanged(int side) const { return activeBefore[side] != activeAfter[side]; }
+    // 某只精灵的变化，没有变化时返回nullptr
+    const CreatureTurnChange *findCreature(int side, int index) const
+    {
+        for (const CreatureTurnChange &change : creatures)
+        {
+            if (change.side == side && change.index == index) return &change;
+        }
+        return nullptr;
+    }
+};
+
+#endif // BATTLETURNCHANGES_H
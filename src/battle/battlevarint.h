@@ -0,0 +1,39 @@
+// src/battle/battlevarint.h
+#ifndef BATTLEVARINT_H
+#define BATTLEVARINT_H
+
+#include <QByteArray>
+
+// 紧凑日志与回放共用的变长整数编码：zigzag后每字节7位，最高位表示后面还有字节
+// 绝对值小于64的数只占一个字节
+
+inline void writeVarint(QByteArray &data, qint32 value)
+{
+    quint32 zigzag = (static_cast<quint32>(value) << 1) ^ static_cast<quint32>(value >> 31);
+    while (zigzag >= 0x80)
+    {
+        data.append(static_cast<char>((zigzag & 0x7F) | 0x80));
+        zigzag >>= 7;
+    }
+    data.append(static_cast<char>(zigzag));
+}
+
+// 从pos处读取一个变长整数并前移pos，数据不完整时返回false
+inline bool readVarint(const QByteArray &data, int &pos, qint32 &value)
+{
+    quint32 zigzag = 0;
+    for (int shift = 0; shift < 35; shift += 7)
+    {
+        if (pos >= data.size()) return false;
+        const quint8 byte = static_cast<quint8>(data[pos++]);
+        zigzag |= static_cast<quint32>(byte & 0x7F) << shift;
+        if (!(byte & 0x80))
+        {
+            value = static_cast<qint32>(zigzag >> 1) ^ -static_cast<qint32>(zigzag & 1);
+            return true;
+        }
+    }
+    return false;
+}
+
+#endif // BATTLEVARINT_H
@@ -2,7 +2,6 @@
 #include "effect.h"
 #include "../core/creature.h"     // 核心 - 精灵类
 #include "battlesystem.h"         // 战斗 - 战斗系统类
-#include <QRandomGenerator>       // Qt随机数生成器
 #include <QStringList>            // 用于构建描述文本
 #include "../core/type.h"         // <<--- 确保包含type.h (effect.h已包含，这里是防御性)
 
@@ -56,36 +55,23 @@ bool Effect::isTargetSelf() const
 }
 
 // 检查几率是否触发
-bool Effect::checkChance() const
+bool Effect::checkChance(BattleSystem *battle) const
 {
     // 中文注释：根据m_chance判断效果是否触发
     if (m_chance >= 100) return true; // 100%几率必定触发
     if (m_chance <= 0) return false;  // 0%几率必定不触发
-    return QRandomGenerator::global()->bounded(100) < m_chance; // 生成[0, 99]的随机数，与几率比较
+    BattleRandom &random = battle ? battle->getRandom() : BattleRandom::threadFallback();
+    return random.bounded(100) < m_chance; // 生成[0, 99]的随机数，与几率比较
 }
 
 
 // --- TurnBasedEffect 实现 ---
-TurnBasedEffect::TurnBasedEffect(int duration,
-                                 std::function<void(Creature*, Creature*, BattleSystem*, TurnBasedEffect* self)> effectFunc,
-                                 bool onTurnStart,
-                                 int chance)
-    : Effect(EffectType::TURN_BASED, chance),      // 调用基类构造
-      m_initialDuration(duration),                  // 记录初始持续回合
-      m_currentDuration(duration),                  // 当前剩余回合
-      m_effectLogic(effectFunc),                    // 存储效果逻辑函数
-      m_onTurnStart(onTurnStart),                   // 标记是在回合开始还是结束时执行
-      m_description(QString("一个持续%1回合的效果。").arg(duration)), // 默认描述
-      m_originalSource(nullptr)                     // 初始化效果来源为空
-{
-    // 中文注释：回合类效果构造函数
-    // duration: 效果持续回合数
-    // effectFunc: 每回合执行的具体逻辑 (lambda或函数指针)
-    // onTurnStart: true表示回合开始时执行逻辑，false表示回合结束时
-    // chance: 效果施加的成功率
-
-    // 确保持续时间不为负
-    if (m_currentDuration < 0) m_currentDuration = 0;
+TurnBasedEffect::TurnBasedEffect(TurnEffectKind kind, int duration, bool onTurnStart, int chance)
+    : Effect(EffectType::TURN_BASED, chance), // 调用基类构造
+      m_kind(kind),                           // 效果种类，决定每回合的行为
+      m_duration(qMax(0, duration)),          // 持续回合数，确保不为负
+      m_onTurnStart(onTurnStart)              // 标记是在回合开始还是结束时执行
+{
 }
 
 bool TurnBasedEffect::apply(Creature* source, Creature* target, BattleSystem* battle)
@@ -93,26 +79,26 @@ bool TurnBasedEffect::apply(Creature* source, Creature* target, BattleSystem* ba
     // 中文注释：应用回合类效果
     // 1. 检查触发几率
     // 2. 确定实际目标 (自身或对方)
-    // 3. 创建效果的副本并添加到目标的持续效果列表中
-    // 4. 记录效果来源
+    // 3. 向目标的回合效果槽写入一条记录，施加者以(阵营, 下标)记录
 
-    if (!checkChance()) return false; // 未达到触发几率
+    if (!checkChance(battle)) return false; // 未达到触发几率
 
     Creature* actualTarget = m_targetSelf ? source : target; // 判断效果的实际目标
-    if (!actualTarget) {
-        // qWarning() << "TurnBasedEffect::apply: Actual target is null.";
-        return false;
-    }
+    if (!actualTarget) return false;
 
-    // 创建此效果的一个新实例（副本）并添加到目标的列表中
-    // 确保每个施加的效果都是独立的，有自己的持续时间等状态
-    TurnBasedEffect* effectInstance = new TurnBasedEffect(*this); // 使用拷贝构造函数创建副本
-    effectInstance->setOriginalSource(source); // 记录是谁施加了这个效果的实例
+    TurnEffectSlot effect;
+    effect.kind = m_kind;
+    effect.flags = m_onTurnStart ? TURN_EFFECT_ON_TURN_START : 0;
+    effect.duration = static_cast<qint16>(m_duration);
+    effect.sourceSide = -1;
+    effect.sourceIndex = -1;
+    effect.param = 0;
+    if (battle) battle->locateCreature(source, effect.sourceSide, effect.sourceIndex);
 
-    actualTarget->addTurnEffect(effectInstance); // 将新创建的实例添加到目标
+    if (!actualTarget->addTurnEffect(effect)) return false; // 效果槽已满（重复施加只刷新持续回合）
 
     if (battle) {
-        battle->triggerTurnEffectApplied(source, actualTarget, effectInstance);
+        battle->triggerTurnEffectApplied(source, actualTarget, effect);
     }
     return true;
 }
@@ -120,43 +106,91 @@ bool TurnBasedEffect::apply(Creature* source, Creature* target, BattleSystem* ba
 QString TurnBasedEffect::getDescription() const
 {
     // 中文注释：获取回合类效果的描述文本
-    return m_description.isEmpty() ? QString("持续 %1 回合的效果").arg(m_initialDuration) : m_description;
+    TurnEffectSlot effect = {m_kind, 0, static_cast<qint16>(m_duration), -1, -1, 0};
+    return getTurnEffectDescription(effect);
 }
 
-int TurnBasedEffect::getDuration() const
+void executeTurnEffect(const TurnEffectSlot &effect, Creature *affected, BattleSystem *battle)
 {
-    // 中文注释：获取当前剩余的持续回合数
-    return m_currentDuration;
-}
-
-void TurnBasedEffect::setDuration(int duration) {
-    // 中文注释：设置当前剩余的持续回合数
-    m_currentDuration = duration;
-    if (m_currentDuration < 0) m_currentDuration = 0;
-}
-
+    if (!affected || !battle) return;
 
-bool TurnBasedEffect::decrementDuration()
-{
-    // 中文注释：将效果的持续时间减少1回合
-    // 如果持续时间减至0或以下，返回true表示效果已结束
-    if (m_currentDuration > 0)
+    switch (effect.kind)
+    {
+    case TurnEffectKind::SPEED_DOWN:
+    {
+        if (affected->isDead()) return;
+        int oldSpeedStage = affected->getStatStages().getStage(StatType::SPEED);
+        affected->modifyStatStage(StatType::SPEED, -1);
+        battle->triggerStatStageChanged(affected, StatType::SPEED, oldSpeedStage,
+                                        affected->getStatStages().getStage(StatType::SPEED));
+        break;
+    }
+    case TurnEffectKind::LIFE_SIPHON:
     {
-        m_currentDuration--;
+        // 效果附着在使用者身上，伤害对面的出场精灵
+        Creature *opponent = battle->getOpponentActiveCreature() == affected ?
+                             battle->getPlayerActiveCreature() :
+                             battle->getOpponentActiveCreature();
+        if (opponent && !opponent->isDead() &&
+            opponent->getType().getPrimaryType() != ElementType::GRASS &&
+            opponent->getType().getSecondaryType() != ElementType::GRASS) // 只对非草系精灵造成伤害
+        {
+            int damage = opponent->getMaxHP() / 16;
+            opponent->takeDamage(damage);
+            battle->triggerDamageCaused(opponent, damage, StatusCondition::NONE); // 使用NONE表示非状态伤害
+        }
+        // 回复使用者生命值
+        if (!affected->isDead()) {
+            int healAmount = affected->getMaxHP() / 8;
+            affected->heal(healAmount);
+            battle->triggerHealingReceived(affected, healAmount);
+        }
+        break;
+    }
+    case TurnEffectKind::LEECH_SEED:
+    {
+        Creature *source = battle->creatureAt(effect.sourceSide, effect.sourceIndex);
+        if (!source || affected->isDead() || battle->getBattleResult() != BattleResult::ONGOING) return;
+
+        int leechAmount = affected->getMaxHP() / 8;
+        affected->takeDamage(leechAmount);
+        battle->triggerDamageCaused(affected, leechAmount);
+        if (battle->getBattleResult() != BattleResult::ONGOING) return;
+
+        // 只有当施加者存活时才回复
+        if (!source->isDead()) {
+            source->heal(leechAmount);
+            if (battle->getBattleResult() != BattleResult::ONGOING) return;
+            battle->triggerHealingReceived(source, leechAmount);
+        }
+        break;
+    }
+    default:
+        break; // 免疫等标记类效果没有每回合的行为，由BattleSystem在相关检查点查询
     }
-    return m_currentDuration <= 0;
 }
 
-void TurnBasedEffect::executeTurnLogic(Creature* affectedCreature, Creature* sourceCreature, BattleSystem* battle)
+QString getTurnEffectDescription(const TurnEffectSlot &effect)
 {
-    if (!affectedCreature) return;
-    
-    // 执行效果逻辑
-    if (m_effectLogic) {
-        m_effectLogic(affectedCreature, sourceCreature, battle, this);
+    switch (effect.kind)
+    {
+    case TurnEffectKind::SPEED_DOWN:  return "空域压制：速度下降";
+    case TurnEffectKind::LIFE_SIPHON: return "生命汲取领域激活中";
+    case TurnEffectKind::LEECH_SEED:  return "寄生种子效果";
+    case TurnEffectKind::TIME_HOP:    return "时光跳跃免疫";
+    case TurnEffectKind::IMMUNITY:
+    {
+        QStringList immunities;
+        if (effect.flags & TURN_EFFECT_IMMUNE_TO_STATUS) immunities.append("异常状态");
+        const ElementType immuneType = static_cast<ElementType>(effect.param);
+        if (immuneType != ElementType::NONE) {
+            immunities.append(QString("对%1属性伤害").arg(Type::getElementTypeName(immuneType)));
+        }
+        return immunities.isEmpty() ? QString("通用免疫") : QString("免疫%1").arg(immunities.join("和"));
+    }
+    default:
+        return QString("持续 %1 回合的效果").arg(effect.duration);
     }
-    
-    // 效果逻辑内部应该自己处理伤害和日志，不在这里重复触发
 }
 
 
@@ -184,7 +218,7 @@ bool StatusConditionEffect::apply(Creature* source, Creature* target, BattleSyst
     // 3. 检查目标是否已处于该状态或免疫
     // 4. 施加状态并通知战斗系统
 
-    if (!checkChance()) return false; // 未达到触发几率
+    if (!checkChance(battle)) return false; // 未达到触发几率
 
     Creature* actualTarget = m_targetSelf ? source : target; // 确定效果的实际目标
     if (!actualTarget || !battle) {
@@ -194,7 +228,8 @@ bool StatusConditionEffect::apply(Creature* source, Creature* target, BattleSyst
 
     // 检查目标是否已经有相同的异常状态
     if (actualTarget->getStatusCondition() == m_condition && m_condition != StatusCondition::NONE) {
-        battle->addBattleLog(QString("%1 已经处于 %2 状态了。").arg(actualTarget->getName()).arg(getDescription()));
+        if (battle->isBattleLogEnabled()) // 关闭日志时不必拼接文本
+            battle->addBattleLog(QString("%1 已经处于 %2 状态了。").arg(actualTarget->getName()).arg(getDescription()));
         return false; // 目标已处于该状态，效果应用失败
     }
 
@@ -265,7 +300,7 @@ bool StatChangeEffect::apply(Creature* source, Creature* target, BattleSystem* b
     // 3. 修改目标的能力等级，并处理边界情况（如已达上限/下限）
     // 4. 通知战斗系统
 
-    if (!checkChance()) return false; // 未达到触发几率
+    if (!checkChance(battle)) return false; // 未达到触发几率
 
     Creature* actualTarget = m_targetSelf ? source : target; // 确定效果的实际目标
     if (!actualTarget || !battle) {
@@ -281,9 +316,11 @@ bool StatChangeEffect::apply(Creature* source, Creature* target, BattleSystem* b
         battle->triggerStatStageChanged(actualTarget, m_stat, oldStage, newStage);
         return true;
     } else {
-        battle->addBattleLog(QString("%1 的 %2 已经不能再%3了。").arg(actualTarget->getName())
-                            .arg(battle->getStatTypeName(m_stat))
-                            .arg(m_stages > 0 ? "提高" : "降低"));
+        if (battle->isBattleLogEnabled()) {
+            battle->addBattleLog(QString("%1 的 %2 已经不能再%3了。").arg(actualTarget->getName())
+                                .arg(battle->getStatTypeName(m_stat))
+                                .arg(m_stages > 0 ? "提高" : "降低"));
+        }
         return false;
     }
 }
@@ -327,7 +364,7 @@ ClearEffectsEffect::ClearEffectsEffect(bool clearPositiveStatChanges, bool clear
 bool ClearEffectsEffect::apply(Creature* source, Creature* target, BattleSystem* battle)
 {
     // 中文注释：应用清除效果
-    if (!checkChance()) return false; // 检查触发几率
+    if (!checkChance(battle)) return false; // 检查触发几率
 
     Creature* actualTarget = m_targetSelf ? source : target; // 确定实际目标
     if (!actualTarget || !battle) return false;
@@ -364,7 +401,7 @@ bool ClearEffectsEffect::apply(Creature* source, Creature* target, BattleSystem*
     }
 
     // 清除所有回合类效果
-    if (m_clearTurnBasedEffects && !actualTarget->getTurnEffects().isEmpty()) {
+    if (m_clearTurnBasedEffects && actualTarget->getTurnEffectCount() > 0) {
         actualTarget->clearAllTurnEffects();
         // battle->addBattleLog(QString("%1 的所有回合类效果被清除了!").arg(actualTarget->getName()));
         somethingWasCleared = true;
@@ -406,32 +443,22 @@ ImmunityEffect::ImmunityEffect(int duration, bool immuneToStatus, ElementType im
 bool ImmunityEffect::apply(Creature* source, Creature* target, BattleSystem* battle)
 {
     // 中文注释：应用免疫效果
-    // 免疫效果是通过给目标添加一个特殊的TurnBasedEffect来实现的。
+    // 免疫效果是给目标添加一条免疫标记的回合效果，本身没有每回合的行为。
     // BattleSystem在进行伤害计算或状态施加前，会检查目标是否拥有此类“免疫标记”效果。
 
-    if (!checkChance()) return false; // 检查触发几率
+    if (!checkChance(battle)) return false; // 检查触发几率
 
     Creature* actualTarget = m_targetSelf ? source : target; // 确定实际目标
     if (!actualTarget || !battle) return false;
 
-    // 创建一个代表此免疫状态的TurnBasedEffect
-    // 这个TurnBasedEffect主要起标记作用，其具体免疫逻辑由BattleSystem在相关检查点实现
-    QString desc = getDescription(); // 获取此免疫效果的完整描述
-    auto immunityLogic = [desc](Creature* affected, Creature* src_unused, BattleSystem* btl_unused, TurnBasedEffect* self_effect_unused) {
-        // 这个lambda在每回合可以为空，或者仅用于日志记录
-        // 主要的免疫判断在BattleSystem中进行，通过检查精灵是否携带此类型的TurnBasedEffect
-        // (例如，通过TurnBasedEffect的特定描述或一个专门的标志位来识别免疫效果)
-        // btl->addBattleLog(QString("%1 仍处于 '%2' 状态。").arg(affected->getName()).arg(desc));
-    };
+    TurnEffectSlot immunityMarker;
+    immunityMarker.kind = TurnEffectKind::IMMUNITY;
+    immunityMarker.flags = m_immuneToStatus ? TURN_EFFECT_IMMUNE_TO_STATUS : 0;
+    immunityMarker.duration = static_cast<qint16>(m_duration); // 持续m_duration回合
+    immunityMarker.param = static_cast<qint16>(m_immuneToTypeDamage);
+    battle->locateCreature(source, immunityMarker.sourceSide, immunityMarker.sourceIndex); // 记录效果来源
 
-    TurnBasedEffect* immunityMarkerEffect = new TurnBasedEffect(m_duration, immunityLogic, false, 100); // 持续m_duration回合
-    immunityMarkerEffect->setDescription(desc);                       // 设置描述，方便识别
-    immunityMarkerEffect->setOriginalSource(source);                  // 记录效果来源
-
-    actualTarget->addTurnEffect(immunityMarkerEffect); // 将免疫标记效果添加到目标
-
-    // battle->addBattleLog(QString("%1 获得了 \"%2\"!").arg(actualTarget->getName()).arg(desc));
-    return true;
+    return actualTarget->addTurnEffect(immunityMarker); // 将免疫标记添加到目标，槽位已满时失败
 }
 
 QString ImmunityEffect::getDescription() const
@@ -467,7 +494,7 @@ HealingEffect::HealingEffect(int amount, bool isPercentage, int chance)
 bool HealingEffect::apply(Creature* source, Creature* target, BattleSystem* battle)
 {
     // 中文注释：应用治疗效果
-    if (!checkChance()) return false; // 检查触发几率
+    if (!checkChance(battle)) return false; // 检查触发几率
 
     Creature* actualTarget = m_targetSelf ? source : target; // 确定实际治疗目标
     if (!actualTarget || !battle) return false;
@@ -509,7 +536,7 @@ FixedDamageEffect::FixedDamageEffect(int damageAmount, int chance)
 bool FixedDamageEffect::apply(Creature* source, Creature* target, BattleSystem* battle)
 {
     // 应用固定伤害效果
-    if (!checkChance()) return false; // 检查触发几率
+    if (!checkChance(battle)) return false; // 检查触发几率
 
     Creature* actualTarget = m_targetSelf ? source : target; // 确定实际目标
     if (!actualTarget || !battle) return false;
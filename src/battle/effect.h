@@ -3,10 +3,9 @@
 #define EFFECT_H
 
 #include <QString>
-#include <functional>        // 用于std::function，实现可回调的效果逻辑
 #include "../core/ability.h" // 核心 - 能力系统 (StatType, StatusCondition)
 #include "../core/type.h"    // 核心 - 类型系统 (ElementType)
-#include <QVariant>          // 用于在std::function中传递通用数据
+#include "battlestate.h"     // 战斗 - 回合效果记录 (TurnEffectSlot)
 
 // 前向声明
 class Creature;     // 精灵类
@@ -65,7 +64,7 @@ public:
     // (一些效果可能固定目标，一些可能由技能设定)
     void setTargetSelf(bool self);
     bool isTargetSelf() const;
-    bool publicCheckChance() const { return checkChance(); }
+    bool publicCheckChance(BattleSystem *battle) const { return checkChance(battle); }
     Creature* determineActualTarget(Creature* source, Creature* defaultTarget, BattleSystem* battle) const {
         if (isTargetSelf()) {
             return source; // 如果效果作用于自身，返回源精灵
@@ -79,59 +78,45 @@ protected:
     int m_chance;      // 效果触发的基础几率 (0-100)
     bool m_targetSelf; // 效果是否作用于使用者自身 (默认为false，作用于对方)
 
-    // 辅助函数：根据m_chance检查几率是否触发
-    bool checkChance() const;
+    // 辅助函数：根据m_chance检查几率是否触发（使用battle的随机数流）
+    bool checkChance(BattleSystem *battle) const;
 };
 
 // --- 具体效果类 ---
 
-// 回合类效果 (例如：中毒每回合扣血，能力提升持续数回合)
+// 回合类效果 (例如：每回合吸取HP，持续数回合的能力下降)
+// 技能上保存的只是模板：施加时向目标写入一条定长的TurnEffectSlot记录，不复制效果对象；
+// 每回合的行为由 executeTurnEffect 按效果种类分派
 class TurnBasedEffect : public Effect
 {
 public:
+    // kind: 效果种类
     // duration: 效果持续的回合数
-    // effectFunc: 在每回合特定阶段（如开始或结束）执行的逻辑
     // onTurnStart: true则在回合开始时触发，false则在回合结束时触发
-    TurnBasedEffect(int duration,
-                    std::function<void(Creature *affectedCreature, Creature *sourceCreature, BattleSystem *battle, TurnBasedEffect *self)> effectFunc,
-                    bool onTurnStart = false, // true则在回合开始时触发，false则在回合结束时触发
-                    int chance = 100);
+    TurnBasedEffect(TurnEffectKind kind, int duration, bool onTurnStart = false, int chance = 100);
 
-    // 应用效果 (通常是将此效果添加到目标精灵的持续效果列表中)
+    // 应用效果 (向目标的回合效果槽写入一条记录，槽位已满时失败)
     virtual bool apply(Creature *source, Creature *target, BattleSystem *battle) override;
 
     // 获取效果描述
     virtual QString getDescription() const override;
 
-    // 获取剩余持续回合数
-    int getDuration() const;
-    // 设置剩余持续回合数
-    void setDuration(int duration);
-    // 减少一回合持续时间，如果减至0或以下则返回true表示效果结束
-    bool decrementDuration();
-
-    // 执行回合效果的逻辑
-    void executeTurnLogic(Creature *affectedCreature, Creature *sourceCreature, BattleSystem *battle);
-
+    TurnEffectKind getKind() const { return m_kind; }
+    // 获取施加时的持续回合数
+    int getDuration() const { return m_duration; }
     bool isOnTurnStart() const { return m_onTurnStart; } // 效果是在回合开始还是结束时触发
 
 private:
-    int m_initialDuration; // 初始设定的持续回合数
-    int m_currentDuration; // 当前剩余的持续回合数
-    // 使用std::function存储效果的具体逻辑，使其更灵活
-    // 参数：受影响的精灵，效果来源精灵(可能为nullptr)，战斗系统，效果自身(用于自我移除等)
-    std::function<void(Creature *affectedCreature, Creature *sourceCreature, BattleSystem *battle, TurnBasedEffect *self)> m_effectLogic;
-    bool m_onTurnStart;    // 标记效果是在回合开始还是结束时执行
-    QString m_description; // 效果的文本描述
-public:
-    void setDescription(const QString &desc) { m_description = desc; } // 允许外部设置描述
-    Creature *getOriginalSource() const { return m_originalSource; }   // 获取最初施加此效果的源
-    void setOriginalSource(Creature *source) { m_originalSource = source; }
-
-private:
-    Creature *m_originalSource = nullptr; // 记录最初施加此效果的源，用于一些需要追溯来源的逻辑
+    TurnEffectKind m_kind;
+    int m_duration;     // 施加时的持续回合数
+    bool m_onTurnStart; // 标记效果是在回合开始还是结束时执行
 };
 
+// 结算一条回合效果：affected为效果所在的精灵，施加者按记录中的(阵营, 下标)在battle中查找
+void executeTurnEffect(const TurnEffectSlot &effect, Creature *affected, BattleSystem *battle);
+// 回合效果的描述文本（施加与结束时写入战斗日志）
+QString getTurnEffectDescription(const TurnEffectSlot &effect);
+
 // 施加异常状态效果
 class StatusConditionEffect : public Effect
 {
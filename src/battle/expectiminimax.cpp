@@ -0,0 +1,206 @@
+// src/battle/expectiminimax.cpp
+#include "expectiminimax.h"
+#include "../core/creature.h"
+
+ExpectiminimaxSearch::ExpectiminimaxSearch(BattleSystem &battle, const OpponentAIConfig &config)
+    : AISearch(battle, config),
+      m_hasher(battle),
+      m_tableMask(0),
+      m_completedDepth(0),
+      m_aborted(false)
+{
+}
+
+QVector<ExpectiminimaxSearch::ChanceBranch> ExpectiminimaxSearch::chanceBranches(BattleSystem &battle, bool forPlayer,
+                                                                                   const BattleMove &move) const
+{
+    const QVector<ChanceBranch> certain{ChanceBranch{false, ChanceOutcome(), 1.0}};
+    if (move.action != BattleAction::USE_SKILL) return certain;
+
+    Creature *actor = forPlayer ? battle.getPlayerActiveCreature() : battle.getOpponentActiveCreature();
+    Creature *target = forPlayer ? battle.getOpponentActiveCreature() : battle.getPlayerActiveCreature();
+    if (!actor || !target || actor->isDead() || !actor->canAct()) return certain;
+    Skill *skill = (move.param == -1) ? actor->getFifthSkill() : actor->getSkill(move.param);
+    if (!skill) return certain;
+
+    QVector<ChanceBranch> branches;
+    ChanceOutcome miss;
+    miss.hit = false;
+
+    if (skill->getCategory() == SkillCategory::STATUS)
+    {
+        // 状态技能只有技能自身的命中判定
+        const double hitProbability = skill->getHitChance() / 100.0;
+        if (hitProbability > 0.0) branches.append(ChanceBranch{true, ChanceOutcome(), hitProbability});
+        if (hitProbability < 1.0) branches.append(ChanceBranch{true, miss, 1.0 - hitProbability});
+        return branches;
+    }
+
+    // 攻击技能的命中与暴击概率取自伤害分布
+    const DamageDistribution distribution = battle.getDamageDistribution(actor, target, skill);
+    const double hitProbability = distribution.hitProbability;
+    if (hitProbability < 1.0) branches.append(ChanceBranch{true, miss, 1.0 - hitProbability});
+    if (hitProbability <= 0.0) return branches;
+
+    const double criticalProbability = distribution.criticalProbability;
+    // 16档伤害浮动按顺序均分成若干组，每组取中间一档作为代表
+    const int rollCount = DAMAGE_ROLL_COUNT;
+    const int buckets = qBound(1, m_config.damageRollBuckets, rollCount);
+    for (int critical = 0; critical < 2; ++critical)
+    {
+        const double criticalWeight = critical ? criticalProbability : 1.0 - criticalProbability;
+        if (criticalWeight <= 0.0) continue;
+        for (int bucket = 0; bucket < buckets; ++bucket)
+        {
+            const int first = DAMAGE_ROLL_MIN + bucket * rollCount / buckets;
+            const int last = DAMAGE_ROLL_MIN + (bucket + 1) * rollCount / buckets - 1;
+            ChanceOutcome outcome;
+            outcome.critical = critical != 0;
+            outcome.damageRoll = (first + last + 1) / 2;
+            branches.append(ChanceBranch{true, outcome, hitProbability * criticalWeight * (last - first + 1) / rollCount});
+        }
+    }
+    return branches;
+}
+
+bool ExpectiminimaxSearch::isOutOfTime() const
+{
+    if (isStopRequested()) return true;
+    // 至少完成第一层，保证总有一个经过搜索的结果
+    return m_completedDepth > 0 && m_config.timeBudgetMs > 0 && m_timer.elapsed() >= m_config.timeBudgetMs;
+}
+
+double ExpectiminimaxSearch::searchState(BattleSystem &battle, const BattleState &state, quint64 hash, int depth, int *bestMove)
+{
+    battle.importState(state);
+    if (battle.getBattleResult() != BattleResult::ONGOING || depth <= 0)
+    {
+        return evaluate(battle);
+    }
+    if (isOutOfTime())
+    {
+        m_aborted = true;
+        return 0.0;
+    }
+
+    TableEntry &entry = m_table[hash & m_tableMask];
+    if (!bestMove && entry.key == hash && entry.depth >= depth)
+    {
+        return entry.value;
+    }
+
+    const QVector<BattleMove> aiMoves = bestMove ? m_rootMoves : legalMoves(battle, false);
+    QVector<BattleMove> playerMoves = legalMoves(battle, true);
+    if (state.playerActionSubmitted)
+    {
+        // 玩家本回合已经提交（只会出现在根节点），再次提交会被忽略，按已提交的行动计算概率分支
+        playerMoves.clear();
+        for (int i = 0; i < state.pendingActionCount; ++i)
+        {
+            if (state.pendingActions[i].side == 0)
+            {
+                playerMoves.append(BattleMove{static_cast<BattleAction>(state.pendingActions[i].action), state.pendingActions[i].param1});
+            }
+        }
+        if (playerMoves.isEmpty()) playerMoves.append(BattleMove{BattleAction::USE_SKILL, 0}); // 提交时即被判定为无法行动
+    }
+    if (aiMoves.isEmpty() || playerMoves.isEmpty())
+    {
+        return evaluate(battle);
+    }
+
+    // 概率分支取决于当前局面（HP、命中/闪避等级），在展开子节点之前算好
+    QVector<QVector<ChanceBranch>> aiBranches;
+    QVector<QVector<ChanceBranch>> playerBranches;
+    for (const BattleMove &move : aiMoves) aiBranches.append(chanceBranches(battle, false, move));
+    for (const BattleMove &move : playerMoves) playerBranches.append(chanceBranches(battle, true, move));
+
+    const quint64 nodeSeed = m_seed ^ hash;
+    double bestValue = -1.0;
+    int bestIndex = 0;
+    BattleState child;
+    for (int a = 0; a < aiMoves.size(); ++a)
+    {
+        double worstValue = 2.0;
+        for (int p = 0; p < playerMoves.size(); ++p)
+        {
+            double expected = 0.0;
+            for (const ChanceBranch &aiBranch : aiBranches[a])
+            {
+                for (const ChanceBranch &playerBranch : playerBranches[p])
+                {
+                    battle.importState(state);
+                    battle.setRandomSeed(nodeSeed);
+                    if (aiBranch.forced) battle.setForcedChanceOutcome(false, aiBranch.outcome);
+                    if (playerBranch.forced) battle.setForcedChanceOutcome(true, playerBranch.outcome);
+                    applyMoves(battle, playerMoves[p], aiMoves[a]);
+                    battle.clearForcedChanceOutcomes();
+
+                    double value = 0.0;
+                    if (battle.exportState(child))
+                    {
+                        value = searchState(battle, child, m_hasher.update(hash, state, child), depth - 1, nullptr);
+                    }
+                    else
+                    {
+                        value = evaluate(battle); // 效果过多无法快照，在此处截断
+                    }
+                    if (m_aborted) return 0.0;
+                    expected += aiBranch.probability * playerBranch.probability * value;
+                }
+            }
+            worstValue = qMin(worstValue, expected);
+            if (worstValue <= bestValue) break; // 该行动已不可能优于找到的最佳行动
+        }
+        if (worstValue > bestValue)
+        {
+            bestValue = worstValue;
+            bestIndex = a;
+        }
+    }
+
+    // 剪枝只跳过了不可能成为最佳的行动，bestValue是精确值，可以直接存入置换表
+    if (entry.key != hash || entry.depth <= depth)
+    {
+        entry.key = hash;
+        entry.value = static_cast<float>(bestValue);
+        entry.depth = static_cast<qint16>(depth);
+    }
+    if (bestMove) *bestMove = bestIndex;
+    return bestValue;
+}
+
+BattleMove ExpectiminimaxSearch::run()
+{
+    if (!isValid())
+    {
+        return BattleMove{BattleAction::USE_SKILL, 0};
+    }
+    if (m_rootMoves.size() == 1)
+    {
+        return m_rootMoves.first(); // 只有一种选择，无需搜索
+    }
+
+    const int tableBits = qBound(8, m_config.transpositionTableBits, 24);
+    m_table.assign(size_t(1) << tableBits, TableEntry{0, 0.0f, 0});
+    m_tableMask = (quint64(1) << tableBits) - 1;
+
+    MirrorBattle mirror(*this);
+    BattleSystem &battle = mirror.getBattle();
+    const quint64 rootHash = m_hasher.hash(m_rootState);
+
+    // 迭代加深：浅层的结果填充置换表，时间用完时使用最后一次完整搜索的结果
+    int bestMove = 0;
+    m_timer.start();
+    m_completedDepth = 0;
+    for (int depth = 1; depth <= qMax(1, m_config.maxDepth); ++depth)
+    {
+        m_aborted = false;
+        int depthBest = 0;
+        searchState(battle, m_rootState, rootHash, depth, &depthBest);
+        if (m_aborted) break;
+        bestMove = depthBest;
+        m_completedDepth = depth;
+    }
+    return m_rootMoves[bestMove];
+}
@@ -0,0 +1,55 @@
+// src/battle/expectiminimax.h
+#ifndef EXPECTIMINIMAX_H
+#define EXPECTIMINIMAX_H
+
+#include <QVector>
+#include <QElapsedTimer>
+#include <vector>
+#include "aisearch.h"
+#include "zobristhash.h"
+
+// 对手AI的期望极小极大搜索
+// 每一层是一个完整回合：AI选择行动使自己的最坏情况期望值最大（玩家视为针对AI的最优应对），
+// 双方行动确定后，命中、暴击、伤害浮动作为概率节点按精确概率展开并取期望。
+// 其余随机判定（附加效果几率、多段次数、睡眠苏醒等）用由局面哈希派生的固定种子取样，
+// 因此相同局面总是得到相同的结果，整个搜索是确定的。
+// 置换表以Zobrist哈希为键，在拉锯战中反复出现的局面不会被重复搜索。
+class ExpectiminimaxSearch : public AISearch
+{
+public:
+    ExpectiminimaxSearch(BattleSystem &battle, const OpponentAIConfig &config);
+
+    // 迭代加深到maxDepth或时间用完，返回最后一次完整搜索的最佳行动
+    BattleMove run() override;
+
+private:
+    // 一方行动的一个概率分支
+    struct ChanceBranch
+    {
+        bool forced;           // 是否需要指定随机结果（非攻击行动只有一个不指定的分支）
+        ChanceOutcome outcome;
+        double probability;
+    };
+
+    // 置换表项
+    struct TableEntry
+    {
+        quint64 key;
+        float value;
+        qint16 depth; // 0表示空
+    };
+
+    QVector<ChanceBranch> chanceBranches(BattleSystem &battle, bool forPlayer, const BattleMove &move) const;
+    // 返回局面对AI的价值；bestMove非空时（根节点）输出最佳行动下标
+    double searchState(BattleSystem &battle, const BattleState &state, quint64 hash, int depth, int *bestMove);
+    bool isOutOfTime() const;
+
+    ZobristHash m_hasher;
+    std::vector<TableEntry> m_table;
+    quint64 m_tableMask;
+    QElapsedTimer m_timer;
+    int m_completedDepth;
+    bool m_aborted; // 本层搜索因超时或取消而中断
+};
+
+#endif // EXPECTIMINIMAX_H
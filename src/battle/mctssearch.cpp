@@ -0,0 +1,233 @@
+// src/battle/mctssearch.cpp
+#include "mctssearch.h"
+#include "../core/creature.h"
+#include <QElapsedTimer>
+#include <QHash>
+#include <QThread>
+#include <QtMath>
+#include <vector>
+
+namespace {
+
+// 行动编码：高8位为行动类型，低8位为参数+1（第五技能的-1编码为0）
+quint16 encodeMove(const BattleMove &move)
+{
+    return static_cast<quint16>((static_cast<int>(move.action) << 8) | ((move.param + 1) & 0xFF));
+}
+
+// 一方某个行动在节点上的统计，value为该方视角的累计价值
+struct MoveStats
+{
+    quint16 code;
+    int visits;
+    double value;
+};
+
+// 搜索树节点：双方各自的行动统计，按联合行动索引子节点
+struct Node
+{
+    QVector<MoveStats> aiStats;
+    QVector<MoveStats> playerStats;
+    QHash<quint32, int> children; // (AI行动编码 << 16 | 玩家行动编码) -> 子节点下标
+};
+
+MoveStats &statsFor(QVector<MoveStats> &stats, quint16 code)
+{
+    for (MoveStats &entry : stats)
+    {
+        if (entry.code == code) return entry;
+    }
+    stats.append(MoveStats{code, 0, 0.0});
+    return stats.last();
+}
+
+// UCB1选择，返回legal中的下标；未尝试过的行动优先
+int selectMove(QVector<MoveStats> &stats, const QVector<BattleMove> &legal, double exploration, BattleRandom &random)
+{
+    int totalVisits = 0;
+    QVector<int> untried;
+    for (int i = 0; i < legal.size(); ++i)
+    {
+        const MoveStats &entry = statsFor(stats, encodeMove(legal[i]));
+        totalVisits += entry.visits;
+        if (entry.visits == 0) untried.append(i);
+    }
+    if (!untried.isEmpty())
+    {
+        return untried[random.bounded(untried.size())];
+    }
+
+    const double logTotal = qLn(static_cast<double>(totalVisits));
+    int best = 0;
+    double bestScore = -1.0;
+    for (int i = 0; i < legal.size(); ++i)
+    {
+        const MoveStats &entry = statsFor(stats, encodeMove(legal[i]));
+        const double score = entry.value / entry.visits + exploration * qSqrt(logTotal / entry.visits);
+        if (score > bestScore)
+        {
+            bestScore = score;
+            best = i;
+        }
+    }
+    return best;
+}
+
+} // namespace
+
+MctsSearch::MctsSearch(BattleSystem &battle, const OpponentAIConfig &config)
+    : AISearch(battle, config)
+{
+}
+
+MctsSearch::RootStats MctsSearch::searchWorker(quint64 seed, int threadIndex) const
+{
+    Q_UNUSED(threadIndex);
+
+    RootStats result;
+    {
+        // 每个线程用模板重建双方队伍，组成一场只属于本线程的镜像战斗
+        MirrorBattle mirror(*this);
+        BattleSystem &battle = mirror.getBattle();
+
+        BattleRandom random(seed);
+        QVector<Node> nodes;
+        nodes.append(Node());
+
+        struct PathStep
+        {
+            int node;
+            quint16 aiCode;
+            quint16 playerCode;
+        };
+        QVector<PathStep> path;
+
+        QElapsedTimer timer;
+        timer.start();
+        int iterations = 0;
+        while (!isStopRequested())
+        {
+            if (m_config.maxIterations > 0 && iterations >= m_config.maxIterations) break;
+            if (m_config.timeBudgetMs > 0 && timer.elapsed() >= m_config.timeBudgetMs) break;
+            ++iterations;
+
+            battle.importState(m_rootState);
+            battle.setRandomSeed(random.next()); // 每次迭代使用不同的随机结果
+            const int startTurn = battle.getCurrentTurn();
+            path.clear();
+
+            // 选择与扩展：沿树下降，遇到未展开的联合行动时新建节点并停止
+            int nodeIndex = 0;
+            while (battle.getBattleResult() == BattleResult::ONGOING &&
+                   battle.getCurrentTurn() - startTurn < m_config.maxRolloutTurns)
+            {
+                const QVector<BattleMove> aiMoves = legalMoves(battle, false);
+                const QVector<BattleMove> playerMoves = legalMoves(battle, true);
+                if (aiMoves.isEmpty() || playerMoves.isEmpty()) break;
+
+                const BattleMove &aiMove = aiMoves[selectMove(nodes[nodeIndex].aiStats, aiMoves, m_config.exploration, random)];
+                const BattleMove &playerMove = playerMoves[selectMove(nodes[nodeIndex].playerStats, playerMoves, m_config.exploration, random)];
+                const PathStep step{nodeIndex, encodeMove(aiMove), encodeMove(playerMove)};
+                path.append(step);
+                applyMoves(battle, playerMove, aiMove);
+
+                const quint32 key = (static_cast<quint32>(step.aiCode) << 16) | step.playerCode;
+                int child = nodes[nodeIndex].children.value(key, -1);
+                if (child < 0)
+                {
+                    child = nodes.size();
+                    nodes[nodeIndex].children.insert(key, child);
+                    nodes.append(Node());
+                    break;
+                }
+                nodeIndex = child;
+            }
+
+            // 随机模拟
+            while (battle.getBattleResult() == BattleResult::ONGOING &&
+                   battle.getCurrentTurn() - startTurn < m_config.maxRolloutTurns)
+            {
+                const QVector<BattleMove> aiMoves = legalMoves(battle, false);
+                const QVector<BattleMove> playerMoves = legalMoves(battle, true);
+                if (aiMoves.isEmpty() || playerMoves.isEmpty()) break;
+                applyMoves(battle, playerMoves[random.bounded(playerMoves.size())], aiMoves[random.bounded(aiMoves.size())]);
+            }
+
+            // 回传：AI一方累加价值，玩家一方累加其互补值
+            const double value = evaluate(battle);
+            for (const PathStep &step : path)
+            {
+                MoveStats &aiEntry = statsFor(nodes[step.node].aiStats, step.aiCode);
+                aiEntry.visits++;
+                aiEntry.value += value;
+                MoveStats &playerEntry = statsFor(nodes[step.node].playerStats, step.playerCode);
+                playerEntry.visits++;
+                playerEntry.value += 1.0 - value;
+            }
+        }
+
+        for (const BattleMove &move : m_rootMoves)
+        {
+            const MoveStats &entry = statsFor(nodes[0].aiStats, encodeMove(move));
+            result.moves.append(move);
+            result.visits.append(entry.visits);
+            result.values.append(entry.value);
+        }
+    }
+    return result;
+}
+
+BattleMove MctsSearch::run()
+{
+    if (!isValid())
+    {
+        return BattleMove{BattleAction::USE_SKILL, 0};
+    }
+    if (m_rootMoves.size() == 1)
+    {
+        return m_rootMoves.first(); // 只有一种选择，无需搜索
+    }
+
+    // 根并行：每个线程独立搜索，调用线程自己承担第0份
+    const int threadCount = qMax(1, m_config.threadCount > 0 ? m_config.threadCount : QThread::idealThreadCount());
+    std::vector<RootStats> results(threadCount);
+    QVector<QThread *> threads;
+    for (int i = 1; i < threadCount; ++i)
+    {
+        const quint64 threadSeed = m_seed + 0x9E3779B97F4A7C15ULL * static_cast<quint64>(i);
+        QThread *thread = QThread::create([this, &results, threadSeed, i]() {
+            results[i] = searchWorker(threadSeed, i);
+        });
+        threads.append(thread);
+        thread->start();
+    }
+    results[0] = searchWorker(m_seed, 0);
+    for (QThread *thread : threads)
+    {
+        thread->wait();
+        delete thread;
+    }
+
+    // 合并各线程根节点的统计，选择访问次数最多的行动（相同时取平均价值高者）
+    int bestIndex = 0;
+    int bestVisits = -1;
+    double bestMean = -1.0;
+    for (int m = 0; m < m_rootMoves.size(); ++m)
+    {
+        int visits = 0;
+        double value = 0.0;
+        for (const RootStats &stats : results)
+        {
+            visits += stats.visits.value(m);
+            value += stats.values.value(m);
+        }
+        const double mean = visits > 0 ? value / visits : 0.0;
+        if (visits > bestVisits || (visits == bestVisits && mean > bestMean))
+        {
+            bestIndex = m;
+            bestVisits = visits;
+            bestMean = mean;
+        }
+    }
+    return m_rootMoves[bestIndex];
+}
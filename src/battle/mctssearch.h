@@ -0,0 +1,32 @@
+// src/battle/mctssearch.h
+#ifndef MCTSSEARCH_H
+#define MCTSSEARCH_H
+
+#include <QVector>
+#include "aisearch.h"
+
+// 对手AI的蒙特卡洛树搜索
+// 双方同时出招，因此采用解耦UCT：每个节点为双方分别维护各自行动的统计，按联合行动展开子节点。
+// 战斗存在随机性，树是“开环”的：每次迭代都从根快照重新模拟，节点只记录行动序列。
+// 多核时使用根并行：每个线程持有独立的镜像战斗和独立的树，结束后合并根节点的访问次数。
+class MctsSearch : public AISearch
+{
+public:
+    MctsSearch(BattleSystem &battle, const OpponentAIConfig &config);
+
+    // 返回访问次数最多的行动
+    BattleMove run() override;
+
+private:
+    // 单个线程的搜索结果：根节点上AI各行动的访问次数与累计价值
+    struct RootStats
+    {
+        QVector<BattleMove> moves;
+        QVector<int> visits;
+        QVector<double> values;
+    };
+
+    RootStats searchWorker(quint64 seed, int threadIndex) const;
+};
+
+#endif // MCTSSEARCH_H
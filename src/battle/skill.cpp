@@ -3,7 +3,6 @@
 #include "../core/creature.h"     // 核心 - 精灵类
 #include "battlesystem.h"         // 战斗 - 战斗系统类
 #include "../battle/effect.h"     // 战斗 - 效果类 (如果技能直接创建效果)
-#include <QRandomGenerator>       // Qt随机数生成器
 
 // --- Skill基类实现 ---
 
@@ -135,6 +134,12 @@ bool Skill::isAlwaysHit() const
     return m_accuracy >= 101; // 假设命中率101或更高表示必中 (一些游戏用 >100 或特定标志)
 }
 
+int Skill::getHitChance() const
+{
+    if (isAlwaysHit() || m_accuracy == 0) return 100; // 与checkHit一致：命中为0视为必中
+    return qBound(0, m_accuracy, 100);
+}
+
 // 添加效果到技能
 void Skill::addEffect(Effect *effect)
 {
@@ -170,13 +175,17 @@ bool Skill::checkHit(Creature *user, Creature *target, BattleSystem *battle)
         return true;
     }
     if (!user || !target || !battle) return false; // 基本参数检查
+    if (const ChanceOutcome *forced = battle->getForcedChanceOutcome(user))
+    {
+        return forced->hit; // 命中结果已由AI搜索指定
+    }
 
     // BattleSystem中会进行更复杂的命中计算，这里是一个非常基础的判定
     // battle->checkSkillHit(user, target, this) 应该在BattleSystem中被调用
     // 这里仅作一个占位或最基础的判定
     if (m_accuracy == 0) return true; // 命中为0的技能通常是状态类或必中，这里暂定为必中（需根据游戏设计调整）
 
-    int chance = QRandomGenerator::global()->bounded(1, 101); // 生成1到100的随机数
+    int chance = battle->getRandom().bounded(1, 101); // 生成1到100的随机数
     return chance <= m_accuracy;
 }
 
@@ -256,7 +265,7 @@ bool CompositeSkill::use(Creature *user, Creature *target, BattleSystem *battle)
 
     if (hitSuccess) {
         // 检查是否触发附加效果
-        if (QRandomGenerator::global()->bounded(100) < m_effectChance) {
+        if (battle && battle->getRandom().bounded(100) < m_effectChance) {
             // 应用所有附加效果
             for (Effect *effect : m_effects) {
                 if (effect) {
@@ -286,7 +295,7 @@ bool MultiHitSkill::use(Creature *user, Creature *target, BattleSystem *battle)
     // 中文注释：多段攻击技能使用逻辑
     if (!user || !target || !battle) return false;
 
-    int numberOfHits = QRandomGenerator::global()->bounded(m_minHits, m_maxHits + 1);
+    int numberOfHits = battle->getRandom().bounded(m_minHits, m_maxHits + 1);
     bool hitAtLeastOnce = false;
 
     // BattleSystem 将循环调用 calculateDamage 和 takeDamage numberOfHits 次
@@ -298,7 +307,7 @@ bool MultiHitSkill::use(Creature *user, Creature *target, BattleSystem *battle)
             // 对于有附加效果的多段攻击，效果如何触发需要明确设计
             // 示例：每次命中都尝试触发效果
             for (Effect *effect : m_effects) {
-                if (effect && effect->publicCheckChance()) { // 效果自身也有触发几率
+                if (effect && effect->publicCheckChance(battle)) { // 效果自身也有触发几率
                     effect->apply(user, target, battle);
                 }
             }
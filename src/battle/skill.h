@@ -63,6 +63,8 @@ public:
     QString getDetailedDescription() const;
     // 判断技能是否为必中技能 (基于其accuracy值)
     bool isAlwaysHit() const;
+    // 技能自身命中判定(checkHit)的命中率(%)，不含战斗系统的命中/闪避修正
+    int getHitChance() const;
 
     // --- 技能效果管理 ---
     void addEffect(Effect *effect);             // 为技能添加一个效果
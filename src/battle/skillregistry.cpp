@@ -0,0 +1,165 @@
+// src/battle/skillregistry.cpp
+#include "skillregistry.h"
+#include "skill.h"
+#include "specialskills.h"
+#include "effect.h"
+
+const SkillRegistry &SkillRegistry::getInstance()
+{
+    static const SkillRegistry registry; // 首次使用时构造，线程安全
+    return registry;
+}
+
+SkillRegistry::SkillRegistry()
+{
+    Skill **skills = m_skills;
+    skills[static_cast<int>(SkillId::NONE)] = nullptr;
+
+    // --- 木棍人 ---
+    skills[static_cast<int>(SkillId::HEAVY_SWING)] = new PhysicalSkill("猛力挥击", ElementType::NORMAL, 130, 3, 95);
+    skills[static_cast<int>(SkillId::TRIPLE_STRIKE)] =
+        new MultiHitSkill("三重连打", ElementType::NORMAL, SkillCategory::PHYSICAL, 60, 4, 90, 3, 3); // 3次60威力
+
+    StatusSkill *hardenWoodBody = new StatusSkill("硬化木身", ElementType::NORMAL, 3, 100); // 命中100表示对自己使用通常必中
+    hardenWoodBody->addEffect(new StatChangeEffect(StatType::DEFENSE, 3, true));            // 提升自身物防+3
+    hardenWoodBody->addEffect(new StatChangeEffect(StatType::SP_DEFENSE, 3, true));         // 提升自身特防+3
+    skills[static_cast<int>(SkillId::HARDEN_WOOD_BODY)] = hardenWoodBody;
+
+    CompositeSkill *armorPierceThrust = new CompositeSkill("破甲直刺", ElementType::NORMAL, SkillCategory::PHYSICAL, 70, 3, 100);
+    armorPierceThrust->setEffectChance(80);                                                      // 80%的触发几率
+    armorPierceThrust->addEffect(new StatChangeEffect(StatType::DEFENSE, -2, false));            // false表示对目标
+    armorPierceThrust->addEffect(new ClearEffectsEffect(true, false, false, false, false, 100)); // 清除目标能力提升状态
+    skills[static_cast<int>(SkillId::ARMOR_PIERCE_THRUST)] = armorPierceThrust;
+
+    skills[static_cast<int>(SkillId::INDOMITABLE_SPIRIT)] = new IndomitableSpiritSkill();
+
+    // --- 鳄鱼轰炸机 ---
+    CompositeSkill *steelWing = new CompositeSkill("钢翼切割", ElementType::MACHINE, SkillCategory::PHYSICAL, 75, 3, 95);
+    steelWing->setEffectChance(50);                                         // 50%几率
+    steelWing->addEffect(new StatChangeEffect(StatType::DEFENSE, 1, true)); // 提升自身物防+1
+    skills[static_cast<int>(SkillId::STEEL_WING)] = steelWing;
+
+    // 俯冲轰炸：使用后下一回合自身无法行动 -> 通过添加一个持续1回合的TIRED状态实现
+    CompositeSkill *diveBomb = new CompositeSkill("俯冲轰炸", ElementType::FLYING, SkillCategory::PHYSICAL, 120, 4, 90);
+    StatusConditionEffect *diveBombTired = new StatusConditionEffect(StatusCondition::TIRED, 100); // 100%对自己施加疲惫
+    diveBombTired->setTargetSelf(true);                                                            // 确保疲惫效果作用于自身
+    diveBomb->addEffect(diveBombTired);
+    skills[static_cast<int>(SkillId::DIVE_BOMB)] = diveBomb;
+
+    CompositeSkill *alligatorFang = new CompositeSkill("鳄牙撕咬", ElementType::WATER, SkillCategory::PHYSICAL, 80, 3, 100);
+    alligatorFang->setEffectChance(20);
+    alligatorFang->addEffect(new StatusConditionEffect(StatusCondition::FEAR, 100)); // 100%几率在20%命中时触发害怕
+    skills[static_cast<int>(SkillId::ALLIGATOR_FANG)] = alligatorFang;
+
+    skills[static_cast<int>(SkillId::LOCK_ON_MISSILE)] = new SpecialSkill("锁定导弹", ElementType::MACHINE, 80, 3, 101); // 101命中视为必中
+    skills[static_cast<int>(SkillId::AIRSPACE_SUPREMACY)] = new AirspaceSupremacySkill();
+
+    // --- 耐克鲨鱼 ---
+    skills[static_cast<int>(SkillId::SHADOW_SNEAK)] = new PhysicalSkill("暗影偷袭", ElementType::SHADOW, 40, 2, 100, 1); // 先制+1
+    // 激流勇进: 自身HP低于1/3时，威力提升50% (这个逻辑需要在Skill::getPower()重写或BattleSystem中处理)
+    skills[static_cast<int>(SkillId::RIPTIDE_RUSH)] = new SpecialSkill("激流勇进", ElementType::WATER, 80, 3, 100);
+    skills[static_cast<int>(SkillId::SPEED_STAR)] = new SpecialSkill("速度之星", ElementType::NORMAL, 60, 2, 101); // 必中
+
+    StatusSkill *opportunist = new StatusSkill("伺机待发", ElementType::SHADOW, 2, 100);
+    opportunist->addEffect(new StatChangeEffect(StatType::SPEED, 2, true));
+    skills[static_cast<int>(SkillId::OPPORTUNIST)] = opportunist;
+
+    // --- 仙人掌大象 ---
+    StatusSkill *leechSeed = new StatusSkill("寄生种子", ElementType::GRASS, 2, 90);
+    TurnBasedEffect *leechEffect = new TurnBasedEffect(TurnEffectKind::LEECH_SEED, 999);
+    leechEffect->setTargetSelf(false); // 效果应该作用于对手
+    leechSeed->addEffect(leechEffect);
+    skills[static_cast<int>(SkillId::LEECH_SEED)] = leechSeed;
+
+    // 沙尘尖刺 (Entry Hazard，需要在BattleSystem中特殊处理)
+    skills[static_cast<int>(SkillId::SAND_SPIKES)] = new StatusSkill("沙尘尖刺", ElementType::GROUND, 3, 100);
+
+    CompositeSkill *thornArmSlam = new CompositeSkill("针刺臂膀", ElementType::GRASS, SkillCategory::PHYSICAL, 70, 3, 100);
+    thornArmSlam->setEffectChance(30);
+    thornArmSlam->addEffect(new StatusConditionEffect(StatusCondition::POISON, 100));
+    skills[static_cast<int>(SkillId::THORN_ARM_SLAM)] = thornArmSlam;
+
+    CompositeSkill *earthShaker = new CompositeSkill("大地摇晃", ElementType::GROUND, SkillCategory::SPECIAL, 90, 3, 100);
+    earthShaker->setEffectChance(10);
+    earthShaker->addEffect(new StatChangeEffect(StatType::SP_DEFENSE, -1, false));
+    skills[static_cast<int>(SkillId::EARTH_SHAKER)] = earthShaker;
+
+    skills[static_cast<int>(SkillId::LIFE_SIPHON_FIELD)] = new LifeSiphonFieldSkill();
+
+    // --- 香蕉绿猩猩 ---
+    skills[static_cast<int>(SkillId::BANANA_SMASH)] = new PhysicalSkill("香蕉猛击", ElementType::GRASS, 85, 3, 100);
+    skills[static_cast<int>(SkillId::POWER_PUNCH)] = new PhysicalSkill("巨力冲拳", ElementType::NORMAL, 90, 3, 95);
+
+    StatusSkill *jungleFortitude = new StatusSkill("丛林坚壁", ElementType::GRASS, 2, 100);
+    jungleFortitude->addEffect(new StatChangeEffect(StatType::DEFENSE, 2, true));
+    skills[static_cast<int>(SkillId::JUNGLE_FORTITUDE)] = jungleFortitude;
+
+    StatusSkill *primalRoar = new StatusSkill("野性咆哮", ElementType::NORMAL, 2, 100);
+    primalRoar->addEffect(new StatChangeEffect(StatType::ATTACK, -1, false));
+    primalRoar->addEffect(new StatChangeEffect(StatType::DEFENSE, -1, false));
+    skills[static_cast<int>(SkillId::PRIMAL_ROAR)] = primalRoar;
+
+    skills[static_cast<int>(SkillId::PRIMAL_SHIFT)] = new PrimalShiftSkill();
+    skills[static_cast<int>(SkillId::JUNGLE_KING_STRIKE)] = new JungleKingStrikeSkill();
+
+    // --- 鹿管鹿管鹿鹿时间到了 ---
+    CompositeSkill *temporalRay = new CompositeSkill("时光射线", ElementType::LIGHT, SkillCategory::SPECIAL, 70, 3, 100);
+    temporalRay->setEffectChance(20);
+    temporalRay->addEffect(new StatChangeEffect(StatType::SPEED, -1, false));
+    skills[static_cast<int>(SkillId::TEMPORAL_RAY)] = temporalRay;
+
+    StatusSkill *rewindHeal = new StatusSkill("回溯疗愈", ElementType::NORMAL, 3, 100);
+    rewindHeal->addEffect(new ClearEffectsEffect(false, false, true, false, true)); // 清除自身异常状态
+    // 恢复至上回合结束时的HP，这个非常复杂，需要BattleSystem记录历史状态
+    skills[static_cast<int>(SkillId::REWIND_HEAL)] = rewindHeal;
+
+    StatusSkill *acceleratedVision = new StatusSkill("加速视界", ElementType::LIGHT, 2, 100);
+    acceleratedVision->addEffect(new StatChangeEffect(StatType::SPEED, 1, true));
+    // 本回合技能必定命中，需要一个临时状态或BattleSystem配合
+    skills[static_cast<int>(SkillId::ACCELERATED_VISION)] = acceleratedVision;
+
+    // 时光跳跃: 先制+3。使自身本回合免疫所有攻击和技能效果。
+    // 免疫效果通过回合效果标记，由BattleSystem检查
+    StatusSkill *timeHop = new StatusSkill("时光跳跃", ElementType::LIGHT, 2, 100, 3);     // 优先级3
+    TurnBasedEffect *hopImmunity = new TurnBasedEffect(TurnEffectKind::TIME_HOP, 1, true); // 持续1回合，回合开始生效
+    hopImmunity->setTargetSelf(true);
+    timeHop->addEffect(hopImmunity);
+    skills[static_cast<int>(SkillId::TIME_HOP)] = timeHop;
+
+    skills[static_cast<int>(SkillId::TEMPORAL_PARADOX)] = new TemporalParadoxSkill();
+
+    // --- 卡布奇诺忍者 ---
+    skills[static_cast<int>(SkillId::SHADOW_SHURIKEN)] =
+        new MultiHitSkill("影手里剑", ElementType::SHADOW, SkillCategory::PHYSICAL, 25, 2, 100, 2, 3, 1);
+
+    // 滚烫奇袭：30%几率令目标烧伤。若目标速度低于自身，则烧伤几率提升至60%。 (条件几率需BattleSystem支持)
+    CompositeSkill *scaldingSurprise = new CompositeSkill("滚烫奇袭", ElementType::FIRE, SkillCategory::SPECIAL, 70, 3, 100);
+    scaldingSurprise->setEffectChance(30);                                              // 基础30%
+    scaldingSurprise->addEffect(new StatusConditionEffect(StatusCondition::BURN, 100)); // 若触发setEffectChance，则100%烧伤
+    skills[static_cast<int>(SkillId::SCALDING_SURPRISE)] = scaldingSurprise;
+
+    CompositeSkill *metalGrind = new CompositeSkill("金属研磨", ElementType::MACHINE, SkillCategory::PHYSICAL, 75, 3, 95);
+    metalGrind->setEffectChance(30);
+    metalGrind->addEffect(new StatChangeEffect(StatType::SPEED, -1, false));
+    skills[static_cast<int>(SkillId::METAL_GRIND)] = metalGrind;
+
+    StatusSkill *swiftVanish = new StatusSkill("急速隐匿", ElementType::SHADOW, 2, 100);
+    swiftVanish->addEffect(new StatChangeEffect(StatType::SPEED, 2, true));
+    skills[static_cast<int>(SkillId::SWIFT_VANISH)] = swiftVanish;
+
+    // 先制+1。若目标HP高于75%，则此技能威力提升50%；若目标HP低于25%，则此技能必定暴击。
+    skills[static_cast<int>(SkillId::PHANTOM_ASSASSINATE)] = new PhantomAssassinateSkill();
+
+    for (int i = 1; i < SKILL_ID_COUNT; ++i)
+    {
+        m_idsByName.insert(m_skills[i]->getName(), static_cast<SkillId>(i));
+    }
+}
+
+SkillRegistry::~SkillRegistry()
+{
+    for (Skill *skill : m_skills)
+    {
+        delete skill; // 技能析构时一并释放其效果
+    }
+}
@@ -0,0 +1,96 @@
+// src/battle/skillregistry.h
+#ifndef SKILLREGISTRY_H
+#define SKILLREGISTRY_H
+
+#include <QHash>
+#include <QString>
+
+class Skill;
+
+// 技能编号
+// 所有技能（含效果）在注册表中各只有一份，精灵只保存编号；
+// 技能对象构造完成后不再修改，因此可以被任意多只精灵和任意多场战斗共用。
+enum class SkillId : quint8
+{
+    NONE, // 空技能槽
+
+    // 木棍人
+    HEAVY_SWING,         // 猛力挥击
+    TRIPLE_STRIKE,       // 三重连打
+    HARDEN_WOOD_BODY,    // 硬化木身
+    ARMOR_PIERCE_THRUST, // 破甲直刺
+    INDOMITABLE_SPIRIT,  // 不屈战魂（第五技能）
+
+    // 鳄鱼轰炸机
+    STEEL_WING,          // 钢翼切割
+    DIVE_BOMB,           // 俯冲轰炸
+    ALLIGATOR_FANG,      // 鳄牙撕咬
+    LOCK_ON_MISSILE,     // 锁定导弹
+    AIRSPACE_SUPREMACY,  // 空域压制（第五技能）
+
+    // 耐克鲨鱼
+    SHADOW_SNEAK,        // 暗影偷袭
+    RIPTIDE_RUSH,        // 激流勇进
+    SPEED_STAR,          // 速度之星
+    OPPORTUNIST,         // 伺机待发
+
+    // 仙人掌大象
+    LEECH_SEED,          // 寄生种子
+    SAND_SPIKES,         // 沙尘尖刺
+    THORN_ARM_SLAM,      // 针刺臂膀
+    EARTH_SHAKER,        // 大地摇晃
+    LIFE_SIPHON_FIELD,   // 生命汲取领域（第五技能）
+
+    // 香蕉绿猩猩
+    BANANA_SMASH,        // 香蕉猛击
+    POWER_PUNCH,         // 巨力冲拳
+    JUNGLE_FORTITUDE,    // 丛林坚壁
+    PRIMAL_ROAR,         // 野性咆哮
+    PRIMAL_SHIFT,        // 狂化变身
+    JUNGLE_KING_STRIKE,  // 丛林之王强击（第五技能）
+
+    // 鹿管鹿管鹿鹿时间到了
+    TEMPORAL_RAY,        // 时光射线
+    REWIND_HEAL,         // 回溯疗愈
+    ACCELERATED_VISION,  // 加速视界
+    TIME_HOP,            // 时光跳跃
+    TEMPORAL_PARADOX,    // 时间悖论（第五技能）
+
+    // 卡布奇诺忍者
+    SHADOW_SHURIKEN,     // 影手里剑
+    SCALDING_SURPRISE,   // 滚烫奇袭
+    METAL_GRIND,         // 金属研磨
+    SWIFT_VANISH,        // 急速隐匿
+    PHANTOM_ASSASSINATE  // 绝影刺杀（第五技能）
+};
+
+const int SKILL_ID_COUNT = static_cast<int>(SkillId::PHANTOM_ASSASSINATE) + 1; // 含NONE
+
+// 全局技能注册表，第一次访问时构造全部技能，程序退出时释放
+class SkillRegistry
+{
+public:
+    static const SkillRegistry &getInstance();
+
+    // 技能定义，NONE或越界返回nullptr
+    // 返回的对象由注册表持有且为所有精灵共用，调用方不能修改或释放
+    Skill *getSkill(SkillId id) const
+    {
+        const int index = static_cast<int>(id);
+        return index > 0 && index < SKILL_ID_COUNT ? m_skills[index] : nullptr;
+    }
+
+    // 按技能名称查找（存档载入等输入处用），未找到返回NONE
+    SkillId findByName(const QString &name) const { return m_idsByName.value(name, SkillId::NONE); }
+
+private:
+    SkillRegistry();
+    ~SkillRegistry();
+    SkillRegistry(const SkillRegistry &) = delete;
+    SkillRegistry &operator=(const SkillRegistry &) = delete;
+
+    Skill *m_skills[SKILL_ID_COUNT];
+    QHash<QString, SkillId> m_idsByName; // 名称只在此处换算一次，之后都比较编号
+};
+
+#endif // SKILLREGISTRY_H
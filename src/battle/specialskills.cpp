@@ -19,7 +19,7 @@ bool FifthSkill::use(Creature *user, Creature *target, BattleSystem* battle)
 {
     // 先检查是否可以使用此技能
     if (!canUse(user, target, battle)) {
-        if (battle) {
+        if (battle && battle->isBattleLogEnabled()) { // 关闭日志时不必拼接文本
             battle->addBattleLog(QString("%1 无法使用 %2！条件不满足。").arg(user->getName()).arg(this->getName()));
         }
         return false;
@@ -113,21 +113,8 @@ QString IndomitableSpiritSkill::getDescription() const
 AirspaceSupremacySkill::AirspaceSupremacySkill()
     : FifthSkill("空域压制", ElementType::FLYING, SkillCategory::STATUS, 0, 3, 100)
 {
-       auto airspaceLambda = [](Creature *source, Creature *affectedCreature, BattleSystem *battle, TurnBasedEffect *effect)
-        {
-            if (!battle || !affectedCreature || affectedCreature->isDead())
-                return;
-
-            int oldSpeedStage = affectedCreature->getStatStages().getStage(StatType::SPEED);
-            affectedCreature->modifyStatStage(StatType::SPEED, -1);
-            battle->triggerStatStageChanged(affectedCreature, StatType::SPEED, oldSpeedStage, 
-                                            affectedCreature->getStatStages().getStage(StatType::SPEED));
-        };
-    
-    TurnBasedEffect *debuffEffect = new TurnBasedEffect(3, airspaceLambda, true);
+    TurnBasedEffect *debuffEffect = new TurnBasedEffect(TurnEffectKind::SPEED_DOWN, 3, true);
     debuffEffect->setTargetSelf(false);  // 效果附着在对手身上
-    debuffEffect->setDescription("空域压制：速度下降");
-    debuffEffect->setOriginalSource(nullptr);  // 会在apply时自动设置
     addEffect(debuffEffect);
 }
 
@@ -152,43 +139,8 @@ QString BlitzPredatorSkill::getDescription() const
 LifeSiphonFieldSkill::LifeSiphonFieldSkill()
     : FifthSkill("生命汲取领域", ElementType::GRASS, SkillCategory::STATUS, 0, 4, 100)
 {
-    auto siphonLambda = [](Creature *source, Creature *affectedCreature, BattleSystem *battle, TurnBasedEffect *effect)
-    {
-        if (!battle || !source || !affectedCreature)
-            return;
-        
-        // 获取对手
-        Creature *opponent = battle->getOpponentActiveCreature() == source ? 
-                        battle->getPlayerActiveCreature() : 
-                        battle->getOpponentActiveCreature();
-                        
-        if (opponent && !opponent->isDead())
-        {
-            // 只对非草系精灵造成伤害
-            if (opponent->getType().getPrimaryType() != ElementType::GRASS &&
-                (opponent->getType().getSecondaryType() == ElementType::NONE || 
-                opponent->getType().getSecondaryType() != ElementType::GRASS))
-            {
-                int damage = opponent->getMaxHP() / 16;
-                opponent->takeDamage(damage);  // 只造成伤害
-                
-                // 使用战斗系统的触发器，带上效果名称作为区分
-                battle->triggerDamageCaused(opponent, damage, StatusCondition::NONE); // 使用NONE表示非状态伤害
-            }
-        }
-        
-        // 回复使用者生命值
-        if (!affectedCreature->isDead()) {
-            int healAmount = affectedCreature->getMaxHP() / 8;
-            affectedCreature->heal(healAmount);
-            battle->triggerHealingReceived(affectedCreature, healAmount);
-        }
-    };
-    
-    TurnBasedEffect *siphonEffect = new TurnBasedEffect(3, siphonLambda, false);
-    siphonEffect->setDescription("生命汲取领域激活中");
+    TurnBasedEffect *siphonEffect = new TurnBasedEffect(TurnEffectKind::LIFE_SIPHON, 3);
     siphonEffect->setTargetSelf(true);  // 效果附着在使用者身上
-    siphonEffect->setOriginalSource(nullptr);  // 会在apply时自动设置
     addEffect(siphonEffect);
 }
 
@@ -245,6 +197,19 @@ TemporalParadoxSkill::TemporalParadoxSkill()
 {
 }
 
+bool TemporalParadoxSkill::use(Creature *user, Creature *target, BattleSystem *battle)
+{
+    if (!FifthSkill::use(user, target, battle))
+        return false;
+
+    // 场上状态由BattleSystem每回合记录，这里只需记下回退的回合
+    Luguanluguanlulushijiandaole *luguan = dynamic_cast<Luguanluguanlulushijiandaole *>(user);
+    if (!luguan)
+        return false; // 只有鹿管鹿管鹿鹿时间到了能使用
+    luguan->recordBattleState(battle);
+    return true;
+}
+
 QString TemporalParadoxSkill::getDescription() const
 {
     return "记录当前场上双方精灵的状态。3回合后，若此精灵仍在场，则有50%几率将场上所有精灵的状态恢复到记录时的状态。若发动失败，则自身陷入疲惫1回合。";
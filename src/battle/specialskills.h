@@ -87,6 +87,7 @@ class TemporalParadoxSkill : public FifthSkill {
 public:
     TemporalParadoxSkill();
     
+    bool use(Creature *user, Creature *target, BattleSystem *battle) override;
     QString getDescription() const override;
 };
 
@@ -0,0 +1,50 @@
+// src/battle/stringinterner.h
+#ifndef STRINGINTERNER_H
+#define STRINGINTERNER_H
+
+#include <QHash>
+#include <QString>
+#include <QVector>
+
+// 字符串驻留表
+// 内容相同的字符串只保存一份，以32位编号代替；编号相等即内容相等。
+// 不加锁，由持有者保证只在一个线程中使用。
+class StringInterner
+{
+public:
+    static const quint32 INVALID_HANDLE = 0xFFFFFFFFu;
+
+    // 返回text的编号，第一次出现时加入表中
+    quint32 intern(const QString &text)
+    {
+        const auto it = m_handles.constFind(text);
+        if (it != m_handles.constEnd()) return it.value();
+        const quint32 handle = static_cast<quint32>(m_strings.size());
+        m_strings.append(text);
+        m_handles.insert(text, handle);
+        return handle;
+    }
+
+    // 只查找不加入，未出现过时返回INVALID_HANDLE
+    quint32 find(const QString &text) const { return m_handles.value(text, INVALID_HANDLE); }
+
+    // 编号无效时返回空字符串
+    QString getString(quint32 handle) const
+    {
+        return handle < static_cast<quint32>(m_strings.size()) ? m_strings[static_cast<int>(handle)] : QString();
+    }
+
+    int size() const { return m_strings.size(); }
+
+    void clear()
+    {
+        m_strings.clear();
+        m_handles.clear();
+    }
+
+private:
+    QVector<QString> m_strings;        // 下标即编号
+    QHash<QString, quint32> m_handles; // 内容到编号
+};
+
+#endif // STRINGINTERNER_H
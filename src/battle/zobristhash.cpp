@@ -0,0 +1,129 @@
+// src/battle/zobristhash.cpp
+#include "zobristhash.h"
+#include "battlesystem.h"
+#include <cstring>
+
+namespace {
+
+// 全部特征键，由固定种子生成，程序内所有哈希实例共用
+struct ZobristKeys
+{
+    quint64 hp[2][BATTLE_STATE_MAX_TEAM_SIZE][ZobristHash::HP_BUCKETS + 1];
+    quint64 pp[2][BATTLE_STATE_MAX_TEAM_SIZE][ZobristHash::PP_BUCKETS + 1];
+    quint64 stage[2][BATTLE_STATE_MAX_TEAM_SIZE][BATTLE_STATE_STAT_STAGE_COUNT][ZobristHash::STAGE_VALUES];
+    quint64 status[2][BATTLE_STATE_MAX_TEAM_SIZE][ZobristHash::STATUS_VALUES];
+    quint64 active[2][BATTLE_STATE_MAX_TEAM_SIZE];
+
+    ZobristKeys()
+    {
+        BattleRandom random(0x5A4F42524953544FULL);
+        fill(&hp[0][0][0], sizeof(hp), random);
+        fill(&pp[0][0][0], sizeof(pp), random);
+        fill(&stage[0][0][0][0], sizeof(stage), random);
+        fill(&status[0][0][0], sizeof(status), random);
+        fill(&active[0][0], sizeof(active), random);
+    }
+
+    static void fill(quint64 *keys, size_t bytes, BattleRandom &random)
+    {
+        for (size_t i = 0; i < bytes / sizeof(quint64); ++i)
+        {
+            keys[i] = random.next();
+        }
+    }
+};
+
+const ZobristKeys &keys()
+{
+    static const ZobristKeys table; // 局部静态变量的初始化是线程安全的
+    return table;
+}
+
+// 把value按maximum分成buckets档，0单独一档
+int bucketOf(int value, int maximum, int buckets)
+{
+    if (value <= 0 || maximum <= 0) return 0;
+    return 1 + qMin(buckets - 1, static_cast<int>(static_cast<qint64>(value - 1) * buckets / maximum));
+}
+
+const CreatureState &creatureOf(const BattleState &state, int side, int index)
+{
+    return side == 0 ? state.playerTeam[index] : state.opponentTeam[index];
+}
+
+} // namespace
+
+ZobristHash::ZobristHash(const BattleSystem &battle)
+{
+    for (int side = 0; side < 2; ++side)
+    {
+        const QVector<Creature *> team = (side == 0) ? battle.getPlayerTeam() : battle.getOpponentTeam();
+        m_teamSize[side] = qMin(team.size(), BATTLE_STATE_MAX_TEAM_SIZE);
+        for (int i = 0; i < BATTLE_STATE_MAX_TEAM_SIZE; ++i)
+        {
+            const Creature *creature = (i < m_teamSize[side]) ? team[i] : nullptr;
+            m_maxHP[side][i] = creature ? creature->getMaxHP() : 0;
+            m_maxPP[side][i] = creature ? creature->getMaxPP() : 0;
+        }
+    }
+}
+
+quint64 ZobristHash::creatureKey(int side, int index, const CreatureState &creature) const
+{
+    const ZobristKeys &table = keys();
+    quint64 key = table.hp[side][index][bucketOf(creature.currentHP, m_maxHP[side][index], HP_BUCKETS)];
+    // PP的0档与HP不同，不表示濒死，只是PP耗尽
+    key ^= table.pp[side][index][bucketOf(creature.currentPP, m_maxPP[side][index], PP_BUCKETS)];
+    for (int stat = 0; stat < BATTLE_STATE_STAT_STAGE_COUNT; ++stat)
+    {
+        const int stage = qBound(-6, static_cast<int>(creature.statStages[stat]), 6);
+        key ^= table.stage[side][index][stat][stage + 6];
+    }
+    key ^= table.status[side][index][creature.statusCondition % STATUS_VALUES];
+    return key;
+}
+
+quint64 ZobristHash::activeKey(int side, int index) const
+{
+    if (index < 0 || index >= BATTLE_STATE_MAX_TEAM_SIZE) return 0;
+    return keys().active[side][index];
+}
+
+quint64 ZobristHash::hash(const BattleState &state) const
+{
+    quint64 hash = activeKey(0, state.playerActiveIndex) ^ activeKey(1, state.opponentActiveIndex);
+    for (int side = 0; side < 2; ++side)
+    {
+        for (int i = 0; i < m_teamSize[side]; ++i)
+        {
+            hash ^= creatureKey(side, i, creatureOf(state, side, i));
+        }
+    }
+    return hash;
+}
+
+quint64 ZobristHash::update(quint64 hash, const BattleState &before, const BattleState &after) const
+{
+    if (before.playerActiveIndex != after.playerActiveIndex)
+    {
+        hash ^= activeKey(0, before.playerActiveIndex) ^ activeKey(0, after.playerActiveIndex);
+    }
+    if (before.opponentActiveIndex != after.opponentActiveIndex)
+    {
+        hash ^= activeKey(1, before.opponentActiveIndex) ^ activeKey(1, after.opponentActiveIndex);
+    }
+    for (int side = 0; side < 2; ++side)
+    {
+        for (int i = 0; i < m_teamSize[side]; ++i)
+        {
+            const CreatureState &oldCreature = creatureOf(before, side, i);
+            const CreatureState &newCreature = creatureOf(after, side, i);
+            // 一回合内通常只有出场的两只精灵发生变化，其余精灵跳过
+            if (std::memcmp(&oldCreature, &newCreature, sizeof(CreatureState)) != 0)
+            {
+                hash ^= creatureKey(side, i, oldCreature) ^ creatureKey(side, i, newCreature);
+            }
+        }
+    }
+    return hash;
+}
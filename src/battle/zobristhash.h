@@ -0,0 +1,40 @@
+// src/battle/zobristhash.h
+#ifndef ZOBRISTHASH_H
+#define ZOBRISTHASH_H
+
+#include <QtGlobal>
+#include "battlestate.h"
+
+class BattleSystem;
+
+// 战斗局面的Zobrist哈希
+// 特征：每只精灵的HP分档、PP分档、7项能力等级、异常状态，以及双方的出场精灵。
+// 每个特征对应一个固定的64位随机键，局面哈希为所有特征键的异或；
+// 局面变化时只需异或掉变化精灵的旧特征键、再异或进新的（update），不必整体重算。
+// HP/PP按档位而非精确数值计入，数值相近的局面会共用置换表中的结果。
+class ZobristHash
+{
+public:
+    static const int HP_BUCKETS = 16;       // HP按最大值分成的档数（另有一档表示濒死）
+    static const int PP_BUCKETS = 8;        // PP按最大值分成的档数
+    static const int STAGE_VALUES = 13;     // 能力等级 -6..+6
+    static const int STATUS_VALUES = 16;    // 异常状态编号上限
+
+    // 记录双方各精灵的最大HP/PP用于分档；哈希只适用于这场战斗（及其镜像）的快照
+    explicit ZobristHash(const BattleSystem &battle);
+
+    // 整体计算
+    quint64 hash(const BattleState &state) const;
+    // 增量更新：hash为before的哈希，返回after的哈希
+    quint64 update(quint64 hash, const BattleState &before, const BattleState &after) const;
+
+private:
+    quint64 creatureKey(int side, int index, const CreatureState &creature) const;
+    quint64 activeKey(int side, int index) const;
+
+    int m_teamSize[2];
+    int m_maxHP[2][BATTLE_STATE_MAX_TEAM_SIZE];
+    int m_maxPP[2][BATTLE_STATE_MAX_TEAM_SIZE];
+};
+
+#endif // ZOBRISTHASH_H
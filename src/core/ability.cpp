@@ -2,6 +2,7 @@
 #include "ability.h"
 #include <cmath>     // 用于数学函数，例如 std::pow, std::sqrt (虽然这里没直接用，但能力计算可能需要)
 #include <algorithm> // 用于 std::max, std::min
+#include <array>
 
 // --- BaseStats 类实现 ---
 // 构造函数，初始化各项基础属性
@@ -122,39 +123,60 @@ int StatStages::clampStage(int stage) const {
 
 // 静态方法：根据能力类型和等级计算修正乘数
 // 这个修正乘数会应用到基础属性上，得到战斗中的实际属性
-double StatStages::calculateModifier(StatType type, int stage) {
-    if (stage == 0) {
-        return 1.0; // 等级为0，无修正
-    }
+namespace {
+
+// 能力等级-6..+6对应的乘数，下标为stage + 6
+const int STAGE_TABLE_SIZE = 13;
+using StageModifierTable = std::array<double, STAGE_TABLE_SIZE>;
+
+// 攻击、特攻、防御、特防、速度：正向每级+50% (2 -> 2x, 4 -> 3x, 6 -> 4x)，即 (2 + stage) / 2；
+// 负向 -2 时 50% (即1/2)，-4 时 33% (即1/3)，-6 时 25% (即1/4)，即 2 / (2 - stage)
+constexpr double battleStatModifier(int stage) {
+    return stage == 0 ? 1.0
+         : stage > 0  ? (2.0 + stage) / 2.0
+                      : 2.0 / (2.0 - stage);
+}
 
-    // 攻击、特攻、防御、特防、速度 的正向修正：每级+50% (2 -> 2x, 4 -> 3x, 6 -> 4x)
-    // 对应公式： (2 + stage) / 2  或 1.0 + stage * 0.5
-    if (type == StatType::ATTACK || type == StatType::SP_ATTACK ||
-        type == StatType::DEFENSE || type == StatType::SP_DEFENSE ||
-        type == StatType::SPEED) {
-        if (stage > 0) {
-            return (2.0 + stage) / 2.0;
-        } else { // 负向修正，例如 -2 时 50% (即1/2)，-4 时 33% (即1/3)，-6 时 25% (即1/4)
-                 // 对应公式： 2 / (2 - stage)
-            return 2.0 / (2.0 - stage); // stage是负数，所以 2 - (-2) = 4, 2/4 = 0.5
-        }
-    }
-    // 命中和闪避 的修正 (在宝可梦中通常有不同的分数系统，这里按设计文档)
-    // 设计文档：命中+1 -> 1.5x; 命中-1 -> 0.85x, -2 -> 0.70x, -3 -> 0.55x, -4 -> 0.45x, -5 -> 0.35x, -6 -> 0.25x
-    // 闪避通常与命中相反，但这里分开处理，假设闪避等级也用类似方式影响对方命中
-    else if (type == StatType::ACCURACY || type == StatType::EVASION) { // 假设闪避也用此逻辑，但通常闪避是影响对方命中
-        if (stage > 0) { // 正向修正，每级 +50%
-            return 1.0 + (stage * 0.5); // 例如 stage = 1 -> 1.5; stage = 2 -> 2.0
-        } else { // 负向修正 (按设计文档的命中下降规则)
-            if (stage >= -3) { // 命中-1到-3每级减少15%
-                return 1.0 + (stage * 0.15); // stage是负数, e.g., -1 -> 0.85
-            } else { // 命中-4到-6每级减少10% (基于-3时的0.55基础)
-                return 0.55 + ((stage + 3) * 0.10); // e.g., stage = -4 -> 0.55 + (-1*0.1) = 0.45
-            }
-        }
+// 命中和闪避，按设计文档：+1 -> 1.5x; -1 -> 0.85x, -2 -> 0.70x, -3 -> 0.55x, -4 -> 0.45x, -5 -> 0.35x, -6 -> 0.25x
+// 闪避等级也用同样的方式影响对方命中
+constexpr double accuracyModifier(int stage) {
+    return stage == 0  ? 1.0
+         : stage > 0   ? 1.0 + (stage * 0.5)          // 正向每级 +50%
+         : stage >= -3 ? 1.0 + (stage * 0.15)         // -1到-3每级减少15%
+                       : 0.55 + ((stage + 3) * 0.10); // -4到-6每级减少10% (基于-3时的0.55)
+}
+
+constexpr StageModifierTable buildModifierTable(double (*modifier)(int)) {
+    StageModifierTable table{};
+    for (int i = 0; i < STAGE_TABLE_SIZE; ++i) {
+        table[i] = modifier(i - 6);
     }
+    return table;
+}
 
-    return 1.0; // 其他未知类型或HP不参与等级修正
+constexpr StageModifierTable BATTLE_STAT_MODIFIERS = buildModifierTable(battleStatModifier);
+constexpr StageModifierTable ACCURACY_MODIFIERS = buildModifierTable(accuracyModifier);
+
+static_assert(BATTLE_STAT_MODIFIERS[6] == 1.0 && BATTLE_STAT_MODIFIERS[12] == 4.0 && BATTLE_STAT_MODIFIERS[0] == 0.25,
+              "能力等级乘数表错误");
+
+} // namespace
+
+double StatStages::calculateModifier(StatType type, int stage) {
+    const int index = std::max(-6, std::min(stage, 6)) + 6;
+    switch (type) {
+        case StatType::ATTACK:
+        case StatType::SP_ATTACK:
+        case StatType::DEFENSE:
+        case StatType::SP_DEFENSE:
+        case StatType::SPEED:
+            return BATTLE_STAT_MODIFIERS[index];
+        case StatType::ACCURACY:
+        case StatType::EVASION:
+            return ACCURACY_MODIFIERS[index];
+        default:
+            return 1.0; // HP不参与等级修正
+    }
 }
 
 
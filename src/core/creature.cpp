@@ -3,8 +3,8 @@
 #include "../battle/battlesystem.h" // 战斗系统，主要用于效果函数签名
 #include "../battle/effect.h"       // 效果类，用于创建具体效果实例
 #include "../battle/skill.h"        // 技能类，用于技能相关操作
-#include "../battle/specialskills.h" // 特殊技能类，包含第五技能的实现
-#include <QRandomGenerator>         // Qt随机数
+#include "speciescatalog.h"         // 精灵数据目录
+#include <QHash>                    // 种类键名查找表
 #include <QDateTime>                // Qt日期时间 (如果需要)
 #include <QtMath>                   // Qt数学函数 (例如 qMax, qMin)
 
@@ -13,18 +13,22 @@
 // 构造函数
 Creature::Creature(const QString &name, const Type &type, int level)
     : m_name(name),                         // 初始化精灵名称
+      m_speciesId(SpeciesId::NONE),         // 具体种类由createSpecies设置
       m_type(type),                         // 初始化精灵属性
       m_level(qBound(1, level, MAX_LEVEL)), // 初始化等级，并确保在1到MAX_LEVEL之间
       m_experience(0),                      // 初始经验值为0
       // m_baseStats 默认构造 (如果需要，可以在这里或之后设置)
       // m_statStages 默认构造 (全为0)
       // m_talent 默认构造 (全为1)
-      m_fifthSkill(nullptr), // 初始没有第五技能
+      m_skillCount(0),                // 初始没有技能
+      m_fifthSkill(SkillId::NONE),    // 初始没有第五技能
       m_currentHP(1),        // HP相关会在setBaseStats或updateStatsOnLevelUp后正确设置
       m_maxHP(1),
       m_currentPP(8),                          // 初始PP值，根据设计文档设为8
       m_maxPP(8),                              // 最大PP值，根据设计文档设为8
-      m_statusCondition(StatusCondition::NONE) // 初始无异常状态
+      m_statusCondition(StatusCondition::NONE), // 初始无异常状态
+      m_turnEffectCount(0),                     // 初始没有回合效果
+      m_statsDirty(true)
 {
     // 中文注释：精灵基类构造函数
     // name: 精灵名称
@@ -33,26 +37,140 @@ Creature::Creature(const QString &name, const Type &type, int level)
 
     // 通常在构造函数后会立即调用 setBaseStats 和 setTalent
     // 以及学习初始技能
+    for (SkillId &skill : m_skills)
+    {
+        skill = SkillId::NONE;
+    }
 }
 
 // 析构函数
 Creature::~Creature()
 {
     // 中文注释：精灵基类析构函数
-    // 释放动态分配的技能对象
-    qDeleteAll(m_skills); // QVector<Skill*> m_skills;
-    m_skills.clear();
+    // 技能对象由SkillRegistry持有，精灵只保存编号，无需释放
+}
+
+Creature *Creature::clone() const
+{
+    return new Creature(*this);
+}
+
+// 各种类的模板键名，下标即SpeciesId
+static const char *const SPECIES_KEYS[SPECIES_COUNT] = {
+    "TungTungTung", "BombardinoCrocodillo", "TralaleroTralala", "LiriliLarila",
+    "ChimpanziniBananini", "Luguanluguanlulushijiandaole", "CappuccinoAssassino"};
+
+static_assert(CATALOG_SKILL_SLOTS == MAX_SKILL_COUNT, "数据目录的技能槽数须与精灵一致");
+
+// 按种类编号创建具体精灵
+// 数值与技能全部来自数据目录；内置种类构造专属精灵类以保留其特殊行为，构造函数只给出名称与属性
+Creature *Creature::createSpecies(SpeciesId species, int level)
+{
+    const SpeciesCatalog &catalog = SpeciesCatalog::getInstance();
+    const SpeciesRecord *record = catalog.getRecord(static_cast<int>(species));
+    Creature *creature = nullptr;
+    switch (species)
+    {
+    case SpeciesId::TUNG_TUNG_TUNG:               creature = new TungTungTung(level); break;
+    case SpeciesId::BOMBARDINO_CROCODILLO:        creature = new BombardinoCrocodillo(level); break;
+    case SpeciesId::TRALALERO_TRALALA:            creature = new TralaleroTralala(level); break;
+    case SpeciesId::LIRILI_LARILA:                creature = new LiriliLarila(level); break;
+    case SpeciesId::CHIMPANZINI_BANANINI:         creature = new ChimpanziniBananini(level); break;
+    case SpeciesId::LUGUANLUGUANLULUSHIJIANDAOLE: creature = new Luguanluguanlulushijiandaole(level); break;
+    case SpeciesId::CAPPUCCINO_ASSASSINO:         creature = new CappuccinoAssassino(level); break;
+    default:
+        if (record) creature = new Creature(QString(), Type(ElementType::NONE), level); // 只由数据描述的种类
+        break;
+    }
+
+    if (creature)
+    {
+        if (record) creature->applySpeciesRecord(*record);
+        creature->m_speciesId = species;
+        creature->setLevel(level); // 构造时HP只是占位值，与GameEngine::createCreature一致，以满HP/PP出场
+    }
+    return creature; // 未知的精灵种类返回nullptr
+}
+
+// 按模板键名创建具体精灵
+Creature *Creature::createSpecies(const QString &speciesKey, int level)
+{
+    return createSpecies(findSpecies(speciesKey), level);
+}
+
+int Creature::getSpeciesCount()
+{
+    return qMax(SPECIES_COUNT, SpeciesCatalog::getInstance().getSpeciesCount());
+}
 
-    // 释放第五技能对象 (如果存在)
-    if (m_fifthSkill)
+// 获取所有精灵模板键名
+QStringList Creature::getSpeciesKeys()
+{
+    const int count = getSpeciesCount();
+    QStringList keys;
+    keys.reserve(count);
+    for (int i = 0; i < count; ++i)
     {
-        delete m_fifthSkill;
-        m_fifthSkill = nullptr;
+        keys.append(getSpeciesKeyById(static_cast<SpeciesId>(i)));
     }
+    return keys;
+}
+
+// 键名到编号的查找表只构造一次
+SpeciesId Creature::findSpecies(const QString &speciesKey)
+{
+    static const QHash<QString, SpeciesId> speciesByKey = [] {
+        QHash<QString, SpeciesId> table;
+        const int count = getSpeciesCount();
+        for (int i = 0; i < count; ++i)
+        {
+            table.insert(getSpeciesKeyById(static_cast<SpeciesId>(i)), static_cast<SpeciesId>(i));
+        }
+        return table;
+    }();
+    return speciesByKey.value(speciesKey, SpeciesId::NONE);
+}
+
+// 内置种类的键名固定不变（数据目录载入时据此校验顺序），追加种类的键名来自目录
+QString Creature::getSpeciesKeyById(SpeciesId species)
+{
+    const int index = static_cast<int>(species);
+    if (index < SPECIES_COUNT) return QString::fromLatin1(SPECIES_KEYS[index]);
+    const SpeciesCatalog &catalog = SpeciesCatalog::getInstance();
+    const SpeciesRecord *record = catalog.getRecord(index);
+    return record ? QString::fromUtf8(catalog.getString(record->keyOffset)) : QString();
+}
+
+// 记录直接指向映射的目录文件，只在此处换算成精灵的成员；编号越界的项按空值处理
+void Creature::applySpeciesRecord(const SpeciesRecord &record)
+{
+    const auto elementType = [](quint8 value) {
+        return value < ELEMENT_TYPE_COUNT ? static_cast<ElementType>(value) : ElementType::NONE;
+    };
+    const auto skillId = [](quint8 value) {
+        return value < SKILL_ID_COUNT ? static_cast<SkillId>(value) : SkillId::NONE;
+    };
 
-    // 释放所有回合类效果对象
-    qDeleteAll(m_turnEffects); // QVector<TurnBasedEffect*> m_turnEffects;
-    m_turnEffects.clear();
+    m_name = QString::fromUtf8(SpeciesCatalog::getInstance().getString(record.nameOffset));
+    m_type = record.secondaryType == CATALOG_NO_TYPE
+                 ? Type(elementType(record.primaryType))
+                 : Type(elementType(record.primaryType), elementType(record.secondaryType));
+    const qint16 *stats = record.baseStats;
+    const qint16 *talent = record.talent;
+    setBaseStats(BaseStats(stats[0], stats[1], stats[2], stats[3], stats[4], stats[5]));
+    setTalent(Talent(talent[0], talent[1], talent[2], talent[3], talent[4], talent[5]));
+    setMaxPP(record.maxPP);
+
+    for (SkillId &skill : m_skills)
+    {
+        skill = SkillId::NONE;
+    }
+    m_skillCount = 0;
+    for (quint8 skill : record.skills)
+    {
+        learnSkill(skillId(skill)); // learnSkill忽略NONE
+    }
+    setFifthSkill(skillId(record.fifthSkill));
 }
 
 // 获取精灵名称
@@ -61,6 +179,18 @@ QString Creature::getName() const
     return m_name;
 }
 
+// 获取精灵种类
+SpeciesId Creature::getSpeciesId() const
+{
+    return m_speciesId;
+}
+
+// 获取精灵模板键名
+QString Creature::getSpeciesKey() const
+{
+    return getSpeciesKeyById(m_speciesId);
+}
+
 QString Creature::getResourceName() const {
     return m_name.toLower().replace(' ', '_'); // 默认行为：将名称转小写并替换空格
 }
@@ -98,18 +228,16 @@ BaseStats Creature::getBaseStats() const
 // 获取精灵当前战斗中的实际属性 (应用了能力等级修正)
 BaseStats Creature::getCurrentStats() const
 {
-    BaseStats currentStats = m_baseStats; // 从基础属性开始
-
-    // 应用各项能力等级的修正
-    // StatType::HP 通常不参与能力等级修正
-    currentStats.modifyStat(StatType::ATTACK, qRound(m_baseStats.getStat(StatType::ATTACK) * (StatStages::calculateModifier(StatType::ATTACK, m_statStages.getStage(StatType::ATTACK)) - 1.0)));
-    currentStats.modifyStat(StatType::DEFENSE, qRound(m_baseStats.getStat(StatType::DEFENSE) * (StatStages::calculateModifier(StatType::DEFENSE, m_statStages.getStage(StatType::DEFENSE)) - 1.0)));
-    currentStats.modifyStat(StatType::SP_ATTACK, qRound(m_baseStats.getStat(StatType::SP_ATTACK) * (StatStages::calculateModifier(StatType::SP_ATTACK, m_statStages.getStage(StatType::SP_ATTACK)) - 1.0)));
-    currentStats.modifyStat(StatType::SP_DEFENSE, qRound(m_baseStats.getStat(StatType::SP_DEFENSE) * (StatStages::calculateModifier(StatType::SP_DEFENSE, m_statStages.getStage(StatType::SP_DEFENSE)) - 1.0)));
-    currentStats.modifyStat(StatType::SPEED, qRound(m_baseStats.getStat(StatType::SPEED) * (StatStages::calculateModifier(StatType::SPEED, m_statStages.getStage(StatType::SPEED)) - 1.0)));
+    // 应用各项能力等级的修正，StatType::HP 不参与能力等级修正
     // 命中和闪避的修正在战斗系统判定时应用，不直接修改属性值
-
-    return currentStats;
+    if (m_statsDirty)
+        refreshStats();
+    return BaseStats(m_baseStats.getStat(StatType::HP),
+                     m_stagedStats[static_cast<int>(StatType::ATTACK)],
+                     m_stagedStats[static_cast<int>(StatType::SP_ATTACK)],
+                     m_stagedStats[static_cast<int>(StatType::DEFENSE)],
+                     m_stagedStats[static_cast<int>(StatType::SP_DEFENSE)],
+                     m_stagedStats[static_cast<int>(StatType::SPEED)]);
 }
 
 // 获取精灵当前的能力等级阶段 (如物攻+1, 速度-2等)
@@ -134,6 +262,7 @@ StatusCondition Creature::getStatusCondition() const
 void Creature::setBaseStats(const BaseStats &stats)
 {
     m_baseStats = stats;
+    invalidateStats();
     // 当基础属性设定后，需要更新最大HP，并确保当前HP不超过最大HP
     m_maxHP = m_baseStats.getStat(StatType::HP);
     m_currentHP = qMin(m_currentHP, m_maxHP); // 如果之前HP高于新的maxHP，则调整
@@ -313,134 +442,221 @@ void Creature::setStatusCondition(StatusCondition condition)
 {
     // TODO: 添加逻辑，例如某些状态不能覆盖其他状态，或某些属性免疫特定状态
     m_statusCondition = condition;
+    invalidateStats();
 }
 
 // 清除精灵的异常状态
 void Creature::clearStatusCondition()
 {
     m_statusCondition = StatusCondition::NONE;
+    invalidateStats();
 }
 
 // 修改精灵的能力等级
 void Creature::modifyStatStage(StatType stat, int delta)
 {
     m_statStages.modifyStage(stat, delta);
+    invalidateStats();
 }
 
 // 重置精灵所有能力等级变化为0
 void Creature::resetStatStages()
 {
     m_statStages.reset();
+    invalidateStats();
 }
 
 // 精灵学习新技能 (最多4个普通技能)
-void Creature::learnSkill(Skill *skill)
+void Creature::learnSkill(SkillId skill)
 {
-    if (skill)
+    if (skill != SkillId::NONE)
     {
-        if (m_skills.size() < 4) // 如果技能槽未满
-        {
-            m_skills.append(skill);
-        }
-        else
+        if (m_skillCount < MAX_SKILL_COUNT) // 如果技能槽未满
         {
-            // 技能槽已满，处理替换逻辑或提示 (通常在UI层面处理选择替换哪个)
-            // qWarning() << m_name << "的技能槽已满，无法学习" << skill->getName();
-            delete skill; // 如果不学习，释放传入的技能对象内存
+            m_skills[m_skillCount++] = skill;
         }
+        // 技能槽已满，处理替换逻辑或提示 (通常在UI层面处理选择替换哪个)
     }
 }
 
 // 精灵忘记技能
 void Creature::forgetSkill(int index)
 {
-    if (index >= 0 && index < m_skills.size())
+    if (index >= 0 && index < m_skillCount)
     {
-        delete m_skills.takeAt(index); // 从列表中移除并删除对象
+        for (int i = index + 1; i < m_skillCount; ++i)
+        {
+            m_skills[i - 1] = m_skills[i];
+        }
+        m_skills[--m_skillCount] = SkillId::NONE;
     }
 }
 
-// 检查精灵是否已学会某个名称的技能
-bool Creature::hasSkill(const QString &skillName) const
+// 检查精灵是否已学会某个技能（含第五技能）
+bool Creature::hasSkill(SkillId skill) const
 {
-    for (const Skill *skill : m_skills)
+    if (skill == SkillId::NONE)
+        return false;
+    for (int i = 0; i < m_skillCount; ++i)
     {
-        if (skill && skill->getName() == skillName)
+        if (m_skills[i] == skill)
             return true;
     }
-    if (m_fifthSkill && m_fifthSkill->getName() == skillName)
-        return true;
-    return false;
+    return m_fifthSkill == skill;
+}
+
+// 检查精灵是否已学会某个名称的技能
+bool Creature::hasSkill(const QString &skillName) const
+{
+    return hasSkill(SkillRegistry::getInstance().findByName(skillName));
 }
 
 // 获取指定索引的技能
 Skill *Creature::getSkill(int index) const
 {
-    if (index >= 0 && index < m_skills.size())
+    if (index >= 0 && index < m_skillCount)
     {
-        return m_skills[index];
+        return SkillRegistry::getInstance().getSkill(m_skills[index]);
     }
     return nullptr;
 }
 
+// 获取指定索引的技能编号，越界返回NONE
+SkillId Creature::getSkillId(int index) const
+{
+    return (index >= 0 && index < m_skillCount) ? m_skills[index] : SkillId::NONE;
+}
+
 // 获取所有普通技能的列表
 QVector<Skill *> Creature::getSkills() const
 {
-    return m_skills;
+    QVector<Skill *> skills;
+    skills.reserve(m_skillCount);
+    for (int i = 0; i < m_skillCount; ++i)
+    {
+        skills.append(getSkill(i));
+    }
+    return skills;
 }
 
 // 获取已学会的普通技能数量
 int Creature::getSkillCount() const
 {
-    return m_skills.size();
+    return m_skillCount;
 }
 
-// 设置第五技能
-void Creature::setFifthSkill(Skill *skill)
+// 设置第五技能（NONE为移除）
+void Creature::setFifthSkill(SkillId skill)
 {
-    if (m_fifthSkill) // 如果已有第五技能，则替换并删除旧的
-    {
-        delete m_fifthSkill;
-    }
-    m_fifthSkill = skill; // 设置新的第五技能
+    m_fifthSkill = skill;
 }
 
 // 获取第五技能
 Skill *Creature::getFifthSkill() const
+{
+    return SkillRegistry::getInstance().getSkill(m_fifthSkill);
+}
+
+SkillId Creature::getFifthSkillId() const
 {
     return m_fifthSkill;
 }
 
 // 添加回合类效果到精灵身上
-void Creature::addTurnEffect(TurnBasedEffect *effect)
+// 同一施加者再次施加同种效果时刷新已有记录，不占用新的效果槽
+bool Creature::addTurnEffect(const TurnEffectSlot &effect)
 {
-    if (effect)
+    for (int i = 0; i < m_turnEffectCount; ++i)
     {
-        // TODO: 检查是否已有同类效果，是否可叠加等逻辑
-        m_turnEffects.append(effect);
+        TurnEffectSlot &existing = m_turnEffects[i];
+        if (existing.kind == effect.kind && existing.sourceSide == effect.sourceSide &&
+            existing.sourceIndex == effect.sourceIndex)
+        {
+            existing.flags = effect.flags;
+            existing.duration = effect.duration;
+            existing.param = effect.param;
+            return true;
+        }
     }
+    if (m_turnEffectCount >= BATTLE_STATE_MAX_EFFECT_SLOTS)
+        return false; // 效果槽已满
+    m_turnEffects[m_turnEffectCount++] = effect;
+    return true;
 }
 
-// 移除一个特定的回合类效果
-void Creature::removeTurnEffect(TurnBasedEffect *effect)
+// 移除一个回合类效果，后面的效果依次前移以保持施加顺序
+void Creature::removeTurnEffectAt(int index)
 {
-    if (m_turnEffects.removeAll(effect) > 0)
-    {                  // 从列表中移除所有匹配的指针
-        delete effect; // 释放效果对象内存
-    }
+    for (int i = index + 1; i < m_turnEffectCount; ++i)
+        m_turnEffects[i - 1] = m_turnEffects[i];
+    --m_turnEffectCount;
 }
 
 // 清除所有回合类效果
 void Creature::clearAllTurnEffects()
 {
-    qDeleteAll(m_turnEffects); // 删除所有效果对象
-    m_turnEffects.clear();     // 清空列表
+    m_turnEffectCount = 0;
+}
+
+// 是否带有某种回合效果
+bool Creature::hasTurnEffect(TurnEffectKind kind) const
+{
+    for (int i = 0; i < m_turnEffectCount; ++i)
+    {
+        if (m_turnEffects[i].kind == kind)
+            return true;
+    }
+    return false;
+}
+
+// 导出精灵的战斗状态到扁平快照
+void Creature::exportState(CreatureState &state) const
+{
+    state.currentHP = m_currentHP;
+    state.currentPP = m_currentPP;
+    for (int i = 0; i < BATTLE_STATE_STAT_STAGE_COUNT; ++i)
+    {
+        // statStages按StatType::ATTACK起的顺序存放（跳过HP）
+        state.statStages[i] = static_cast<qint8>(m_statStages.getStage(static_cast<StatType>(i + 1)));
+    }
+    state.statusCondition = static_cast<quint8>(m_statusCondition);
+    state.effectCount = static_cast<quint8>(m_turnEffectCount);
+    for (int i = 0; i < BATTLE_STATE_MAX_EFFECT_SLOTS; ++i)
+    {
+        // 未使用的槽位清零，快照内容只取决于有效状态
+        state.effects[i] = (i < m_turnEffectCount) ? m_turnEffects[i] : TurnEffectSlot();
+    }
+    for (int i = 0; i < BATTLE_STATE_SPECIES_WORDS; ++i)
+        state.speciesState[i] = 0;
+    exportSpeciesState(state.speciesState);
+}
+
+// 从扁平快照恢复精灵的战斗状态
+void Creature::importState(const CreatureState &state)
+{
+    m_currentHP = state.currentHP;
+    m_currentPP = state.currentPP;
+    for (int i = 0; i < BATTLE_STATE_STAT_STAGE_COUNT; ++i)
+    {
+        m_statStages.setStage(static_cast<StatType>(i + 1), state.statStages[i]);
+    }
+    m_statusCondition = static_cast<StatusCondition>(state.statusCondition);
+    m_turnEffectCount = qMin(static_cast<int>(state.effectCount), BATTLE_STATE_MAX_EFFECT_SLOTS);
+    for (int i = 0; i < m_turnEffectCount; ++i)
+        m_turnEffects[i] = state.effects[i];
+    invalidateStats();
+    importSpeciesState(state.speciesState);
+}
+
+// 基类没有种类私有状态
+void Creature::exportSpeciesState(qint32 words[BATTLE_STATE_SPECIES_WORDS]) const
+{
+    Q_UNUSED(words);
 }
 
-// 获取精灵当前所有的回合类效果
-QVector<TurnBasedEffect *> Creature::getTurnEffects() const
+void Creature::importSpeciesState(const qint32 words[BATTLE_STATE_SPECIES_WORDS])
 {
-    return m_turnEffects;
+    Q_UNUSED(words);
 }
 
 // 精灵使用技能 (核心逻辑委托给Skill对象和BattleSystem)
@@ -448,13 +664,13 @@ bool Creature::useSkill(int skillIndex, Creature *target, BattleSystem *battle)
 {
     Skill *selectedSkill = nullptr;
 
-    if (skillIndex >= 0 && skillIndex < m_skills.size()) // 选择普通技能
+    if (skillIndex >= 0 && skillIndex < m_skillCount) // 选择普通技能
     {
-        selectedSkill = m_skills[skillIndex];
+        selectedSkill = getSkill(skillIndex);
     }
-    else if (skillIndex == -1 && m_fifthSkill) // 选择第五技能 (约定-1为第五技能)
+    else if (skillIndex == -1) // 选择第五技能 (约定-1为第五技能)
     {
-        selectedSkill = m_fifthSkill;
+        selectedSkill = getFifthSkill();
     }
 
     if (selectedSkill && target && battle) // 确保技能、目标和战斗系统都有效
@@ -472,14 +688,14 @@ void Creature::onTurnStart(BattleSystem* battle)
 {
     // 中文注释：精灵回合开始时的逻辑处理
 
-    // 1. 处理回合类效果的开始阶段逻辑
-    // 创建一个副本进行迭代，防止在迭代过程中修改m_turnEffects导致问题
-    QVector<TurnBasedEffect *> effectsToProcess = m_turnEffects;
-    for (TurnBasedEffect *effect : effectsToProcess)
+    // 1. 处理回合类效果的开始阶段逻辑（持续回合统一在回合结束时扣减）
+    // 前一个效果可能已使精灵倒下并清除了所有效果，因此每次都与当前数量比较
+    for (int i = 0; i < m_turnEffectCount; ++i)
     {
-        if (effect && effect->isOnTurnStart()) // 如果效果是在回合开始时触发
+        if (m_turnEffects[i].flags & TURN_EFFECT_ON_TURN_START) // 如果效果是在回合开始时触发
         {
-            effect->executeTurnLogic(this, nullptr, nullptr); // 传入当前精灵和战斗系统 (源精灵和战斗系统可根据需要传递)
+            const TurnEffectSlot effect = m_turnEffects[i]; // 执行期间效果槽可能增减，传入副本
+            executeTurnEffect(effect, this, battle);
         }
     }
 
@@ -489,7 +705,7 @@ void Creature::onTurnStart(BattleSystem* battle)
     case StatusCondition::SLEEP:
         // 睡眠状态有几率苏醒，或持续固定回合
         // 此处简化：假设睡眠有25%几率当回合苏醒
-        if (QRandomGenerator::global()->bounded(100) < 25)
+        if ((battle ? battle->getRandom() : BattleRandom::threadFallback()).bounded(100) < 25)
         {
             // battle->addBattleLog(QString("%1 从睡眠中苏醒了!").arg(m_name));
             clearStatusCondition();
@@ -530,86 +746,107 @@ void Creature::onTurnEnd(BattleSystem* battle)
             // 其他状态效果...
         }
     }    
-    // 执行回合结束时的持续效果
-    QVector<TurnBasedEffect*> effectsToProcess = m_turnEffects;
-    for (TurnBasedEffect* effect : effectsToProcess) {
-        if (effect && !effect->isOnTurnStart()) {
-            effect->executeTurnLogic(this, effect->getOriginalSource(), battle);
-            if (effect->decrementDuration()) {
-                // 效果已结束
-                if (battle) {
-                    // 使用triggerEffectCleared而不是直接添加日志
-                    battle->triggerEffectCleared(this, effect->getDescription());
-                }
-                removeTurnEffect(effect); // 使用安全删除方法
+    // 执行回合结束时的持续效果，并扣减所有效果的持续回合
+    for (int i = 0; i < m_turnEffectCount;) {
+        if (!(m_turnEffects[i].flags & TURN_EFFECT_ON_TURN_START)) {
+            const TurnEffectSlot current = m_turnEffects[i]; // 执行期间效果槽可能增减，传入副本
+            executeTurnEffect(current, this, battle);
+            // 效果逻辑本身可能使精灵倒下，takeDamage会清除所有回合效果
+            if (i >= m_turnEffectCount) break;
+        }
+        TurnEffectSlot &effect = m_turnEffects[i]; // 执行后重新读取
+        if (effect.duration > 0) --effect.duration;
+        if (effect.duration <= 0) {
+            // 效果已结束
+            if (battle && battle->isBattleLogEnabled()) {
+                // 使用triggerEffectCleared而不是直接添加日志
+                battle->triggerEffectCleared(this, getTurnEffectDescription(effect));
             }
+            removeTurnEffectAt(i);
+        } else {
+            ++i;
         }
     }
     
     // 检查濒死状态
     if (m_currentHP <= 0 && battle) {
-        battle->addBattleLog(QString("<font color='red'><b>%1 倒下了!</b></font>").arg(m_name));
+        battle->addBattleEvent(BattleEventKind::FAINTED, this);
     }
 }
 
 // --- 计算类方法 ---
 
-// 计算当前实际物理攻击力
-int Creature::calculateAttack() const
+// 能力值变化后使缓存失效
+void Creature::invalidateStats()
 {
-    // 基础物攻 * 能力等级修正 * 其他修正(如烧伤)
-    double baseAtk = static_cast<double>(m_baseStats.getStat(StatType::ATTACK));
-    double modifier = StatStages::calculateModifier(StatType::ATTACK, m_statStages.getStage(StatType::ATTACK));
-    int finalAtk = qRound(baseAtk * modifier);
+    m_statsDirty = true;
+}
 
-    // 烧伤状态会使物理攻击减半
-    if (m_statusCondition == StatusCondition::BURN)
+// 重新计算实际能力值缓存
+void Creature::refreshStats() const
+{
+    for (int i = static_cast<int>(StatType::ATTACK); i <= static_cast<int>(StatType::SPEED); ++i)
     {
-        finalAtk /= 2;
+        const StatType type = static_cast<StatType>(i);
+        const int base = m_baseStats.getStat(type);
+        const double modifier = StatStages::calculateModifier(type, m_statStages.getStage(type));
+        // 基础值 * 能力等级修正
+        m_effectiveStats[i] = qRound(base * modifier);
+        m_stagedStats[i] = base + qRound(base * (modifier - 1.0));
     }
-    return qMax(1, finalAtk); // 至少为1
+    m_effectiveStats[static_cast<int>(StatType::HP)] = m_baseStats.getStat(StatType::HP);
+    m_stagedStats[static_cast<int>(StatType::HP)] = m_baseStats.getStat(StatType::HP);
+
+    // 烧伤状态会使物理攻击减半
+    if (m_statusCondition == StatusCondition::BURN)
+        m_effectiveStats[static_cast<int>(StatType::ATTACK)] /= 2;
+    // 麻痹状态会使速度减半
+    if (m_statusCondition == StatusCondition::PARALYZE)
+        m_effectiveStats[static_cast<int>(StatType::SPEED)] /= 2;
+
+    for (int i = static_cast<int>(StatType::ATTACK); i <= static_cast<int>(StatType::SPEED); ++i)
+        m_effectiveStats[i] = qMax(1, m_effectiveStats[i]); // 至少为1
+    m_statsDirty = false;
+}
+
+// 计算当前实际物理攻击力（含烧伤修正）
+int Creature::calculateAttack() const
+{
+    if (m_statsDirty)
+        refreshStats();
+    return m_effectiveStats[static_cast<int>(StatType::ATTACK)];
 }
 
 // 计算当前实际特殊攻击力
 int Creature::calculateSpecialAttack() const
 {
-    double baseSpAtk = static_cast<double>(m_baseStats.getStat(StatType::SP_ATTACK));
-    double modifier = StatStages::calculateModifier(StatType::SP_ATTACK, m_statStages.getStage(StatType::SP_ATTACK));
-    int finalSpAtk = qRound(baseSpAtk * modifier);
-    return qMax(1, finalSpAtk);
+    if (m_statsDirty)
+        refreshStats();
+    return m_effectiveStats[static_cast<int>(StatType::SP_ATTACK)];
 }
 
 // 计算当前实际物理防御力
 int Creature::calculateDefense() const
 {
-    double baseDef = static_cast<double>(m_baseStats.getStat(StatType::DEFENSE));
-    double modifier = StatStages::calculateModifier(StatType::DEFENSE, m_statStages.getStage(StatType::DEFENSE));
-    int finalDef = qRound(baseDef * modifier);
-    return qMax(1, finalDef);
+    if (m_statsDirty)
+        refreshStats();
+    return m_effectiveStats[static_cast<int>(StatType::DEFENSE)];
 }
 
 // 计算当前实际特殊防御力
 int Creature::calculateSpecialDefense() const
 {
-    double baseSpDef = static_cast<double>(m_baseStats.getStat(StatType::SP_DEFENSE));
-    double modifier = StatStages::calculateModifier(StatType::SP_DEFENSE, m_statStages.getStage(StatType::SP_DEFENSE));
-    int finalSpDef = qRound(baseSpDef * modifier);
-    return qMax(1, finalSpDef);
+    if (m_statsDirty)
+        refreshStats();
+    return m_effectiveStats[static_cast<int>(StatType::SP_DEFENSE)];
 }
 
-// 计算当前实际速度
+// 计算当前实际速度（含麻痹修正）
 int Creature::calculateSpeed() const
 {
-    double baseSpeed = static_cast<double>(m_baseStats.getStat(StatType::SPEED));
-    double modifier = StatStages::calculateModifier(StatType::SPEED, m_statStages.getStage(StatType::SPEED));
-    int finalSpeed = qRound(baseSpeed * modifier);
-
-    // 麻痹状态会使速度减半
-    if (m_statusCondition == StatusCondition::PARALYZE)
-    {
-        finalSpeed /= 2;
-    }
-    return qMax(1, finalSpeed);
+    if (m_statsDirty)
+        refreshStats();
+    return m_effectiveStats[static_cast<int>(StatType::SPEED)];
 }
 
 // 计算指定技能属性对目标精灵的克制倍率
@@ -618,10 +855,8 @@ double Creature::getTypeEffectivenessAgainst(const Creature *target, ElementType
     if (!target)
         return 1.0; // 如果没有目标，则无克制关系
 
-    Type attackerSkillType(skillType);             // 攻击技能的属性
-    Type defenderCreatureType = target->getType(); // 防守方精灵的属性
-
-    return Type::calculateEffectiveness(attackerSkillType, defenderCreatureType); // 调用Type类的静态方法计算
+    // 技能总是单属性，直接查预先算好的 攻击属性 × 防守方属性 系数表
+    return Type::getEffectivenessAgainst(skillType, target->getType());
 }
 
 // 判断技能是否与自身属性之一相同 (用于STAB加成)
@@ -658,6 +893,7 @@ void Creature::updateStatsOnLevelUp()
     m_baseStats.setStat(StatType::SP_ATTACK, m_baseStats.getStat(StatType::SP_ATTACK) + m_talent.getGrowthRate(StatType::SP_ATTACK));
     m_baseStats.setStat(StatType::SP_DEFENSE, m_baseStats.getStat(StatType::SP_DEFENSE) + m_talent.getGrowthRate(StatType::SP_DEFENSE));
     m_baseStats.setStat(StatType::SPEED, m_baseStats.getStat(StatType::SPEED) + m_talent.getGrowthRate(StatType::SPEED));
+    invalidateStats();
 
     // 更新最大HP，并完全恢复HP和PP
     m_maxHP = m_baseStats.getStat(StatType::HP);
@@ -686,33 +922,7 @@ TungTungTung::TungTungTung(int level)
     : Creature("Tung Tung Tung Tung Sahur", Type(ElementType::NORMAL), level) // 调用基类构造
 {
     // 中文注释：木棍人 特化构造
-
-    // 设置木棍人的基础属性 (种族值)
-    // HP, 物攻, 特攻, 物防, 特防, 速度
-    setBaseStats(BaseStats(100, 130, 60, 90, 70, 80)); // 假设这是1级时的基础值或种族值
-    // 天赋 (影响升级成长) HP, ATK, SPA, DEF, SPD, SPE
-    setTalent(Talent(10, 15, 5, 8, 7, 9)); // 假设这些是每级成长点数的天赋系数
-
-    // 根据当前等级调整属性 (如果setBaseStats只是设定种族值)
-    // updateStatsForLevel(); // 需要一个这样的方法
-
-    // 学习初始技能
-    learnSkill(new PhysicalSkill("猛力挥击", ElementType::NORMAL, 130, 3, 95));
-    learnSkill(new MultiHitSkill("三重连打", ElementType::NORMAL, SkillCategory::PHYSICAL, 60, 4, 90, 3, 3)); // 3次60威力
-
-    StatusSkill *hardenWoodBody = new StatusSkill("硬化木身", ElementType::NORMAL, 3, 100); // 命中100表示对自己使用通常必中
-    hardenWoodBody->addEffect(new StatChangeEffect(StatType::DEFENSE, 3, true));            // 提升自身物防+3
-    hardenWoodBody->addEffect(new StatChangeEffect(StatType::SP_DEFENSE, 3, true));         // 提升自身特防+3
-    learnSkill(hardenWoodBody);
-
-    CompositeSkill *armorPierceThrust = new CompositeSkill("破甲直刺", ElementType::NORMAL, SkillCategory::PHYSICAL, 70, 3, 100);
-    armorPierceThrust->setEffectChance(80);                                                      // 80%的触发几率
-    armorPierceThrust->addEffect(new StatChangeEffect(StatType::DEFENSE, -2, false));            // false表示对目标
-    armorPierceThrust->addEffect(new ClearEffectsEffect(true, false, false, false, false, 100)); // 清除目标能力提升状态
-    learnSkill(armorPierceThrust);
-
-    // 第五技能: 不屈战魂
-    setFifthSkill(new IndomitableSpiritSkill());
+    // 种族值、天赋与技能见data/species.json，由createSpecies从数据目录写入
 }
 
 void TungTungTung::onTurnStart(BattleSystem* battle) { 
@@ -728,31 +938,6 @@ BombardinoCrocodillo::BombardinoCrocodillo(int level)
     : Creature("BombardinoCrocodillo", Type(ElementType::FLYING, ElementType::MACHINE), level)
 {
     // 中文注释：鳄鱼轰炸机 特化构造
-    setBaseStats(BaseStats(90, 115, 70, 100, 80, 95));
-    setTalent(Talent(9, 12, 7, 11, 8, 10));
-
-    // 钢翼切割
-    CompositeSkill *steelWing = new CompositeSkill("钢翼切割", ElementType::MACHINE, SkillCategory::PHYSICAL, 75, 3, 95);
-    steelWing->setEffectChance(50);                                         // 50%几率
-    steelWing->addEffect(new StatChangeEffect(StatType::DEFENSE, 1, true)); // 提升自身物防+1
-    learnSkill(steelWing);
-
-    // 俯冲轰炸
-    CompositeSkill *diveBomb = new CompositeSkill("俯冲轰炸", ElementType::FLYING, SkillCategory::PHYSICAL, 120, 4, 90);
-    // 使用后下一回合自身无法行动 -> 通过添加一个持续1回合的TIRED状态实现
-    diveBomb->addEffect(new StatusConditionEffect(StatusCondition::TIRED, 100)); // 100%对自己施加疲惫
-    diveBomb->getEffects().first()->setTargetSelf(true);                         // 确保疲惫效果作用于自身
-    learnSkill(diveBomb);
-
-    CompositeSkill *alligatorFang = new CompositeSkill("鳄牙撕咬", ElementType::WATER, SkillCategory::PHYSICAL, 80, 3, 100);
-    alligatorFang->setEffectChance(20);
-    alligatorFang->addEffect(new StatusConditionEffect(StatusCondition::FEAR, 100)); // 100%几率在20%命中时触发害怕
-    learnSkill(alligatorFang);
-
-    learnSkill(new SpecialSkill("锁定导弹", ElementType::MACHINE, 80, 3, 101)); // 101命中视为必中
-
-    // 第五技能: 空域压制
-    setFifthSkill(new AirspaceSupremacySkill());
 }
 void BombardinoCrocodillo::onTurnStart(BattleSystem* battle) {
     Creature::onTurnStart(battle);
@@ -767,22 +952,6 @@ TralaleroTralala::TralaleroTralala(int level)
     : Creature("TralaleroTralala", Type(ElementType::WATER, ElementType::SHADOW), level)
 {
     // 中文注释：耐克鲨鱼 特化构造
-    setBaseStats(BaseStats(75, 100, 110, 60, 70, 125));
-    setTalent(Talent(8, 10, 11, 6, 7, 14));
-
-    learnSkill(new PhysicalSkill("暗影偷袭", ElementType::SHADOW, 40, 2, 100, 1)); // 先制+1
-
-    // 激流勇进: 自身HP低于1/3时，威力提升50% (这个逻辑需要在Skill::getPower()重写或BattleSystem中处理)
-    learnSkill(new SpecialSkill("激流勇进", ElementType::WATER, 80, 3, 100));
-
-    learnSkill(new SpecialSkill("速度之星", ElementType::NORMAL, 60, 2, 101)); // 必中
-
-    StatusSkill *opportunist = new StatusSkill("伺机待发", ElementType::SHADOW, 2, 100);
-    opportunist->addEffect(new StatChangeEffect(StatType::SPEED, 2, true));
-    learnSkill(opportunist);
-
-    // 第五技能: 极速掠食
-    setFifthSkill(new LifeSiphonFieldSkill());
 }
 void TralaleroTralala::onTurnStart(BattleSystem* battle) {
     Creature::onTurnStart(battle);
@@ -796,63 +965,6 @@ LiriliLarila::LiriliLarila(int level)
     : Creature("LiriliLarila", Type(ElementType::GRASS, ElementType::GROUND), level)
 {
     // 中文注释：仙人掌大象 特化构造
-    setBaseStats(BaseStats(120, 90, 75, 110, 100, 55));
-    setTalent(Talent(12, 9, 8, 12, 10, 6));
-
-    // 寄生种子
-    StatusSkill *leechSeed = new StatusSkill("寄生种子", ElementType::GRASS, 2, 90);
-    auto leechSeedLambda = [](Creature *affected, Creature *source, BattleSystem *battle, TurnBasedEffect *effect)
-    {
-        // 检查战斗状态和对象有效性
-        if (!source || !affected || !battle || 
-            affected->isDead() || battle->getBattleResult() != BattleResult::ONGOING)
-            return;
-
-
-        int leechAmount = affected->getMaxHP() / 8;
-        affected->takeDamage(leechAmount);
-        
-        // 使用battle系统的触发器记录伤害
-        if (battle) {
-            battle->triggerDamageCaused(affected, leechAmount);
-        }
-
-        // 再次检查战斗状态
-        if (battle->getBattleResult() != BattleResult::ONGOING)
-            return;
-
-        // 只有当源生物存活时才尝试治疗
-        if (!source->isDead()) {
-            source->heal(leechAmount);
-            // 再次检查战斗状态
-            if (battle->getBattleResult() != BattleResult::ONGOING)
-                return;
-            battle->triggerHealingReceived(source, leechAmount);
-        }
-    };
-    TurnBasedEffect *leechEffect = new TurnBasedEffect(999, leechSeedLambda, false);
-    leechEffect->setDescription("寄生种子效果");
-    leechEffect->setTargetSelf(false);  // 效果应该作用于对手
-    leechEffect->setOriginalSource(nullptr);  // 在apply时自动设置
-    leechSeed->addEffect(leechEffect);
-    learnSkill(leechSeed);
-
-    // 沙尘尖刺 (Entry Hazard，需要在BattleSystem中特殊处理)
-    learnSkill(new StatusSkill("沙尘尖刺", ElementType::GROUND, 3, 100));
-
-    CompositeSkill *thornArmSlam = new CompositeSkill("针刺臂膀", ElementType::GRASS, SkillCategory::PHYSICAL, 70, 3, 100);
-    thornArmSlam->setEffectChance(30);
-    thornArmSlam->addEffect(new StatusConditionEffect(StatusCondition::POISON, 100));
-    learnSkill(thornArmSlam);
-
-    CompositeSkill *earthShaker = new CompositeSkill("大地摇晃", ElementType::GROUND, SkillCategory::SPECIAL, 90, 3, 100);
-    earthShaker->setEffectChance(10);
-    earthShaker->addEffect(new StatChangeEffect(StatType::SP_DEFENSE, -1, false));
-    learnSkill(earthShaker);
-
-    // 第五技能: 生命汲取领域
-    setFifthSkill(new LifeSiphonFieldSkill());
-
 }
 void LiriliLarila::onTurnStart(BattleSystem* battle) { Creature::onTurnStart(battle); }
 void LiriliLarila::onTurnEnd(BattleSystem* battle) { Creature::onTurnEnd(battle); }
@@ -862,22 +974,6 @@ ChimpanziniBananini::ChimpanziniBananini(int level)
     : Creature("ChimpanziniBananini", Type(ElementType::GRASS, ElementType::NORMAL), level),
       m_inBerserkForm(false), m_berserkFormDuration(0)
 {
-    setBaseStats(BaseStats(100, 125, 60, 95, 80, 90));
-    setTalent(Talent(10, 13, 6, 10, 8, 9));
-
-    learnSkill(new PhysicalSkill("香蕉猛击", ElementType::GRASS, 85, 3, 100));
-    learnSkill(new PhysicalSkill("巨力冲拳", ElementType::NORMAL, 90, 3, 95));
-    StatusSkill *jungleFortitude = new StatusSkill("丛林坚壁", ElementType::GRASS, 2, 100);
-    jungleFortitude->addEffect(new StatChangeEffect(StatType::DEFENSE, 2, true));
-    learnSkill(jungleFortitude);
-    StatusSkill *primalRoar = new StatusSkill("野性咆哮", ElementType::NORMAL, 2, 100);
-    primalRoar->addEffect(new StatChangeEffect(StatType::ATTACK, -1, false));
-    primalRoar->addEffect(new StatChangeEffect(StatType::DEFENSE, -1, false));
-    learnSkill(primalRoar);
-
-    learnSkill(new PrimalShiftSkill()); // 使用自定义的变身技能
-
-    setFifthSkill(new JungleKingStrikeSkill());
 }
 // 狂暴形态相关方法
 void ChimpanziniBananini::enterBerserkForm(int duration)
@@ -913,59 +1009,97 @@ void ChimpanziniBananini::onTurnEnd(BattleSystem* battle) {
         m_berserkFormDuration--;
         if (m_berserkFormDuration <= 0) {
             exitBerserkForm();
-            if (battle) {
+            if (battle && battle->isBattleLogEnabled()) {
                 battle->addBattleLog(QString("%1 的狂暴形态结束了!").arg(getName()));
             }
         }
     }
 }
 
+// 狂暴形态是否开启及剩余回合
+void ChimpanziniBananini::exportSpeciesState(qint32 words[BATTLE_STATE_SPECIES_WORDS]) const
+{
+    words[0] = m_inBerserkForm ? 1 : 0;
+    words[1] = m_berserkFormDuration;
+}
+void ChimpanziniBananini::importSpeciesState(const qint32 words[BATTLE_STATE_SPECIES_WORDS])
+{
+    m_inBerserkForm = words[0] != 0;
+    m_berserkFormDuration = words[1];
+}
+
 // Luguanluguanlulushijiandaole（鹿管鹿管鹿鹿时间到了）构造函数
 Luguanluguanlulushijiandaole::Luguanluguanlulushijiandaole(int level)
     : Creature("Luguanluguanlulushijiandaole", Type(ElementType::LIGHT, ElementType::NORMAL), level),
-      m_snapshotTurnsLeft(0)
+      m_rewindTurn(0),
+      m_tiredUntilTurn(0)
 {
     // 中文注释：鹿管鹿管鹿鹿时间到了 特化构造
-    setBaseStats(BaseStats(80, 70, 110, 75, 90, 105));
-    setTalent(Talent(8, 7, 12, 8, 10, 11));
-
-    CompositeSkill *temporalRay = new CompositeSkill("时光射线", ElementType::LIGHT, SkillCategory::SPECIAL, 70, 3, 100);
-    temporalRay->setEffectChance(20);
-    temporalRay->addEffect(new StatChangeEffect(StatType::SPEED, -1, false));
-    learnSkill(temporalRay);
-
-    StatusSkill *rewindHeal = new StatusSkill("回溯疗愈", ElementType::NORMAL, 3, 100);
-    rewindHeal->addEffect(new ClearEffectsEffect(false, false, true, false, true)); // 清除自身异常状态
-    // 恢复至上回合结束时的HP，这个非常复杂，需要BattleSystem记录历史状态
-    learnSkill(rewindHeal);
-
-    StatusSkill *acceleratedVision = new StatusSkill("加速视界", ElementType::LIGHT, 2, 100);
-    acceleratedVision->addEffect(new StatChangeEffect(StatType::SPEED, 1, true));
-    // 本回合技能必定命中，需要一个临时状态或BattleSystem配合
-    learnSkill(acceleratedVision);
-
-    // 时光跳跃: 先制+3。使自身本回合免疫所有攻击和技能效果。
-    // 免疫效果通过TurnBasedEffect标记，由BattleSystem检查
-    StatusSkill *timeHop = new StatusSkill("时光跳跃", ElementType::LIGHT, 2, 100, 3); // 优先级3
-    auto immunityLambda = [](Creature *aff, Creature *src, BattleSystem *b, TurnBasedEffect *self_eff) { /* 标记用 */ };
-    TurnBasedEffect *hopImmunity = new TurnBasedEffect(1, immunityLambda, true); // 持续1回合，回合开始生效
-    hopImmunity->setDescription("时光跳跃免疫");
-    timeHop->addEffect(hopImmunity);
-    timeHop->getEffects().first()->setTargetSelf(true);
-    learnSkill(timeHop);
-
-    // 第五技能: 时间悖论 (极其复杂，简化或标记为TODO)
-    setFifthSkill(new TemporalParadoxSkill());
-}
-
-void Luguanluguanlulushijiandaole::recordBattleState() { /* TODO */ }
-bool Luguanluguanlulushijiandaole::tryRevertBattleState(BattleSystem *battle_unused) { /* TODO */ return false; }
+}
+
+void Luguanluguanlulushijiandaole::recordBattleState(BattleSystem *battle)
+{
+    if (!battle) return;
+    m_rewindTurn = battle->getCurrentTurn() + REWIND_DELAY;
+    if (battle->isBattleLogEnabled()) battle->addBattleLog(QString("%1 记下了此刻的时间！").arg(getName()), this);
+}
+
+bool Luguanluguanlulushijiandaole::tryRevertBattleState(BattleSystem *battle)
+{
+    // 回到记录那一回合开始时，即上一回合结束时的快照
+    const int recordedTurn = m_rewindTurn - REWIND_DELAY - 1;
+    m_rewindTurn = 0;
+    if (!battle) return false;
+
+    // AI搜索的镜像战斗从快照开始，没有更早的历史，与几率失败同样处理
+    if (battle->getRandom().bounded(100) < REWIND_CHANCE && battle->rewindToTurn(recordedTurn))
+    {
+        if (battle->isBattleLogEnabled())
+            battle->addBattleLog(QString("时间倒流！场上的精灵回到了第 %1 回合的状态。").arg(recordedTurn + 1), this);
+        return true;
+    }
+
+    if (battle->isBattleLogEnabled()) battle->addBattleLog(QString("%1 的时间悖论失败了！").arg(getName()), this);
+    if (getStatusCondition() == StatusCondition::NONE)
+    {
+        setStatusCondition(StatusCondition::TIRED);
+        battle->triggerStatusChanged(this, StatusCondition::NONE, StatusCondition::TIRED);
+        m_tiredUntilTurn = battle->getCurrentTurn() + 1;
+    }
+    return false;
+}
+
 void Luguanluguanlulushijiandaole::onTurnStart(BattleSystem* battle) { Creature::onTurnStart(battle); }
 void Luguanluguanlulushijiandaole::onTurnEnd(BattleSystem* battle)
 {
     Creature::onTurnEnd(battle);
-    if (m_snapshotTurnsLeft > 0)
-        m_snapshotTurnsLeft--;
+    if (!battle || isDead()) return;
+    const int turn = battle->getCurrentTurn();
+
+    if (m_tiredUntilTurn > 0 && turn >= m_tiredUntilTurn)
+    {
+        m_tiredUntilTurn = 0;
+        if (getStatusCondition() == StatusCondition::TIRED)
+        {
+            setStatusCondition(StatusCondition::NONE);
+            battle->triggerStatusChanged(this, StatusCondition::TIRED, StatusCondition::NONE);
+        }
+    }
+
+    // 只在出场精灵上调用：到期时不在场（换下后再换上）则记录作废
+    if (m_rewindTurn > 0 && turn > m_rewindTurn) m_rewindTurn = 0;
+    if (m_rewindTurn > 0 && turn == m_rewindTurn) tryRevertBattleState(battle);
+}
+// 时间悖论的回退回合与疲惫结束回合
+void Luguanluguanlulushijiandaole::exportSpeciesState(qint32 words[BATTLE_STATE_SPECIES_WORDS]) const
+{
+    words[0] = m_rewindTurn;
+    words[1] = m_tiredUntilTurn;
+}
+void Luguanluguanlulushijiandaole::importSpeciesState(const qint32 words[BATTLE_STATE_SPECIES_WORDS])
+{
+    m_rewindTurn = words[0];
+    m_tiredUntilTurn = words[1];
 }
 // CappuccinoAssassino（卡布奇诺忍者）构造函数
 CappuccinoAssassino::CappuccinoAssassino(int level)
@@ -973,35 +1107,19 @@ CappuccinoAssassino::CappuccinoAssassino(int level)
       m_inShadowState(false)
 {
     // 中文注释：卡布奇诺忍者 特化构造
-    setBaseStats(BaseStats(70, 115, 80, 65, 70, 130));
-    setTalent(Talent(7, 12, 8, 7, 7, 14));
-
-    learnSkill(new MultiHitSkill("影手里剑", ElementType::SHADOW, SkillCategory::PHYSICAL, 25, 2, 100, 2, 3, 1));
-    // 滚烫奇袭
-    CompositeSkill *scaldingSurprise = new CompositeSkill("滚烫奇袭", ElementType::FIRE, SkillCategory::SPECIAL, 70, 3, 100);
-    // 30%几率令目标烧伤。若目标速度低于自身，则烧伤几率提升至60%。 (条件几率需BattleSystem支持)
-    scaldingSurprise->setEffectChance(30);                                              // 基础30%
-    scaldingSurprise->addEffect(new StatusConditionEffect(StatusCondition::BURN, 100)); // 若触发setEffectChance，则100%烧伤
-    learnSkill(scaldingSurprise);
-
-    CompositeSkill *metalGrind = new CompositeSkill("金属研磨", ElementType::MACHINE, SkillCategory::PHYSICAL, 75, 3, 95);
-    metalGrind->setEffectChance(30);
-    metalGrind->addEffect(new StatChangeEffect(StatType::SPEED, -1, false));
-    learnSkill(metalGrind);
-
-    StatusSkill *swiftVanish = new StatusSkill("急速隐匿", ElementType::SHADOW, 2, 100);
-    swiftVanish->addEffect(new StatChangeEffect(StatType::SPEED, 2, true));
-    learnSkill(swiftVanish);
-
-    // 第五技能: 绝影刺杀
-    // 先制+1。若目标HP高于75%，则此技能威力提升50%；若目标HP低于25%，则此技能必定暴击。
-    // (威力提升和必爆条件需BattleSystem或自定义Skill子类支持)
-    setFifthSkill(new PhantomAssassinateSkill());
 }
 
 bool CappuccinoAssassino::isInShadowState() const { return m_inShadowState; }
 void CappuccinoAssassino::enterShadowState() { m_inShadowState = true; }
 void CappuccinoAssassino::exitShadowState() { m_inShadowState = false; }
+void CappuccinoAssassino::exportSpeciesState(qint32 words[BATTLE_STATE_SPECIES_WORDS]) const
+{
+    words[0] = m_inShadowState ? 1 : 0;
+}
+void CappuccinoAssassino::importSpeciesState(const qint32 words[BATTLE_STATE_SPECIES_WORDS])
+{
+    m_inShadowState = words[0] != 0;
+}
 void CappuccinoAssassino::onTurnStart(BattleSystem* battle)
 {
     Creature::onTurnStart(battle);
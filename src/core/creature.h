@@ -4,14 +4,40 @@
 #include <QString>
 #include <QVector>
 #include <QMap>
+#include <QStringList>
 #include "type.h"
 #include "ability.h"
 #include "../battle/skill.h"
+#include "../battle/skillregistry.h"
 #include "../battle/effect.h"
+#include "../battle/battlestate.h"
+
+struct SpeciesRecord;
 
 // 精灵等级和经验值计算常量
 const int MAX_LEVEL = 100;
 const int BASE_EXP_NEEDED = 1000;
+// 缓存的能力值个数（StatType::HP到StatType::SPEED）
+const int CACHED_STAT_COUNT = 6;
+// 普通技能槽数（另有一个第五技能）
+const int MAX_SKILL_COUNT = 4;
+
+// 精灵种类编号，与getSpeciesKeys()的顺序一致
+// 数值写入存档与回放，只能在末尾追加，不能调整已有种类的顺序
+// 下面是有专属精灵类的内置种类；数据目录（species.shcat）可在其后追加只由数据描述的种类
+enum class SpeciesId : quint16
+{
+    TUNG_TUNG_TUNG,               // 木棍人
+    BOMBARDINO_CROCODILLO,        // 鳄鱼轰炸机
+    TRALALERO_TRALALA,            // 耐克鲨鱼
+    LIRILI_LARILA,                // 仙人掌大象
+    CHIMPANZINI_BANANINI,         // 香蕉绿猩猩
+    LUGUANLUGUANLULUSHIJIANDAOLE, // 鹿管鹿管鹿鹿时间到了
+    CAPPUCCINO_ASSASSINO,         // 卡布奇诺忍者
+    NONE = 0xFFFF                 // 手工构造、不属于任何种类
+};
+
+const int SPECIES_COUNT = 7; // 内置种类个数；包含数据目录中追加种类的总数见Creature::getSpeciesCount()
 
 // 精灵基类
 class Creature
@@ -20,8 +46,28 @@ public:
     Creature(const QString &name, const Type &type, int level = 1);
     virtual ~Creature();
 
+    // 复制出一只同种类的新精灵（保留具体种类、数值状态与技能编号），由调用方释放
+    // 精灵只含值类型成员，技能定义在SkillRegistry中共用，因此逐成员拷贝即可
+    virtual Creature *clone() const;
+
+    // 按种类编号创建具体精灵实例，NONE或越界返回nullptr
+    static Creature *createSpecies(SpeciesId species, int level = 1);
+    // 按精灵模板键名（如"TungTungTung"）创建具体精灵实例，未知键名返回nullptr
+    static Creature *createSpecies(const QString &speciesKey, int level = 1);
+    // 可创建的种类个数，有效编号为0到getSpeciesCount()-1
+    static int getSpeciesCount();
+    // 获取所有可创建的精灵模板键名，下标即SpeciesId
+    static QStringList getSpeciesKeys();
+    // 键名与编号互查，只用于存档、回放、命令行等输入输出；未知键名返回NONE，NONE返回空字符串
+    static SpeciesId findSpecies(const QString &speciesKey);
+    static QString getSpeciesKeyById(SpeciesId species);
+
     // 获取基本信息
     QString getName() const;
+    // 精灵种类（由createSpecies设置，手工构造的精灵为NONE）
+    SpeciesId getSpeciesId() const;
+    // 精灵模板键名（手工构造的精灵为空）
+    QString getSpeciesKey() const;
     virtual QString getResourceName() const;
     Type getType() const;
     int getLevel() const;
@@ -64,20 +110,29 @@ public:
     void resetStatStages();
 
     // 技能管理
-    void learnSkill(Skill *skill);
+    // 精灵只保存技能编号，技能对象由SkillRegistry持有并为所有精灵共用，不能修改或释放
+    void learnSkill(SkillId skill);
     void forgetSkill(int index);
-    bool hasSkill(const QString &skillName) const;
+    bool hasSkill(SkillId skill) const;
+    bool hasSkill(const QString &skillName) const; // 名称先换算为技能编号
     Skill *getSkill(int index) const;
+    SkillId getSkillId(int index) const;
     QVector<Skill *> getSkills() const;
     int getSkillCount() const;
-    void setFifthSkill(Skill *skill);
+    void setFifthSkill(SkillId skill);
     Skill *getFifthSkill() const;
+    SkillId getFifthSkillId() const;
 
-    // 回合效果
-    void addTurnEffect(TurnBasedEffect *effect);
-    void removeTurnEffect(TurnBasedEffect *effect);
+    // 回合效果：定长记录内联存放在精灵中，施加、结算与拷贝都不分配内存
+    bool addTurnEffect(const TurnEffectSlot &effect); // 同施加者的同种效果刷新原记录；效果槽已满时返回false
     void clearAllTurnEffects();
-    QVector<TurnBasedEffect *> getTurnEffects() const;
+    int getTurnEffectCount() const { return m_turnEffectCount; }
+    const TurnEffectSlot &getTurnEffect(int index) const { return m_turnEffects[index]; }
+    bool hasTurnEffect(TurnEffectKind kind) const;
+
+    // 战斗状态快照（HP/PP/能力等级/异常状态/回合效果/种类私有状态）
+    void exportState(CreatureState &state) const;
+    void importState(const CreatureState &state);
 
     // 战斗行为
     virtual bool useSkill(int skillIndex, Creature *target, BattleSystem *battle);
@@ -98,29 +153,54 @@ public:
     bool hasTypeAdvantage(ElementType skillType) const; // 判断技能是否具有STAB加成
 
 protected:
+    // 只允许经由clone()拷贝，避免按基类拷贝时丢失具体种类
+    Creature(const Creature &other) = default;
+    Creature &operator=(const Creature &other) = default;
+
     QString m_name;            // 精灵名称
+    SpeciesId m_speciesId;     // 精灵种类
     Type m_type;               // 精灵属性
     int m_level;               // 等级
     int m_experience;          // 当前经验值
     BaseStats m_baseStats;     // 基础属性
     StatStages m_statStages;   // 属性等级（战斗中临时变化）
     Talent m_talent;           // 天赋
-    QVector<Skill *> m_skills; // 技能列表（普通技能）
-    Skill *m_fifthSkill;       // 第五技能
+    SkillId m_skills[MAX_SKILL_COUNT]; // 技能列表（普通技能），前m_skillCount个有效
+    int m_skillCount;
+    SkillId m_fifthSkill;              // 第五技能，NONE为没有
 
     int m_currentHP; // 当前生命值
     int m_maxHP;     // 最大生命值
     int m_currentPP; // 当前PP值
     int m_maxPP;     // 最大PP值
 
-    StatusCondition m_statusCondition;        // 异常状态
-    QVector<TurnBasedEffect *> m_turnEffects; // 回合效果
+    StatusCondition m_statusCondition; // 异常状态
+    TurnEffectSlot m_turnEffects[BATTLE_STATE_MAX_EFFECT_SLOTS]; // 回合效果，前m_turnEffectCount个有效
+    int m_turnEffectCount;
 
     // 计算升级所需经验值
     int calculateExperienceToNextLevel() const;
 
+    // 种类私有的战斗状态（如变身形态），由具体精灵类重写
+    virtual void exportSpeciesState(qint32 words[BATTLE_STATE_SPECIES_WORDS]) const;
+    virtual void importSpeciesState(const qint32 words[BATTLE_STATE_SPECIES_WORDS]);
+
     // 升级时更新属性
     void updateStatsOnLevelUp();
+
+    // 能力等级、异常状态或基础属性改变后调用，下次读取实际能力值时重新计算
+    void invalidateStats();
+
+private:
+    // 用数据目录中的记录设置名称、属性、种族值、天赋与技能
+    void applySpeciesRecord(const SpeciesRecord &record);
+    // 按当前基础属性、能力等级和异常状态重新计算缓存
+    void refreshStats() const;
+    void removeTurnEffectAt(int index);
+
+    mutable int m_effectiveStats[CACHED_STAT_COUNT]; // calculateAttack等返回的实际能力值（含烧伤/麻痹修正）
+    mutable int m_stagedStats[CACHED_STAT_COUNT];    // getCurrentStats返回的仅含等级修正的能力值
+    mutable bool m_statsDirty;                       // 缓存是否需要重新计算
 };
 
 // 具体精灵类（木棍人）
@@ -130,6 +210,8 @@ public:
     TungTungTung(int level = 1);
     virtual ~TungTungTung();
 
+    virtual Creature *clone() const override { return new TungTungTung(*this); }
+
     // 特殊行为或能力
     virtual void onTurnStart(BattleSystem* battle) override;
     virtual void onTurnEnd(BattleSystem* battle) override;
@@ -142,6 +224,8 @@ public:
     BombardinoCrocodillo(int level = 1);
     virtual ~BombardinoCrocodillo();
 
+    virtual Creature *clone() const override { return new BombardinoCrocodillo(*this); }
+
     // 特殊行为或能力
     virtual void onTurnStart(BattleSystem* battle) override;
     virtual void onTurnEnd(BattleSystem* battle) override;
@@ -154,6 +238,8 @@ public:
     TralaleroTralala(int level = 1);
     virtual ~TralaleroTralala();
 
+    virtual Creature *clone() const override { return new TralaleroTralala(*this); }
+
     // 特殊行为或能力
     virtual void onTurnStart(BattleSystem* battle) override;
     virtual void onTurnEnd(BattleSystem* battle) override;
@@ -166,6 +252,8 @@ public:
     LiriliLarila(int level = 1);
     virtual ~LiriliLarila();
 
+    virtual Creature *clone() const override { return new LiriliLarila(*this); }
+
     // 特殊行为或能力
     virtual void onTurnStart(BattleSystem* battle) override;
     virtual void onTurnEnd(BattleSystem* battle) override;
@@ -178,6 +266,8 @@ public:
     ChimpanziniBananini(int level = 1);
     virtual ~ChimpanziniBananini();
 
+    virtual Creature *clone() const override { return new ChimpanziniBananini(*this); }
+
     // 变身状态
     bool isInBerserkForm() const;
     void enterBerserkForm(int duration);
@@ -187,6 +277,10 @@ public:
     virtual void onTurnStart(BattleSystem* battle) override;
     virtual void onTurnEnd(BattleSystem* battle) override;
 
+protected:
+    virtual void exportSpeciesState(qint32 words[BATTLE_STATE_SPECIES_WORDS]) const override;
+    virtual void importSpeciesState(const qint32 words[BATTLE_STATE_SPECIES_WORDS]) override;
+
 private:
     bool m_inBerserkForm;
     int m_berserkFormDuration;
@@ -199,26 +293,29 @@ public:
     Luguanluguanlulushijiandaole(int level = 1);
     virtual ~Luguanluguanlulushijiandaole();
 
-    // 时间操控相关
-    void recordBattleState();
+    virtual Creature *clone() const override { return new Luguanluguanlulushijiandaole(*this); }
+
+    // 时间操控相关（时间悖论）
+    // 记下本回合开始时的场上状态，REWIND_DELAY回合后若仍在场则尝试回退到那时
+    void recordBattleState(BattleSystem *battle);
+    // 按几率把场上精灵恢复到记录时的状态，失败则自身疲惫1回合；返回是否回退成功
     bool tryRevertBattleState(BattleSystem *battle);
 
     // 特殊行为或能力
     virtual void onTurnStart(BattleSystem* battle) override;
     virtual void onTurnEnd(BattleSystem* battle) override;
 
+    static const int REWIND_DELAY = 3;   // 记录后经过的回合数
+    static const int REWIND_CHANCE = 50; // 回退成功率(%)
+
+protected:
+    virtual void exportSpeciesState(qint32 words[BATTLE_STATE_SPECIES_WORDS]) const override;
+    virtual void importSpeciesState(const qint32 words[BATTLE_STATE_SPECIES_WORDS]) override;
+
 private:
-    struct BattleSnapshot
-    {
-        int timestamp;
-        QMap<QString, int> creatureHPs;
-        QMap<QString, int> creaturePPs;
-        QMap<QString, QMap<StatType, int>> creatureStatStages;
-        QMap<QString, StatusCondition> creatureStatusConditions;
-    };
-
-    BattleSnapshot m_recordedState;
-    int m_snapshotTurnsLeft;
+    // 快照本身保存在BattleSystem的回合历史中，这里只记回合号
+    int m_rewindTurn;     // 尝试回退的回合，0为没有记录
+    int m_tiredUntilTurn; // 发动失败造成的疲惫持续到此回合之前，0为没有
 };
 
 // 具体精灵类（卡布奇诺忍者）
@@ -228,6 +325,8 @@ public:
     CappuccinoAssassino(int level = 1);
     virtual ~CappuccinoAssassino();
 
+    virtual Creature *clone() const override { return new CappuccinoAssassino(*this); }
+
     // 影子潜伏状态
     bool isInShadowState() const;
     void enterShadowState();
@@ -237,6 +336,10 @@ public:
     virtual void onTurnStart(BattleSystem* battle) override;
     virtual void onTurnEnd(BattleSystem* battle) override;
 
+protected:
+    virtual void exportSpeciesState(qint32 words[BATTLE_STATE_SPECIES_WORDS]) const override;
+    virtual void importSpeciesState(const qint32 words[BATTLE_STATE_SPECIES_WORDS]) override;
+
 private:
     bool m_inShadowState;
 };
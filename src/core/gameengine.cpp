@@ -7,7 +7,12 @@
 GameEngine *GameEngine::s_instance = nullptr;
 
 QVector<Creature*> GameEngine::getAllCreatureTemplates() const {
-    return m_creatureTemplates.values();
+    QVector<Creature*> templates;
+    templates.reserve(m_creatureTemplates.size());
+    for (Creature *creatureTemplate : m_creatureTemplates) {
+        if (creatureTemplate) templates.append(creatureTemplate);
+    }
+    return templates;
 }
 
 GameEngine *GameEngine::getInstance()
@@ -24,6 +29,8 @@ GameEngine::GameEngine(QObject *parent)
       m_gameState(GameState::MAIN_MENU),
       m_gameMode(GameMode::STORY_MODE),
       m_battleSystem(nullptr),
+      m_replayRecorder(nullptr),
+      m_replayer(nullptr),
       m_battlesWon(0),
       m_battlesLost(0)
 {
@@ -39,8 +46,11 @@ void GameEngine::init()
     // 创建战斗系统
     m_battleSystem = new BattleSystem(this);
 
-    // 连接信号
-    connect(m_battleSystem, &BattleSystem::battleEnded, this, &GameEngine::onBattleEnded);
+    // 注册为战斗观察者
+    m_battleSystem->addObserver(this);
+
+    // 录制每一场战斗
+    m_replayRecorder = new BattleReplayRecorder(m_battleSystem);
 
     // 初始化精灵模板
     initCreatureTemplates();
@@ -56,18 +66,20 @@ void GameEngine::cleanup()
     m_playerTeam.clear();
 
     // 释放精灵模板
-    for (auto it = m_creatureTemplates.begin(); it != m_creatureTemplates.end(); ++it)
-    {
-        delete it.value();
-    }
+    qDeleteAll(m_creatureTemplates);
     m_creatureTemplates.clear();
 
+    // 录制器要先于战斗系统删除（析构时注销观察者）
+    delete m_replayRecorder;
+    m_replayRecorder = nullptr;
+
     // 删除战斗系统
     if (m_battleSystem)
     {
         delete m_battleSystem;
         m_battleSystem = nullptr;
     }
+    releaseReplayer();
 }
 
 GameState GameEngine::getGameState() const
@@ -254,8 +266,11 @@ void GameEngine::startBattle(const QVector<Creature *> &opponentTeam, bool isPvP
     // 设置战斗状态
     setGameState(GameState::BATTLE);
 
-    // 初始化战斗系统
+    // 初始化战斗系统，每场战斗使用新的随机种子
+    m_battleSystem->setTurnResolutionMode(TurnResolutionMode::INTERACTIVE);
+    m_battleSystem->setRandomSeed(QRandomGenerator::global()->generate64());
     m_battleSystem->initBattle(m_playerTeam, opponentTeam, isPvP);
+    releaseReplayer(); // 上一场回放的队伍此时已不再被战斗系统引用
 
     // 发出战斗开始信号
     emit battleStarting();
@@ -280,15 +295,53 @@ void GameEngine::endBattle(BattleResult result)
     emit battleEnded(result);
 }
 
+const BattleReplay &GameEngine::getLastBattleReplay() const
+{
+    return m_replayRecorder->getReplay();
+}
+
+bool GameEngine::startReplay(const BattleReplay &replay)
+{
+    BattleReplayer *replayer = new BattleReplayer(replay);
+    QString error;
+    if (!replayer->start(*m_battleSystem, &error))
+    {
+        qWarning() << "无法开始回放:" << error;
+        delete replayer;
+        return false;
+    }
+    releaseReplayer();
+    m_replayer = replayer;
+
+    setGameState(GameState::BATTLE);
+    emit battleStarting();
+    return true;
+}
+
+BattleReplayer *GameEngine::getReplayer() const
+{
+    return m_replayer;
+}
+
+// 按种类创建精灵：内置种类复制模板，其余种类直接由数据目录中的记录构造
+Creature *GameEngine::createCreature(SpeciesId species, int level)
+{
+    const int index = static_cast<int>(species);
+    if (index >= m_creatureTemplates.size() || !m_creatureTemplates[index])
+    {
+        return Creature::createSpecies(species, level); // 目录中没有该种类时为nullptr
+    }
+    Creature *newCreature = m_creatureTemplates[index]->clone();
+    newCreature->setLevel(level);
+    return newCreature;
+}
+
 // 创建精灵（只指定名字和等级）
 Creature *GameEngine::createCreature(const QString &creatureName, int level)
 {
-    // 先查找模板
-    if (m_creatureTemplates.contains(creatureName))
+    // 先查找模板，按模板复制出同种类的新实例
+    if (Creature *newCreature = createCreature(Creature::findSpecies(creatureName), level))
     {
-        Creature *templateCreature = m_creatureTemplates[creatureName];
-        Creature *newCreature = new Creature(*templateCreature); // 假设Creature有拷贝构造
-        newCreature->setLevel(level);
         return newCreature;
     }
     // 如果没有模板，使用默认Type
@@ -318,34 +371,13 @@ Creature *GameEngine::createCreature(const QString &creatureName, const Type &ty
     return creature;
 }
 
-// 创建技能
-Skill *GameEngine::createSkill(const QString &skillName, ElementType elementType, SkillCategory skillType,
-                               int power, int accuracy, int maxPP)
-{
-    // 根据技能类型创建不同的技能子类
-    Skill *skill = nullptr;
-
-    switch (skillType)
-    {
-    case SkillCategory::PHYSICAL:
-        skill = new PhysicalSkill(skillName, elementType, power, accuracy, maxPP);
-        break;
-    case SkillCategory::SPECIAL:
-        skill = new SpecialSkill(skillName, elementType, power, accuracy, maxPP);
-        break;
-    case SkillCategory::STATUS:
-        skill = new StatusSkill(skillName, elementType, accuracy, maxPP);
-        break;
-    }
-
-    return skill;
-}
-
 void GameEngine::startPvEBattle()
 {
     // 创建AI对手队伍
     int difficulty = 1; // 可以根据玩家进度或其他因素调整难度
     QVector<Creature *> aiTeam = createAITeam(difficulty,1);
+    // 难度同时决定对手等级与AI的搜索强度
+    m_battleSystem->setOpponentAIConfig(OpponentAIConfig::forDifficulty(difficulty));
 
     // 启动战斗
     startBattle(aiTeam, false);
@@ -367,14 +399,13 @@ void GameEngine::onBattleEnded(BattleResult result)
 
 void GameEngine::initCreatureTemplates()
 {
-    // 创建各种精灵模板
-    m_creatureTemplates["TungTungTung"] = new TungTungTung(1);
-    m_creatureTemplates["BombardinoCrocodillo"] = new BombardinoCrocodillo(1);
-    m_creatureTemplates["TralaleroTralala"] = new TralaleroTralala(1);
-    m_creatureTemplates["LiriliLarila"] = new LiriliLarila(1);
-    m_creatureTemplates["ChimpanziniBananini"] = new ChimpanziniBananini(1);
-    m_creatureTemplates["Luguanluguanlulushijiandaole"] = new Luguanluguanlulushijiandaole(1);
-    m_creatureTemplates["CappuccinoAssassino"] = new CappuccinoAssassino(1);
+    // 只为内置种类创建模板，数据目录追加的种类在createCreature中按需构造
+    qDeleteAll(m_creatureTemplates);
+    m_creatureTemplates.resize(SPECIES_COUNT);
+    for (int i = 0; i < SPECIES_COUNT; ++i)
+    {
+        m_creatureTemplates[i] = Creature::createSpecies(static_cast<SpeciesId>(i), 1);
+    }
 }
 
 void GameEngine::releaseTeam(QVector<Creature *> &team)
@@ -386,20 +417,30 @@ void GameEngine::releaseTeam(QVector<Creature *> &team)
     team.clear();
 }
 
+void GameEngine::releaseReplayer()
+{
+    delete m_replayer;
+    m_replayer = nullptr;
+}
+
 QVector<Creature *> GameEngine::createAITeam(int difficulty, int teamSize)
 {
     QVector<Creature *> team;
-    // 简单实现：随机从模板中选择teamSize个精灵
-    QList<QString> keys = m_creatureTemplates.keys();
-    for (int i = 0; i < teamSize; ++i)
+    team.reserve(teamSize);
+    // 简单实现：从全部种类中随机选择teamSize个不重复的精灵
+    // 只记录已选中的编号，不为整个目录建候选表
+    const int speciesCount = Creature::getSpeciesCount();
+    QVector<SpeciesId> chosen;
+    chosen.reserve(teamSize);
+    while (chosen.size() < qMin(teamSize, speciesCount))
     {
-        if (keys.isEmpty())
-            break;
-        int idx = QRandomGenerator::global()->bounded(keys.size());
-        QString name = keys[idx];
-        Creature *aiCreature = createCreature(name, 5 + difficulty * 2); // 难度影响等级
-        team.append(aiCreature);
-        keys.removeAt(idx); // 不重复
+        const SpeciesId species = static_cast<SpeciesId>(QRandomGenerator::global()->bounded(speciesCount));
+        if (chosen.contains(species)) continue;
+        chosen.append(species);
+        if (Creature *aiCreature = createCreature(species, 5 + difficulty * 2)) // 难度影响等级
+        {
+            team.append(aiCreature);
+        }
     }
     return team;
 }
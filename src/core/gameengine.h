@@ -7,6 +7,7 @@
 #include <QString>
 #include "creature.h"
 #include "../battle/battlesystem.h"
+#include "../battle/battlereplay.h"
 
 // 游戏模式
 enum class GameMode {
@@ -24,11 +25,12 @@ enum class GameState {
 };
 
 // 游戏引擎类
-class GameEngine : public QObject {
+class GameEngine : public QObject, public BattleObserver {
     Q_OBJECT
 
 public:
     static GameEngine* getInstance();
+    // 内置种类的模板，供界面列出可选精灵
     QVector<Creature*> getAllCreatureTemplates() const;
     // 初始化和清理
     void init();
@@ -77,19 +79,24 @@ public:
     
     // 结束战斗
     void endBattle(BattleResult result);
-      // 创建精灵实例
+
+    // 战斗回放：每场战斗都会自动录制
+    const BattleReplay &getLastBattleReplay() const;
+    // 以回放启动一场战斗，由界面逐回合推进；队伍无法重建时返回false
+    bool startReplay(const BattleReplay &replay);
+    // 正在回放时返回回放器，否则为nullptr
+    BattleReplayer *getReplayer() const;
+      // 创建精灵实例：内置种类复制模板，数据目录追加的种类按记录现场构造；键名只在输入输出处换算为种类编号
+    Creature* createCreature(SpeciesId species, int level = 1);
     Creature* createCreature(const QString& creatureName, int level = 1);
     Creature* createCreature(const QString& creatureName, const Type& type, int level = 1);
-      // 创建技能实例
-    Skill* createSkill(const QString& skillName, ElementType elementType, SkillCategory skillCategory, 
-                      int power, int accuracy, int maxPP);
     
     // 创建精灵队伍（AI对手）
     QVector<Creature*> createAITeam(int difficulty, int teamSize = 1);
 
 public slots:
-    // 接收战斗结果
-    void onBattleEnded(BattleResult result);
+    // 接收战斗结果（作为战斗观察者直接回调）
+    void onBattleEnded(BattleResult result) override;
 
 signals:
     // 游戏状态变化
@@ -121,14 +128,18 @@ private:
     
     // 战斗系统
     BattleSystem* m_battleSystem;
+
+    // 战斗回放
+    BattleReplayRecorder* m_replayRecorder;
+    BattleReplayer* m_replayer; // 持有回放中的双方队伍，下一场战斗开始后才释放
       // 玩家精灵队伍
     QVector<Creature*> m_playerTeam;
     
     // 可用精灵列表
     QVector<Creature*> m_availableCreatures;
     
-    // 所有可用的精灵模板
-    QMap<QString, Creature*> m_creatureTemplates;
+    // 内置种类的精灵模板，下标即SpeciesId；数据目录追加的种类不建模板，启动耗时与目录大小无关
+    QVector<Creature*> m_creatureTemplates;
     
     // 游戏统计数据
     int m_battlesWon;
@@ -139,6 +150,7 @@ private:
     
     // 释放资源
     void releaseTeam(QVector<Creature*>& team);
+    void releaseReplayer();
 };
 
 #endif // GAMEENGINE_H
@@ -232,6 +232,11 @@ QJsonObject SaveSystem::creatureToJson(const Creature *creature) const
 
     // 保存基本信息
     creatureObject["name"] = creature->getName();
+    if (creature->getSpeciesId() != SpeciesId::NONE)
+    {
+        creatureObject["speciesId"] = static_cast<int>(creature->getSpeciesId()); // 载入时按种类模板复制
+        creatureObject["speciesKey"] = creature->getSpeciesKey(); // 数据目录追加的种类编号随目录变化，按键名查找
+    }
     creatureObject["level"] = creature->getLevel();
     creatureObject["experience"] = creature->getExperience();
 
@@ -318,8 +323,20 @@ Creature *SaveSystem::createCreatureFromJson(const QJsonObject &json) const
     ElementType primaryType = static_cast<ElementType>(typeObject["primary"].toInt());
     ElementType secondaryType = static_cast<ElementType>(typeObject["secondary"].toInt());
 
-    // 创建精灵
-    Creature *creature = gameEngine->createCreature(name, Type(primaryType, secondaryType), level);
+    // 创建精灵：有种类编号时按模板复制出具体种类，旧存档或未知种类退回到通用精灵
+    Creature *creature = nullptr;
+    const int speciesId = json["speciesId"].toInt(-1);
+    const SpeciesId species = speciesId >= 0 && speciesId < SPECIES_COUNT
+                                  ? static_cast<SpeciesId>(speciesId)
+                                  : Creature::findSpecies(json["speciesKey"].toString());
+    if (species != SpeciesId::NONE)
+    {
+        creature = gameEngine->createCreature(species, level);
+    }
+    if (!creature)
+    {
+        creature = gameEngine->createCreature(name, Type(primaryType, secondaryType), level);
+    }
     if (!creature)
     {
         return nullptr;
@@ -365,41 +382,41 @@ Creature *SaveSystem::createCreatureFromJson(const QJsonObject &json) const
     talent.setSpeedGrowth(talentObject["speedGrowth"].toInt());
     creature->setTalent(talent);
 
-    // 加载技能
+    // 加载技能：按名称取注册表中的共用技能，其余字段只用于存档可读性
+    // 存档中的技能列表为准，替换模板自带的技能
+    const SkillRegistry &skillRegistry = SkillRegistry::getInstance();
+    while (creature->getSkillCount() > 0)
+    {
+        creature->forgetSkill(0);
+    }
     QJsonArray skillsArray = json["skills"].toArray();
     for (const QJsonValue &skillValue : skillsArray)
     {
-        QJsonObject skillObject = skillValue.toObject();
-
-        QString skillName = skillObject["name"].toString();
-        ElementType elementType = static_cast<ElementType>(skillObject["elementType"].toInt());
-        SkillCategory skillType = static_cast<SkillCategory>(skillObject["skillCategory"].toInt());
-        int power = skillObject["power"].toInt();
-        int accuracy = skillObject["accuracy"].toInt();
-
-        Skill *skill = gameEngine->createSkill(skillName, elementType, skillType, power, accuracy, maxPP);
-        if (skill)
+        QString skillName = skillValue.toObject()["name"].toString();
+        SkillId skill = skillRegistry.findByName(skillName);
+        if (skill != SkillId::NONE)
         {
             creature->learnSkill(skill);
         }
+        else
+        {
+            qWarning() << "存档中的技能不存在:" << skillName;
+        }
     }
 
     // 加载第五技能（如果有）
     if (json.contains("fifthSkill"))
     {
-        QJsonObject skillObject = json["fifthSkill"].toObject();
-
-        QString skillName = skillObject["name"].toString();
-        ElementType elementType = static_cast<ElementType>(skillObject["elementType"].toInt());
-        SkillCategory skillType = static_cast<SkillCategory>(skillObject["skillCategory"].toInt());
-        int power = skillObject["power"].toInt();
-        int accuracy = skillObject["accuracy"].toInt();
-
-        Skill *skill = gameEngine->createSkill(skillName, elementType, skillType, power, accuracy, maxPP);
-        if (skill)
+        QString skillName = json["fifthSkill"].toObject()["name"].toString();
+        SkillId skill = skillRegistry.findByName(skillName);
+        if (skill != SkillId::NONE)
         {
             creature->setFifthSkill(skill);
         }
+        else
+        {
+            qWarning() << "存档中的技能不存在:" << skillName;
+        }
     }
 
     // 设置状态条件
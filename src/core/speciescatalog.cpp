@@ -0,0 +1,295 @@
+// src/core/speciescatalog.cpp
+#include "speciescatalog.h"
+#include "creature.h"
+#include <QCoreApplication>
+#include <QDebug>
+#include <QHash>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QJsonParseError>
+#include <QSet>
+#include <QVector>
+#include <cstring>
+
+namespace {
+
+// JSON中属性的写法，下标即ElementType
+const char *const ELEMENT_TYPE_KEYS[ELEMENT_TYPE_COUNT] = {
+    "NONE", "FIRE", "WATER", "GRASS", "GROUND", "FLYING", "BUG", "MACHINE", "NORMAL", "LIGHT", "SHADOW"};
+
+// baseStats与talent的字段名，顺序即StatType
+const char *const STAT_KEYS[6] = {"hp", "attack", "spAttack", "defense", "spDefense", "speed"};
+
+bool fail(QString *error, const QString &message)
+{
+    if (error) *error = message;
+    return false;
+}
+
+int findElementType(const QString &key)
+{
+    for (int i = 0; i < ELEMENT_TYPE_COUNT; ++i)
+    {
+        if (key == QLatin1String(ELEMENT_TYPE_KEYS[i])) return i;
+    }
+    return -1;
+}
+
+// 六项数值都必须给出，范围与记录中的qint16一致
+bool readStats(const QJsonObject &object, int minValue, qint16 values[6], QString &message)
+{
+    for (int i = 0; i < 6; ++i)
+    {
+        const QJsonValue value = object.value(QLatin1String(STAT_KEYS[i]));
+        const int number = value.toInt(-1);
+        if (!value.isDouble() || number < minValue || number > 32767)
+        {
+            message = QString("%1应为%2到32767之间的整数").arg(STAT_KEYS[i]).arg(minValue);
+            return false;
+        }
+        values[i] = static_cast<qint16>(number);
+    }
+    return true;
+}
+
+quint8 findSkill(const QJsonValue &value, QString &message)
+{
+    const QString name = value.toString();
+    const SkillId skill = SkillRegistry::getInstance().findByName(name);
+    if (skill == SkillId::NONE) message = QString("未知的技能: %1").arg(name);
+    return static_cast<quint8>(skill);
+}
+
+// 读取并编译内嵌的JSON，只在没有可用的目录文件时执行
+bool compileEmbedded(QByteArray &catalog, QString *error)
+{
+    QFile source(QString::fromLatin1(SpeciesCatalog::EMBEDDED_SOURCE_PATH));
+    if (!source.open(QIODevice::ReadOnly))
+        return fail(error, QString("无法读取%1").arg(source.fileName()));
+    QJsonParseError parseError;
+    const QJsonDocument document = QJsonDocument::fromJson(source.readAll(), &parseError);
+    if (parseError.error != QJsonParseError::NoError)
+        return fail(error, QString("%1: JSON格式错误: %2").arg(source.fileName(), parseError.errorString()));
+    return SpeciesCatalog::compile(document, catalog, error);
+}
+
+} // namespace
+
+const char *const SpeciesCatalog::EMBEDDED_SOURCE_PATH = ":/data/species.json";
+
+SpeciesCatalog::SpeciesCatalog()
+    : m_mapped(nullptr),
+      m_records(nullptr),
+      m_strings(nullptr),
+      m_speciesCount(0),
+      m_stringsSize(0)
+{
+}
+
+SpeciesCatalog::~SpeciesCatalog()
+{
+    close();
+}
+
+const SpeciesCatalog &SpeciesCatalog::getInstance()
+{
+    static SpeciesCatalog catalog;
+    static const bool opened = [] {
+        const QString path = getDefaultPath();
+        QString error;
+        // 优先映射构建步骤放在可执行文件旁的目录文件；没有或无效时在内存中编译内嵌的JSON，耗时随种类数增长
+        if (path.isEmpty())
+            qInfo() << "无法确定精灵数据目录位置，编译内嵌的精灵数据";
+        else if (!QFile::exists(path))
+            qInfo() << "未找到精灵数据目录" << path << "，编译内嵌的精灵数据";
+        else if (catalog.open(path, &error))
+            return true;
+        else
+            qWarning() << "精灵数据目录无效，编译内嵌的精灵数据:" << error;
+
+        QByteArray compiled;
+        if (!compileEmbedded(compiled, &error) || !catalog.load(compiled, &error))
+            qWarning() << "内嵌的精灵数据不可用，内置种类只有名称与属性:" << error;
+        return catalog.isLoaded();
+    }();
+    Q_UNUSED(opened);
+    return catalog;
+}
+
+QString SpeciesCatalog::getDefaultPath()
+{
+    if (!QCoreApplication::instance()) return QString();
+    return QCoreApplication::applicationDirPath() + "/species.shcat";
+}
+
+bool SpeciesCatalog::open(const QString &path, QString *error)
+{
+    close();
+    m_file.setFileName(path);
+    if (!m_file.open(QIODevice::ReadOnly))
+        return fail(error, QString("无法打开%1: %2").arg(path, m_file.errorString()));
+
+    const qint64 size = m_file.size();
+    m_mapped = size >= static_cast<qint64>(sizeof(SpeciesCatalogHeader)) ? m_file.map(0, size) : nullptr;
+    if (!m_mapped)
+    {
+        close();
+        return fail(error, QString("%1不是有效的目录文件").arg(path));
+    }
+    return attach(m_mapped, size, error);
+}
+
+bool SpeciesCatalog::load(const QByteArray &catalog, QString *error)
+{
+    close();
+    m_buffer = catalog;
+    return attach(reinterpret_cast<const uchar *>(m_buffer.constData()), m_buffer.size(), error);
+}
+
+bool SpeciesCatalog::attach(const uchar *data, qint64 size, QString *error)
+{
+    if (size < static_cast<qint64>(sizeof(SpeciesCatalogHeader)) ||
+        reinterpret_cast<quintptr>(data) % alignof(SpeciesCatalogHeader) != 0)
+    {
+        close();
+        return fail(error, "目录内容过短或未对齐");
+    }
+
+    const SpeciesCatalogHeader *header = reinterpret_cast<const SpeciesCatalogHeader *>(data);
+    const quint64 recordsEnd = quint64(header->recordsOffset) + quint64(header->speciesCount) * sizeof(SpeciesRecord);
+    const quint64 stringsEnd = quint64(header->stringsOffset) + header->stringsSize;
+    QString message;
+    if (header->magic != SPECIES_CATALOG_MAGIC || header->version != SPECIES_CATALOG_VERSION ||
+        header->recordSize != sizeof(SpeciesRecord))
+        message = "文件格式或版本不符，需要重新编译目录";
+    else if (header->speciesCount == 0 || header->speciesCount > MAX_CATALOG_SPECIES)
+        message = "种类数超出范围";
+    else if (header->recordsOffset % alignof(SpeciesRecord) != 0 || recordsEnd > quint64(size) ||
+             header->stringsSize == 0 || stringsEnd > quint64(size) || data[stringsEnd - 1] != '\0')
+        message = "文件已截断或损坏";
+    if (!message.isEmpty())
+    {
+        close();
+        return fail(error, message);
+    }
+
+    m_records = reinterpret_cast<const SpeciesRecord *>(data + header->recordsOffset);
+    m_strings = reinterpret_cast<const char *>(data + header->stringsOffset);
+    m_speciesCount = static_cast<int>(header->speciesCount);
+    m_stringsSize = header->stringsSize;
+
+    // 内置种类的编号写入了存档与回放，目录中的顺序必须与SpeciesId一致
+    for (int i = 0; i < qMin(m_speciesCount, SPECIES_COUNT); ++i)
+    {
+        const QString key = Creature::getSpeciesKeyById(static_cast<SpeciesId>(i));
+        if (key != QString::fromUtf8(getString(m_records[i].keyOffset)))
+        {
+            close();
+            return fail(error, QString("第%1个种类应为%2").arg(i).arg(key));
+        }
+    }
+    return true;
+}
+
+void SpeciesCatalog::close()
+{
+    if (m_mapped) m_file.unmap(m_mapped);
+    if (m_file.isOpen()) m_file.close();
+    m_buffer.clear();
+    m_mapped = nullptr;
+    m_records = nullptr;
+    m_strings = nullptr;
+    m_speciesCount = 0;
+    m_stringsSize = 0;
+}
+
+bool SpeciesCatalog::compile(const QJsonDocument &document, QByteArray &catalog, QString *error)
+{
+    const QJsonArray entries = document.object().value("species").toArray();
+    if (entries.isEmpty()) return fail(error, "缺少species数组");
+    if (entries.size() > MAX_CATALOG_SPECIES)
+        return fail(error, QString("种类数%1超过上限%2").arg(entries.size()).arg(MAX_CATALOG_SPECIES));
+
+    QVector<SpeciesRecord> records;
+    records.reserve(entries.size());
+    QByteArray strings;
+    QHash<QString, quint32> stringOffsets; // 相同的字符串只存一份
+    auto addString = [&](const QString &text) {
+        const auto it = stringOffsets.constFind(text);
+        if (it != stringOffsets.constEnd()) return it.value();
+        const quint32 offset = static_cast<quint32>(strings.size());
+        strings.append(text.toUtf8());
+        strings.append('\0');
+        stringOffsets.insert(text, offset);
+        return offset;
+    };
+
+    QSet<QString> keys;
+    for (int i = 0; i < entries.size(); ++i)
+    {
+        const QJsonObject entry = entries[i].toObject();
+        const QString key = entry.value("key").toString();
+        const QString where = QString("第%1个种类(%2)").arg(i).arg(key);
+        if (key.isEmpty()) return fail(error, where + ": 缺少key");
+        if (keys.contains(key)) return fail(error, where + ": key重复");
+        keys.insert(key);
+        if (i < SPECIES_COUNT && key != Creature::getSpeciesKeyById(static_cast<SpeciesId>(i)))
+            return fail(error, where + QString(": 内置种类须按SpeciesId顺序排在最前，此处应为%1")
+                                           .arg(Creature::getSpeciesKeyById(static_cast<SpeciesId>(i))));
+
+        SpeciesRecord record;
+        std::memset(&record, 0, sizeof(record));
+        record.keyOffset = addString(key);
+        record.nameOffset = addString(entry.value("name").toString(key));
+
+        const QJsonArray types = entry.value("types").toArray();
+        const int primaryType = types.isEmpty() ? -1 : findElementType(types[0].toString());
+        const int secondaryType = types.size() > 1 ? findElementType(types[1].toString()) : CATALOG_NO_TYPE;
+        if (types.size() > 2 || primaryType < 0 || secondaryType < 0)
+            return fail(error, where + ": types应为一到两个属性名");
+        record.primaryType = static_cast<quint8>(primaryType);
+        record.secondaryType = static_cast<quint8>(secondaryType);
+
+        QString message;
+        if (!readStats(entry.value("baseStats").toObject(), 1, record.baseStats, message) ||
+            !readStats(entry.value("talent").toObject(), 0, record.talent, message))
+            return fail(error, where + ": " + message);
+
+        const int maxPP = entry.value("maxPP").toInt(8);
+        if (maxPP < 0 || maxPP > 32767) return fail(error, where + ": maxPP超出范围");
+        record.maxPP = static_cast<qint16>(maxPP);
+
+        const QJsonArray skills = entry.value("skills").toArray();
+        if (skills.size() > CATALOG_SKILL_SLOTS)
+            return fail(error, where + QString(": 最多%1个技能").arg(CATALOG_SKILL_SLOTS));
+        for (int slot = 0; slot < skills.size(); ++slot)
+        {
+            record.skills[slot] = findSkill(skills[slot], message);
+            if (!message.isEmpty()) return fail(error, where + ": " + message);
+        }
+        if (entry.contains("fifthSkill"))
+        {
+            record.fifthSkill = findSkill(entry.value("fifthSkill"), message);
+            if (!message.isEmpty()) return fail(error, where + ": " + message);
+        }
+        records.append(record);
+    }
+
+    SpeciesCatalogHeader header;
+    std::memset(&header, 0, sizeof(header));
+    header.magic = SPECIES_CATALOG_MAGIC;
+    header.version = SPECIES_CATALOG_VERSION;
+    header.recordSize = sizeof(SpeciesRecord);
+    header.speciesCount = static_cast<quint32>(records.size());
+    header.recordsOffset = sizeof(SpeciesCatalogHeader);
+    header.stringsOffset = header.recordsOffset + header.speciesCount * sizeof(SpeciesRecord);
+    header.stringsSize = static_cast<quint32>(strings.size());
+
+    catalog.clear();
+    catalog.reserve(static_cast<int>(header.stringsOffset + header.stringsSize));
+    catalog.append(reinterpret_cast<const char *>(&header), sizeof(header));
+    catalog.append(reinterpret_cast<const char *>(records.constData()), records.size() * static_cast<int>(sizeof(SpeciesRecord)));
+    catalog.append(strings);
+    return true;
+}
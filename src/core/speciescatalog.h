@@ -0,0 +1,112 @@
+// src/core/speciescatalog.h
+#ifndef SPECIESCATALOG_H
+#define SPECIESCATALOG_H
+
+#include <QByteArray>
+#include <QFile>
+#include <QString>
+#include <type_traits>
+
+class QJsonDocument;
+
+// 精灵数据目录（.shcat）
+// 种族值、天赋、属性与技能编号只写在data/species.json中，构建时由shanhai_catalog编译为下面的二进制布局；
+// 运行时整个文件映射进内存，记录直接按结构体读取，不做逐字段解析。
+// 可执行文件旁没有目录文件时（如qmake构建），改为在内存中编译以Qt资源内嵌的同一份JSON。
+// 布局按本机字节序与自然对齐写出（构建步骤与游戏在同一平台上运行）；字节序不同的文件魔数对不上，会当作没有目录。
+//
+//   [SpeciesCatalogHeader][SpeciesRecord x speciesCount][字符串表：UTF-8，各以'\0'结尾]
+//
+// JSON格式：{"species": [{"key", "name", "types": ["GRASS", "GROUND"], "baseStats", "talent", "maxPP",
+//                        "skills": [技能名 x 0-4], "fifthSkill": 技能名}, ...]}
+// baseStats与talent为 {"hp", "attack", "spAttack", "defense", "spDefense", "speed"}，技能名即SkillRegistry中的名称
+
+const quint32 SPECIES_CATALOG_MAGIC = 0x54434853; // "SHCT"
+const quint16 SPECIES_CATALOG_VERSION = 1;
+const int MAX_CATALOG_SPECIES = 0xFFFF;           // SpeciesId::NONE(0xFFFF)之前的编号都可用
+const quint8 CATALOG_NO_TYPE = 0xFF;              // 单属性精灵的副属性
+const int CATALOG_SKILL_SLOTS = 4;                // 与MAX_SKILL_COUNT一致，creature.cpp中有静态断言
+
+struct SpeciesCatalogHeader
+{
+    quint32 magic;
+    quint16 version;
+    quint16 recordSize;    // sizeof(SpeciesRecord)，布局改变时拒绝旧文件
+    quint32 speciesCount;
+    quint32 recordsOffset; // 以下偏移都相对文件开头
+    quint32 stringsOffset;
+    quint32 stringsSize;
+};
+
+// 一个种类的全部静态数据，下标即SpeciesId
+struct SpeciesRecord
+{
+    quint32 keyOffset;                  // 模板键名，字符串表内偏移
+    quint32 nameOffset;                 // 显示名称
+    qint16 baseStats[6];                // 按StatType顺序：HP 物攻 特攻 物防 特防 速度
+    qint16 talent[6];                   // 同上
+    qint16 maxPP;
+    quint8 primaryType;                 // ElementType
+    quint8 secondaryType;               // ElementType，单属性为CATALOG_NO_TYPE
+    quint8 skills[CATALOG_SKILL_SLOTS]; // SkillId，空槽为SkillId::NONE
+    quint8 fifthSkill;                  // SkillId
+    quint8 reserved[3];
+};
+
+static_assert(sizeof(SpeciesCatalogHeader) == 24, "目录文件头布局改变时需要提升SPECIES_CATALOG_VERSION");
+static_assert(sizeof(SpeciesRecord) == 44, "种类记录布局改变时需要提升SPECIES_CATALOG_VERSION");
+static_assert(std::is_trivially_copyable<SpeciesRecord>::value, "种类记录必须能直接映射");
+
+class SpeciesCatalog
+{
+public:
+    SpeciesCatalog();
+    ~SpeciesCatalog();
+
+    // 游戏使用的目录：第一次访问时映射可执行文件旁的species.shcat，文件不存在或无效时编译内嵌的JSON
+    static const SpeciesCatalog &getInstance();
+    static QString getDefaultPath();
+    static const char *const EMBEDDED_SOURCE_PATH; // 内嵌的data/species.json
+
+    // 映射目录文件，只检查文件头与各段范围，耗时与种类数无关；失败时目录保持为空
+    bool open(const QString &path, QString *error = nullptr);
+    // 使用内存中已编译的目录内容（共享catalog的数据，不复制），检查同open
+    bool load(const QByteArray &catalog, QString *error = nullptr);
+    void close();
+
+    bool isLoaded() const { return m_records != nullptr; }
+    int getSpeciesCount() const { return m_speciesCount; }
+
+    // 越界返回nullptr；指针指向映射内存，目录关闭前有效
+    const SpeciesRecord *getRecord(int index) const
+    {
+        return index >= 0 && index < m_speciesCount ? m_records + index : nullptr;
+    }
+
+    // 字符串表中的字符串，偏移越界返回空字符串
+    const char *getString(quint32 offset) const
+    {
+        return offset < m_stringsSize ? m_strings + offset : "";
+    }
+
+    // 把JSON描述编译成目录文件内容，失败时返回false并给出原因
+    // 前SPECIES_COUNT个种类必须按SpeciesId的顺序列出内置种类，其后可追加任意新种类
+    static bool compile(const QJsonDocument &document, QByteArray &catalog, QString *error = nullptr);
+
+private:
+    SpeciesCatalog(const SpeciesCatalog &) = delete;
+    SpeciesCatalog &operator=(const SpeciesCatalog &) = delete;
+
+    // 检查文件头与各段范围并指向记录和字符串表；失败时关闭目录
+    bool attach(const uchar *data, qint64 size, QString *error);
+
+    QFile m_file;                   // 映射期间保持打开
+    uchar *m_mapped;
+    QByteArray m_buffer;            // load()载入的目录内容
+    const SpeciesRecord *m_records;
+    const char *m_strings;
+    int m_speciesCount;
+    quint32 m_stringsSize;
+};
+
+#endif // SPECIESCATALOG_H
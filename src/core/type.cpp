@@ -1,22 +1,79 @@
 #include "type.h"
+#include <array>
 
-// 静态成员初始化
-QMap<QPair<ElementType, ElementType>, double> Type::s_typeEffectiveness;
+namespace {
+
+// 定义系数，按照需求中的配置
+constexpr double SUPER_EFFECTIVE = 1.5;     // 克制
+constexpr double NORMAL = 1.0;              // 普通
+constexpr double NOT_VERY_EFFECTIVE = 0.75; // 微弱
+constexpr double NO_EFFECT = 0.0;           // 无效
+
+constexpr double S = SUPER_EFFECTIVE;
+constexpr double N = NORMAL;
+constexpr double W = NOT_VERY_EFFECTIVE;
+constexpr double X = NO_EFFECT;
+
+using EffectivenessRow = std::array<double, ELEMENT_TYPE_COUNT>;
+using EffectivenessChart = std::array<EffectivenessRow, ELEMENT_TYPE_COUNT>;
+using DualEffectivenessChart = std::array<EffectivenessChart, ELEMENT_TYPE_COUNT>;
+
+// 类型克制表：行为攻击属性，列为防守属性，顺序与ElementType一致
+// 未特别规定的组合（包括无属性）均为普通效果
+constexpr EffectivenessChart TYPE_CHART = {{
+    //        无 火 水 草 地面 飞行 虫 机械 普通 光 暗影
+    /* 无   */ {{N, N, N, N, N, N, N, N, N, N, N}},
+    /* 火   */ {{N, W, W, S, N, N, N, S, N, N, N}},
+    /* 水   */ {{N, S, W, W, S, N, N, N, N, N, N}},
+    /* 草   */ {{N, W, S, W, S, W, N, W, N, S, N}},
+    /* 地面 */ {{N, S, N, W, N, X, W, S, N, N, W}}, // 地面对飞行系攻击无效
+    /* 飞行 */ {{N, N, N, S, N, N, S, W, N, N, N}},
+    /* 虫   */ {{N, W, W, S, S, N, N, N, N, W, N}},
+    /* 机械 */ {{N, W, W, N, N, N, N, W, N, N, N}},
+    /* 普通 */ {{N, N, N, N, N, N, N, N, N, N, N}},
+    /* 光   */ {{N, N, N, X, N, N, S, W, N, W, S}}, // 草系精灵不受光系攻击影响
+    /* 暗影 */ {{N, N, N, N, N, N, N, W, N, W, S}},
+}};
+
+// 两个单属性系数合并为对双属性的系数（按照需求的特殊计算公式）
+constexpr double combineEffectiveness(double coef1, double coef2)
+{
+    if (coef1 == SUPER_EFFECTIVE && coef2 == SUPER_EFFECTIVE) {
+        return 2.0; // 两个都是克制，效果翻倍
+    } else if (coef1 == NO_EFFECT || coef2 == NO_EFFECT) {
+        return (coef1 + coef2) / 4.0; // 至少一个无效
+    } else {
+        return (coef1 + coef2) / 2.0; // 其他情况取平均值
+    }
+}
+
+// 单属性攻击 × (主属性, 副属性) 双属性防守方的系数表，编译期由TYPE_CHART生成
+constexpr DualEffectivenessChart buildDualChart()
+{
+    DualEffectivenessChart chart{};
+    for (int attack = 0; attack < ELEMENT_TYPE_COUNT; ++attack) {
+        for (int primary = 0; primary < ELEMENT_TYPE_COUNT; ++primary) {
+            for (int secondary = 0; secondary < ELEMENT_TYPE_COUNT; ++secondary) {
+                chart[attack][primary][secondary] = combineEffectiveness(TYPE_CHART[attack][primary], TYPE_CHART[attack][secondary]);
+            }
+        }
+    }
+    return chart;
+}
+
+constexpr DualEffectivenessChart DUAL_TYPE_CHART = buildDualChart();
+
+static_assert(TYPE_CHART[static_cast<int>(ElementType::GROUND)][static_cast<int>(ElementType::FLYING)] == NO_EFFECT,
+              "克制表的行列顺序必须与ElementType一致");
+
+} // namespace
 
 Type::Type(ElementType primaryType) 
     : m_primaryType(primaryType), m_secondaryType(primaryType), m_isDualType(false) {
-    // 确保类型关系表已初始化
-    if (s_typeEffectiveness.isEmpty()) {
-        initTypeEffectivenessTable();
-    }
 }
 
 Type::Type(ElementType primaryType, ElementType secondaryType) 
     : m_primaryType(primaryType), m_secondaryType(secondaryType), m_isDualType(true) {
-    // 确保类型关系表已初始化
-    if (s_typeEffectiveness.isEmpty()) {
-        initTypeEffectivenessTable();
-    }
 }
 
 QString Type::getName() const {
@@ -60,195 +117,23 @@ QString Type::getElementTypeName(ElementType type) {
     return getTypeName(type);
 }
 
-// 初始化类型克制关系表
-void Type::initTypeEffectivenessTable() {
-    // 定义系数，按照需求中的配置
-    const double SUPER_EFFECTIVE = 1.5;    // 克制
-    const double NORMAL = 1.0;             // 普通
-    const double NOT_VERY_EFFECTIVE = 0.75; // 微弱
-    const double NO_EFFECT = 0.0;          // 无效
-    
-    // 草系攻击效果
-    s_typeEffectiveness[{ElementType::GRASS, ElementType::WATER}] = SUPER_EFFECTIVE;
-    s_typeEffectiveness[{ElementType::GRASS, ElementType::GROUND}] = SUPER_EFFECTIVE;
-    s_typeEffectiveness[{ElementType::GRASS, ElementType::LIGHT}] = SUPER_EFFECTIVE;
-    
-    s_typeEffectiveness[{ElementType::GRASS, ElementType::NORMAL}] = NORMAL;
-    s_typeEffectiveness[{ElementType::GRASS, ElementType::SHADOW}] = NORMAL;
-    s_typeEffectiveness[{ElementType::GRASS, ElementType::BUG}] = NORMAL;
-    
-    s_typeEffectiveness[{ElementType::GRASS, ElementType::GRASS}] = NOT_VERY_EFFECTIVE;
-    s_typeEffectiveness[{ElementType::GRASS, ElementType::FIRE}] = NOT_VERY_EFFECTIVE;
-    s_typeEffectiveness[{ElementType::GRASS, ElementType::FLYING}] = NOT_VERY_EFFECTIVE;
-    s_typeEffectiveness[{ElementType::GRASS, ElementType::MACHINE}] = NOT_VERY_EFFECTIVE;
-    
-    // 水系攻击效果
-    s_typeEffectiveness[{ElementType::WATER, ElementType::FIRE}] = SUPER_EFFECTIVE;
-    s_typeEffectiveness[{ElementType::WATER, ElementType::GROUND}] = SUPER_EFFECTIVE;
-    
-    s_typeEffectiveness[{ElementType::WATER, ElementType::FLYING}] = NORMAL;
-    s_typeEffectiveness[{ElementType::WATER, ElementType::MACHINE}] = NORMAL;
-    s_typeEffectiveness[{ElementType::WATER, ElementType::NORMAL}] = NORMAL;
-    s_typeEffectiveness[{ElementType::WATER, ElementType::LIGHT}] = NORMAL;
-    s_typeEffectiveness[{ElementType::WATER, ElementType::SHADOW}] = NORMAL;
-    s_typeEffectiveness[{ElementType::WATER, ElementType::BUG}] = NORMAL;
-    
-    s_typeEffectiveness[{ElementType::WATER, ElementType::GRASS}] = NOT_VERY_EFFECTIVE;
-    s_typeEffectiveness[{ElementType::WATER, ElementType::WATER}] = NOT_VERY_EFFECTIVE;
-    
-    // 火系攻击效果
-    s_typeEffectiveness[{ElementType::FIRE, ElementType::GRASS}] = SUPER_EFFECTIVE;
-    s_typeEffectiveness[{ElementType::FIRE, ElementType::MACHINE}] = SUPER_EFFECTIVE;
-    
-    s_typeEffectiveness[{ElementType::FIRE, ElementType::FLYING}] = NORMAL;
-    s_typeEffectiveness[{ElementType::FIRE, ElementType::GROUND}] = NORMAL;
-    s_typeEffectiveness[{ElementType::FIRE, ElementType::NORMAL}] = NORMAL;
-    s_typeEffectiveness[{ElementType::FIRE, ElementType::LIGHT}] = NORMAL;
-    s_typeEffectiveness[{ElementType::FIRE, ElementType::SHADOW}] = NORMAL;
-    s_typeEffectiveness[{ElementType::FIRE, ElementType::BUG}] = NORMAL;
-    
-    s_typeEffectiveness[{ElementType::FIRE, ElementType::WATER}] = NOT_VERY_EFFECTIVE;
-    s_typeEffectiveness[{ElementType::FIRE, ElementType::FIRE}] = NOT_VERY_EFFECTIVE;
-    
-    // 飞行系攻击效果
-    s_typeEffectiveness[{ElementType::FLYING, ElementType::GRASS}] = SUPER_EFFECTIVE;
-    s_typeEffectiveness[{ElementType::FLYING, ElementType::BUG}] = SUPER_EFFECTIVE;
-    
-    s_typeEffectiveness[{ElementType::FLYING, ElementType::WATER}] = NORMAL;
-    s_typeEffectiveness[{ElementType::FLYING, ElementType::FIRE}] = NORMAL;
-    s_typeEffectiveness[{ElementType::FLYING, ElementType::FLYING}] = NORMAL;
-    s_typeEffectiveness[{ElementType::FLYING, ElementType::GROUND}] = NORMAL;
-    s_typeEffectiveness[{ElementType::FLYING, ElementType::NORMAL}] = NORMAL;
-    s_typeEffectiveness[{ElementType::FLYING, ElementType::LIGHT}] = NORMAL;
-    s_typeEffectiveness[{ElementType::FLYING, ElementType::SHADOW}] = NORMAL;
-    
-    s_typeEffectiveness[{ElementType::FLYING, ElementType::MACHINE}] = NOT_VERY_EFFECTIVE;
-    
-    // 地面对飞行系攻击无效
-    s_typeEffectiveness[{ElementType::GROUND, ElementType::FLYING}] = NO_EFFECT;
-    
-    // 机械系攻击效果
-    s_typeEffectiveness[{ElementType::MACHINE, ElementType::GRASS}] = NORMAL;
-    s_typeEffectiveness[{ElementType::MACHINE, ElementType::FLYING}] = NORMAL;
-    s_typeEffectiveness[{ElementType::MACHINE, ElementType::GROUND}] = NORMAL;
-    s_typeEffectiveness[{ElementType::MACHINE, ElementType::NORMAL}] = NORMAL;
-    s_typeEffectiveness[{ElementType::MACHINE, ElementType::LIGHT}] = NORMAL;
-    s_typeEffectiveness[{ElementType::MACHINE, ElementType::SHADOW}] = NORMAL;
-    s_typeEffectiveness[{ElementType::MACHINE, ElementType::BUG}] = NORMAL;
-    
-    s_typeEffectiveness[{ElementType::MACHINE, ElementType::WATER}] = NOT_VERY_EFFECTIVE;
-    s_typeEffectiveness[{ElementType::MACHINE, ElementType::FIRE}] = NOT_VERY_EFFECTIVE;
-    s_typeEffectiveness[{ElementType::MACHINE, ElementType::MACHINE}] = NOT_VERY_EFFECTIVE;
-    
-    // 地面系攻击效果
-    s_typeEffectiveness[{ElementType::GROUND, ElementType::FIRE}] = SUPER_EFFECTIVE;
-    s_typeEffectiveness[{ElementType::GROUND, ElementType::MACHINE}] = SUPER_EFFECTIVE;
-    
-    s_typeEffectiveness[{ElementType::GROUND, ElementType::WATER}] = NORMAL;
-    s_typeEffectiveness[{ElementType::GROUND, ElementType::GROUND}] = NORMAL;
-    s_typeEffectiveness[{ElementType::GROUND, ElementType::NORMAL}] = NORMAL;
-    s_typeEffectiveness[{ElementType::GROUND, ElementType::LIGHT}] = NORMAL;
-    
-    s_typeEffectiveness[{ElementType::GROUND, ElementType::GRASS}] = NOT_VERY_EFFECTIVE;
-    s_typeEffectiveness[{ElementType::GROUND, ElementType::SHADOW}] = NOT_VERY_EFFECTIVE;
-    s_typeEffectiveness[{ElementType::GROUND, ElementType::BUG}] = NOT_VERY_EFFECTIVE;
-    
-    // 飞行系精灵不受地面系攻击影响
-    s_typeEffectiveness[{ElementType::GROUND, ElementType::FLYING}] = NO_EFFECT;
-    
-    // 普通系攻击效果
-    s_typeEffectiveness[{ElementType::NORMAL, ElementType::FIRE}] = NORMAL;
-    s_typeEffectiveness[{ElementType::NORMAL, ElementType::WATER}] = NORMAL;
-    s_typeEffectiveness[{ElementType::NORMAL, ElementType::GRASS}] = NORMAL;
-    s_typeEffectiveness[{ElementType::NORMAL, ElementType::GROUND}] = NORMAL;
-    s_typeEffectiveness[{ElementType::NORMAL, ElementType::FLYING}] = NORMAL;
-    s_typeEffectiveness[{ElementType::NORMAL, ElementType::BUG}] = NORMAL;
-    s_typeEffectiveness[{ElementType::NORMAL, ElementType::MACHINE}] = NORMAL;
-    s_typeEffectiveness[{ElementType::NORMAL, ElementType::LIGHT}] = NORMAL;
-    s_typeEffectiveness[{ElementType::NORMAL, ElementType::SHADOW}] = NORMAL;
-    
-    // 光系攻击效果
-    s_typeEffectiveness[{ElementType::LIGHT, ElementType::SHADOW}] = SUPER_EFFECTIVE;
-    s_typeEffectiveness[{ElementType::LIGHT, ElementType::BUG}] = SUPER_EFFECTIVE;
-    
-    s_typeEffectiveness[{ElementType::LIGHT, ElementType::WATER}] = NORMAL;
-    s_typeEffectiveness[{ElementType::LIGHT, ElementType::FIRE}] = NORMAL;
-    s_typeEffectiveness[{ElementType::LIGHT, ElementType::FLYING}] = NORMAL;
-    s_typeEffectiveness[{ElementType::LIGHT, ElementType::GROUND}] = NORMAL;
-    s_typeEffectiveness[{ElementType::LIGHT, ElementType::NORMAL}] = NORMAL;
-    
-    s_typeEffectiveness[{ElementType::LIGHT, ElementType::MACHINE}] = NOT_VERY_EFFECTIVE;
-    s_typeEffectiveness[{ElementType::LIGHT, ElementType::LIGHT}] = NOT_VERY_EFFECTIVE;
-    
-    // 草系精灵不受光系攻击影响
-    s_typeEffectiveness[{ElementType::LIGHT, ElementType::GRASS}] = NO_EFFECT;
-    
-    // 暗影系攻击效果
-    s_typeEffectiveness[{ElementType::SHADOW, ElementType::SHADOW}] = SUPER_EFFECTIVE;
-    
-    s_typeEffectiveness[{ElementType::SHADOW, ElementType::GRASS}] = NORMAL;
-    s_typeEffectiveness[{ElementType::SHADOW, ElementType::WATER}] = NORMAL;
-    s_typeEffectiveness[{ElementType::SHADOW, ElementType::FIRE}] = NORMAL;
-    s_typeEffectiveness[{ElementType::SHADOW, ElementType::FLYING}] = NORMAL;
-    s_typeEffectiveness[{ElementType::SHADOW, ElementType::GROUND}] = NORMAL;
-    s_typeEffectiveness[{ElementType::SHADOW, ElementType::NORMAL}] = NORMAL;
-    s_typeEffectiveness[{ElementType::SHADOW, ElementType::BUG}] = NORMAL;
-    
-    s_typeEffectiveness[{ElementType::SHADOW, ElementType::MACHINE}] = NOT_VERY_EFFECTIVE;
-    s_typeEffectiveness[{ElementType::SHADOW, ElementType::LIGHT}] = NOT_VERY_EFFECTIVE;
-    
-    // 虫系攻击效果
-    s_typeEffectiveness[{ElementType::BUG, ElementType::GRASS}] = SUPER_EFFECTIVE;
-    s_typeEffectiveness[{ElementType::BUG, ElementType::GROUND}] = SUPER_EFFECTIVE;
-    
-    s_typeEffectiveness[{ElementType::BUG, ElementType::FLYING}] = NORMAL;
-    s_typeEffectiveness[{ElementType::BUG, ElementType::MACHINE}] = NORMAL;
-    s_typeEffectiveness[{ElementType::BUG, ElementType::NORMAL}] = NORMAL;
-    s_typeEffectiveness[{ElementType::BUG, ElementType::SHADOW}] = NORMAL;
-    
-    s_typeEffectiveness[{ElementType::BUG, ElementType::WATER}] = NOT_VERY_EFFECTIVE;
-    s_typeEffectiveness[{ElementType::BUG, ElementType::FIRE}] = NOT_VERY_EFFECTIVE;
-    s_typeEffectiveness[{ElementType::BUG, ElementType::LIGHT}] = NOT_VERY_EFFECTIVE;
+double Type::getTypeEffectiveness(ElementType attackType, ElementType defenseType) {
+    return TYPE_CHART[static_cast<int>(attackType)][static_cast<int>(defenseType)];
 }
 
-double Type::getTypeEffectiveness(ElementType attackType, ElementType defenseType) {
-    if (s_typeEffectiveness.isEmpty()) {
-        initTypeEffectivenessTable();
-    }
-    
-    QPair<ElementType, ElementType> key = {attackType, defenseType};
-    if (s_typeEffectiveness.contains(key)) {
-        return s_typeEffectiveness[key];
+double Type::getEffectivenessAgainst(ElementType attackType, const Type &defenseType) {
+    const int attack = static_cast<int>(attackType);
+    if (!defenseType.m_isDualType) {
+        return TYPE_CHART[attack][static_cast<int>(defenseType.m_primaryType)];
     }
-    
-    // 默认为普通效果
-    return 1.0;
+    return DUAL_TYPE_CHART[attack][static_cast<int>(defenseType.m_primaryType)][static_cast<int>(defenseType.m_secondaryType)];
 }
 
 // 计算属性克制系数
 double Type::calculateEffectiveness(const Type& attackType, const Type& defenseType) {
-    // 单一属性攻击单一属性
-    if (!attackType.hasDualType() && !defenseType.hasDualType()) {
-        return getTypeEffectiveness(attackType.getPrimaryType(), defenseType.getPrimaryType());
-    }
-    
-    // 单一属性攻击双属性
-    if (!attackType.hasDualType() && defenseType.hasDualType()) {
-        ElementType atkType = attackType.getPrimaryType();
-        ElementType defType1 = defenseType.getPrimaryType();
-        ElementType defType2 = defenseType.getSecondaryType();
-        
-        double coef1 = getTypeEffectiveness(atkType, defType1);
-        double coef2 = getTypeEffectiveness(atkType, defType2);
-        
-        // 按照需求的特殊计算公式
-        if (coef1 == 1.5 && coef2 == 1.5) {
-            return 2.0; // 两个都是克制，效果翻倍
-        } else if (coef1 == 0.0 || coef2 == 0.0) {
-            return (coef1 + coef2) / 4.0; // 至少一个无效
-        } else {
-            return (coef1 + coef2) / 2.0; // 其他情况取平均值
-        }
+    // 单一属性攻击：直接查预先算好的表
+    if (!attackType.hasDualType()) {
+        return getEffectivenessAgainst(attackType.getPrimaryType(), defenseType);
     }
     
     // 双属性攻击单一属性
@@ -257,17 +142,7 @@ double Type::calculateEffectiveness(const Type& attackType, const Type& defenseT
         ElementType atkType2 = attackType.getSecondaryType();
         ElementType defType = defenseType.getPrimaryType();
         
-        double coef1 = getTypeEffectiveness(atkType1, defType);
-        double coef2 = getTypeEffectiveness(atkType2, defType);
-        
-        // 按照需求的特殊计算公式
-        if (coef1 == 1.5 && coef2 == 1.5) {
-            return 2.0; // 两个都是克制，效果翻倍
-        } else if (coef1 == 0.0 || coef2 == 0.0) {
-            return (coef1 + coef2) / 4.0; // 至少一个无效
-        } else {
-            return (coef1 + coef2) / 2.0; // 其他情况取平均值
-        }
+        return combineEffectiveness(getTypeEffectiveness(atkType1, defType), getTypeEffectiveness(atkType2, defType));
     }
     
     // 双属性攻击双属性
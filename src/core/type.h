@@ -2,8 +2,6 @@
 #define TYPE_H
 
 #include <QString>
-#include <QMap>
-#include <QPair>
 #include <QVector>
 
 // 精灵属性枚举
@@ -21,6 +19,8 @@ enum class ElementType {
     SHADOW      // 暗影/黑暗
 };
 
+const int ELEMENT_TYPE_COUNT = 11; // ElementType的取值个数，用作克制表的维度
+
 class Type {
 public:
     // 构造函数：单属性
@@ -47,19 +47,16 @@ public:
     // 获取属性对应的颜色
     static QString getElementTypeColor(ElementType type);
     
-    // 获取属性克制关系
+    // 获取属性克制关系（单属性对单属性，编译期常量表）
     static double getTypeEffectiveness(ElementType attackType, ElementType defenseType);
-    
+    // 单属性攻击对防守方（单或双属性）的系数，等同于calculateEffectiveness(Type(attackType), defenseType)，
+    // 结果已按全部组合预先算好
+    static double getEffectivenessAgainst(ElementType attackType, const Type &defenseType);
+
 private:
     ElementType m_primaryType;      // 主属性
     ElementType m_secondaryType;    // 副属性
     bool m_isDualType;              // 是否为双属性
-    
-    // 类型克制关系的静态映射表
-    static QMap<QPair<ElementType, ElementType>, double> s_typeEffectiveness;
-    
-    // 初始化类型克制关系表
-    static void initTypeEffectivenessTable();
 };
 
 #endif // TYPE_H
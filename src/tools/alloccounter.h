@@ -0,0 +1,14 @@
+// src/tools/alloccounter.h
+#ifndef ALLOCCOUNTER_H
+#define ALLOCCOUNTER_H
+
+#include <QtGlobal>
+
+// 进程内的堆分配计数
+// alloccounter.cpp替换了全局的operator new/delete，只链接进需要统计分配次数的命令行工具，
+// 不进入shanhai_core和游戏本体。计数是原子的，多线程下同样准确。
+
+// 进程启动以来operator new被调用的次数
+quint64 getHeapAllocationCount();
+
+#endif // ALLOCCOUNTER_H
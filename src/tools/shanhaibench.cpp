@@ -0,0 +1,309 @@
+// src/tools/shanhaibench.cpp
+// 战斗热点路径的微基准：伤害公式、命中判定、属性克制、能力等级修正、行动排序、整回合结算、
+// 精灵创建与大存档的保存/载入。每项先校准迭代次数，再重复测量取中位数，同时报告每次操作的堆分配次数，
+// 作为各项性能改动前后对比的基线。
+//
+// 用法示例：
+//   shanhai_bench
+//   shanhai_bench --filter type/ --min-time 200 --repetitions 9
+//   shanhai_bench --format csv > baseline.csv
+#include <QCoreApplication>
+#include <QCommandLineParser>
+#include <QElapsedTimer>
+#include <QStandardPaths>
+#include <QTextStream>
+#include <QStringList>
+#include <QVector>
+#include <algorithm>
+#include <functional>
+#include <vector>
+#include "core/creature.h"
+#include "core/gameengine.h"
+#include "core/savesystem.h"
+#include "battle/battlesystem.h"
+#include "simcommon.h"
+#include "alloccounter.h"
+
+// 访问BattleSystem内部阶段（行动排序、回合结算），由BattleSystem声明为友元
+class BattleBenchAccess
+{
+public:
+    // 双方都选第skillIndex个技能入队，回合停在结算之前
+    static void queueBothActions(BattleSystem &battle, int skillIndex)
+    {
+        battle.queuePlayerAction(BattleAction::USE_SKILL, skillIndex);
+        battle.queueOpponentAction(BattleAction::USE_SKILL, skillIndex);
+        battle.m_playerActionSubmittedThisTurn = true;
+        battle.m_opponentActionSubmittedThisTurn = true;
+    }
+
+    // 颠倒队列后重新排序，保证每次都真正发生交换
+    static int sortReversedQueue(BattleSystem &battle)
+    {
+        std::reverse(battle.m_actionQueue.begin(), battle.m_actionQueue.end());
+        battle.sortActionQueue();
+        return battle.m_actionQueue.first().priority;
+    }
+
+    static void executeTurn(BattleSystem &battle)
+    {
+        battle.processTurnExecutePhase();
+    }
+};
+
+namespace {
+
+volatile qint64 g_sink = 0; // 基准结果写入这里，防止被优化掉
+
+struct Benchmark
+{
+    QString name;
+    std::function<qint64(qint64 iterations)> run; // 执行iterations次操作，返回需要保留的结果
+};
+
+struct BenchResult
+{
+    double medianNs;
+    double minNs;
+    double allocsPerOp;
+    qint64 iterations;
+};
+
+// 一次计时：返回总纳秒数，allocations为期间的堆分配次数
+qint64 timeRun(const Benchmark &bench, qint64 iterations, quint64 &allocations)
+{
+    const quint64 allocationsBefore = getHeapAllocationCount();
+    QElapsedTimer timer;
+    timer.start();
+    g_sink = g_sink + bench.run(iterations);
+    const qint64 elapsedNs = timer.nsecsElapsed();
+    allocations = getHeapAllocationCount() - allocationsBefore;
+    return elapsedNs;
+}
+
+BenchResult measure(const Benchmark &bench, qint64 minTimeNs, int repetitions)
+{
+    // 迭代次数按2倍增长，直到一次运行达到最短时间
+    quint64 allocations = 0;
+    qint64 iterations = 1;
+    qint64 elapsedNs = timeRun(bench, iterations, allocations);
+    while (elapsedNs < minTimeNs && iterations < (qint64(1) << 40)) {
+        iterations *= 2;
+        elapsedNs = timeRun(bench, iterations, allocations);
+    }
+
+    std::vector<double> samples;
+    samples.reserve(repetitions);
+    for (int i = 0; i < repetitions; ++i) {
+        samples.push_back(double(timeRun(bench, iterations, allocations)) / iterations);
+    }
+    std::sort(samples.begin(), samples.end());
+    return BenchResult{samples[samples.size() / 2], samples.front(), double(allocations) / iterations, iterations};
+}
+
+// 存档相关的基准会打印大量调试信息，测量期间丢弃
+void silentMessageHandler(QtMsgType, const QMessageLogContext &, const QString &)
+{
+}
+
+} // namespace
+
+int main(int argc, char *argv[])
+{
+    QCoreApplication app(argc, argv);
+    QCoreApplication::setApplicationName("shanhai_bench");
+    QCoreApplication::setApplicationVersion("1.0");
+    // 存档写入测试专用目录，不会覆盖玩家的存档
+    QStandardPaths::setTestModeEnabled(true);
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription("山海之战 战斗热点路径微基准");
+    parser.addHelpOption();
+    parser.addVersionOption();
+    QCommandLineOption filterOption(QStringList{"f", "filter"}, "只运行名称包含该字符串的基准", "text");
+    QCommandLineOption minTimeOption(QStringList{"m", "min-time"}, "每次测量的最短时间（毫秒）", "ms", "50");
+    QCommandLineOption repetitionsOption(QStringList{"r", "repetitions"}, "重复测量次数，报告中位数与最小值", "count", "5");
+    QCommandLineOption formatOption("format", "输出格式：table 或 csv", "format", "table");
+    QCommandLineOption rosterOption("roster", "存档基准中的精灵数量", "count", "500");
+    parser.addOption(filterOption);
+    parser.addOption(minTimeOption);
+    parser.addOption(repetitionsOption);
+    parser.addOption(formatOption);
+    parser.addOption(rosterOption);
+    parser.process(app);
+
+    QTextStream out(stdout);
+    QTextStream err(stderr);
+    const QString format = parser.value(formatOption);
+    if (format != "table" && format != "csv") {
+        err << "未知的输出格式: " << format << Qt::endl;
+        return 1;
+    }
+    const qint64 minTimeNs = qMax(1, parser.value(minTimeOption).toInt()) * qint64(1000000);
+    const int repetitions = qMax(1, parser.value(repetitionsOption).toInt());
+    const int rosterSize = qMax(1, parser.value(rosterOption).toInt());
+
+    // 公共场景：固定种子的一场对战，停在第1回合的输入阶段
+    QVector<TeamMember> playerMembers;
+    QVector<TeamMember> opponentMembers;
+    QString error;
+    parseTeam("TungTungTung:30,LiriliLarila:30", playerMembers, error);
+    parseTeam("CappuccinoAssassino:30,TralaleroTralala:30", opponentMembers, error);
+    QVector<Creature *> playerTeam = buildTeam(playerMembers);
+    QVector<Creature *> opponentTeam = buildTeam(opponentMembers);
+
+    BattleSystem battle;
+    battle.setLogSink(nullptr);
+    battle.setStateHashEnabled(false); // 反复结算同一回合时哈希列表不必增长
+    battle.setTurnResolutionMode(TurnResolutionMode::EXTERNAL);
+    battle.setRandomSeed(1);
+    battle.initBattle(playerTeam, opponentTeam, true);
+
+    Creature *attacker = battle.getPlayerActiveCreature();
+    Creature *defender = battle.getOpponentActiveCreature();
+    Skill *attackSkill = nullptr;
+    int attackSkillIndex = 0;
+    for (int i = 0; i < attacker->getSkillCount() && !attackSkill; ++i) {
+        if (attacker->getSkill(i)->getCategory() != SkillCategory::STATUS) {
+            attackSkill = attacker->getSkill(i);
+            attackSkillIndex = i;
+        }
+    }
+    if (!attackSkill) {
+        err << "找不到攻击技能" << Qt::endl;
+        return 1;
+    }
+
+    BattleBenchAccess::queueBothActions(battle, attackSkillIndex);
+    BattleState turnStart;
+    battle.exportState(turnStart);
+
+    // 单属性与双属性防守方的所有组合
+    QVector<Type> singleTypes;
+    QVector<Type> dualTypes;
+    for (int first = 1; first < ELEMENT_TYPE_COUNT; ++first) { // 跳过ElementType::NONE
+        singleTypes.append(Type(static_cast<ElementType>(first)));
+        for (int second = 1; second < ELEMENT_TYPE_COUNT; ++second) {
+            if (second != first) dualTypes.append(Type(static_cast<ElementType>(first), static_cast<ElementType>(second)));
+        }
+    }
+
+    GameEngine *engine = GameEngine::getInstance();
+    engine->init();
+    const QStringList speciesKeys = Creature::getSpeciesKeys();
+
+    QVector<Benchmark> benchmarks;
+    benchmarks.append({"battle/calculateDamage", [&](qint64 n) {
+        qint64 sum = 0;
+        for (qint64 i = 0; i < n; ++i) sum += battle.calculateDamage(attacker, defender, attackSkill);
+        return sum;
+    }});
+    benchmarks.append({"battle/checkSkillHit", [&](qint64 n) {
+        qint64 hits = 0;
+        for (qint64 i = 0; i < n; ++i) hits += battle.checkSkillHit(attacker, defender, attackSkill);
+        return hits;
+    }});
+    benchmarks.append({"type/effectiveness_single", [&](qint64 n) {
+        double sum = 0;
+        const int count = singleTypes.size();
+        for (qint64 i = 0; i < n; ++i) {
+            sum += Type::calculateEffectiveness(singleTypes[i % count], singleTypes[(i / count) % count]);
+        }
+        return qint64(sum);
+    }});
+    benchmarks.append({"type/effectiveness_dual", [&](qint64 n) {
+        double sum = 0;
+        for (qint64 i = 0; i < n; ++i) {
+            sum += Type::calculateEffectiveness(singleTypes[i % singleTypes.size()], dualTypes[i % dualTypes.size()]);
+        }
+        return qint64(sum);
+    }});
+    benchmarks.append({"stats/calculateModifier", [&](qint64 n) {
+        double sum = 0;
+        for (qint64 i = 0; i < n; ++i) {
+            const StatType stat = static_cast<StatType>(1 + i % BATTLE_STATE_STAT_STAGE_COUNT);
+            sum += StatStages::calculateModifier(stat, int(i % 13) - 6);
+        }
+        return qint64(sum);
+    }});
+    benchmarks.append({"battle/sortActionQueue", [&](qint64 n) {
+        qint64 sum = 0;
+        for (qint64 i = 0; i < n; ++i) sum += BattleBenchAccess::sortReversedQueue(battle);
+        return sum;
+    }});
+    benchmarks.append({"battle/processTurnExecutePhase", [&](qint64 n) {
+        qint64 sum = 0;
+        for (qint64 i = 0; i < n; ++i) {
+            battle.importState(turnStart);
+            BattleBenchAccess::executeTurn(battle);
+            sum += defender->getCurrentHP();
+        }
+        return sum;
+    }});
+    benchmarks.append({"engine/createCreature", [&](qint64 n) {
+        qint64 sum = 0;
+        for (qint64 i = 0; i < n; ++i) {
+            Creature *creature = engine->createCreature(static_cast<SpeciesId>(i % SPECIES_COUNT), 10);
+            sum += creature->getMaxHP();
+            delete creature;
+        }
+        return sum;
+    }});
+    benchmarks.append({"engine/createCreatureByKey", [&](qint64 n) {
+        // 键名先经查找表换算为种类编号，对应存档、命令行等输入路径
+        qint64 sum = 0;
+        for (qint64 i = 0; i < n; ++i) {
+            Creature *creature = engine->createCreature(speciesKeys[i % speciesKeys.size()], 10);
+            sum += creature->getMaxHP();
+            delete creature;
+        }
+        return sum;
+    }});
+
+    // 大存档：rosterSize只可用精灵，先写出一次供载入基准使用
+    const QString saveName = "shanhai_bench";
+    engine->clearAvailableCreatures();
+    for (int i = 0; i < rosterSize; ++i) {
+        engine->addAvailableCreature(Creature::createSpecies(speciesKeys[i % speciesKeys.size()], 1 + i % 100));
+    }
+    SaveSystem *saveSystem = SaveSystem::getInstance();
+    benchmarks.append({QString("save/saveGame_%1").arg(rosterSize), [&](qint64 n) {
+        qint64 saved = 0;
+        for (qint64 i = 0; i < n; ++i) saved += saveSystem->saveGame(saveName);
+        return saved;
+    }});
+    benchmarks.append({QString("save/loadGame_%1").arg(rosterSize), [&](qint64 n) {
+        qint64 loaded = 0;
+        for (qint64 i = 0; i < n; ++i) loaded += saveSystem->loadGame(saveName);
+        return loaded;
+    }});
+
+    const QString filter = parser.value(filterOption);
+    if (format == "csv") {
+        out << "benchmark,ns_per_op,min_ns_per_op,allocs_per_op,iterations" << Qt::endl;
+    } else {
+        out << QString("%1 %2 %3 %4 %5").arg(QString("benchmark"), -34).arg(QString("ns/op"), 12)
+                   .arg(QString("min ns/op"), 12).arg(QString("allocs/op"), 10).arg(QString("iterations"), 12) << Qt::endl;
+    }
+    QtMessageHandler previousHandler = qInstallMessageHandler(silentMessageHandler);
+    for (const Benchmark &bench : benchmarks) {
+        if (!filter.isEmpty() && !bench.name.contains(filter)) continue;
+        const BenchResult result = measure(bench, minTimeNs, repetitions);
+        if (format == "csv") {
+            out << bench.name << ',' << QString::number(result.medianNs, 'f', 2) << ','
+                << QString::number(result.minNs, 'f', 2) << ',' << QString::number(result.allocsPerOp, 'f', 3) << ','
+                << result.iterations << Qt::endl;
+        } else {
+            out << QString("%1 %2 %3 %4 %5").arg(bench.name, -34)
+                       .arg(result.medianNs, 12, 'f', 1).arg(result.minNs, 12, 'f', 1)
+                       .arg(result.allocsPerOp, 10, 'f', 2).arg(result.iterations, 12) << Qt::endl;
+        }
+    }
+    qInstallMessageHandler(previousHandler);
+
+    saveSystem->deleteSave(saveName);
+    engine->clearAvailableCreatures();
+    qDeleteAll(playerTeam);
+    qDeleteAll(opponentTeam);
+    return 0;
+}
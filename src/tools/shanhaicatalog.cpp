@@ -0,0 +1,104 @@
+// src/tools/shanhaicatalog.cpp
+// 精灵数据目录编译器：读取JSON描述，检查后写出游戏启动时直接映射的二进制目录
+//
+// 用法示例：
+//   shanhai_catalog data/species.json build/species.shcat
+//   shanhai_catalog --list build/species.shcat
+#include <QCoreApplication>
+#include <QCommandLineParser>
+#include <QFile>
+#include <QJsonDocument>
+#include <QJsonParseError>
+#include <QSaveFile>
+#include <QTextStream>
+#include "core/creature.h"
+#include "core/speciescatalog.h"
+
+namespace {
+
+// 逐条列出目录内容，同时确认写出的文件能被游戏载入
+int listCatalog(const QString &path, QTextStream &out, QTextStream &err)
+{
+    SpeciesCatalog catalog;
+    QString error;
+    if (!catalog.open(path, &error)) {
+        err << error << Qt::endl;
+        return 1;
+    }
+    for (int i = 0; i < catalog.getSpeciesCount(); ++i) {
+        const SpeciesRecord *record = catalog.getRecord(i);
+        int skillCount = 0;
+        for (quint8 skill : record->skills) {
+            if (skill != static_cast<quint8>(SkillId::NONE)) ++skillCount;
+        }
+        out << QString("%1  %2  %3  HP %4  技能 %5%6")
+                   .arg(i, 3)
+                   .arg(QString::fromUtf8(catalog.getString(record->keyOffset)), -30)
+                   .arg(QString::fromUtf8(catalog.getString(record->nameOffset)), -30)
+                   .arg(record->baseStats[0])
+                   .arg(skillCount)
+                   .arg(i < SPECIES_COUNT ? "" : "  (数据种类)")
+            << Qt::endl;
+    }
+    return 0;
+}
+
+} // namespace
+
+int main(int argc, char *argv[])
+{
+    QCoreApplication app(argc, argv);
+    QCoreApplication::setApplicationName("shanhai_catalog");
+    QCoreApplication::setApplicationVersion("1.0");
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription("山海之战 精灵数据目录编译器");
+    parser.addHelpOption();
+    parser.addVersionOption();
+    QCommandLineOption listOption(QStringList{"l", "list"}, "列出已编译目录的内容", "file");
+    parser.addOption(listOption);
+    parser.addPositionalArgument("input", "精灵数据JSON，如 data/species.json");
+    parser.addPositionalArgument("output", "输出的二进制目录，如 species.shcat");
+    parser.process(app);
+
+    QTextStream out(stdout);
+    QTextStream err(stderr);
+
+    if (parser.isSet(listOption)) {
+        return listCatalog(parser.value(listOption), out, err);
+    }
+
+    const QStringList arguments = parser.positionalArguments();
+    if (arguments.size() != 2) {
+        parser.showHelp(1);
+    }
+
+    QFile input(arguments[0]);
+    if (!input.open(QIODevice::ReadOnly)) {
+        err << QString("无法读取%1: %2").arg(arguments[0], input.errorString()) << Qt::endl;
+        return 1;
+    }
+    QJsonParseError parseError;
+    const QJsonDocument document = QJsonDocument::fromJson(input.readAll(), &parseError);
+    if (parseError.error != QJsonParseError::NoError) {
+        err << QString("%1: 第%2个字符处JSON格式错误: %3")
+                   .arg(arguments[0]).arg(parseError.offset).arg(parseError.errorString())
+            << Qt::endl;
+        return 1;
+    }
+
+    QByteArray catalog;
+    QString error;
+    if (!SpeciesCatalog::compile(document, catalog, &error)) {
+        err << arguments[0] << ": " << error << Qt::endl;
+        return 1;
+    }
+
+    // 先写临时文件再替换，运行中的游戏映射着旧文件时也不会读到一半的内容
+    QSaveFile output(arguments[1]);
+    if (!output.open(QIODevice::WriteOnly) || output.write(catalog) != catalog.size() || !output.commit()) {
+        err << QString("无法写入%1: %2").arg(arguments[1], output.errorString()) << Qt::endl;
+        return 1;
+    }
+    return listCatalog(arguments[1], out, err);
+}
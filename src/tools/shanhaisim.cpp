@@ -0,0 +1,235 @@
+// src/tools/shanhaisim.cpp
+// 命令行战斗模拟器：不启动事件循环、不创建任何界面，批量进行N场对战并输出统计
+//
+// 用法示例：
+//   shanhai_sim --battles 1000 --player TungTungTung:10,LiriliLarila:8 --opponent CappuccinoAssassino:10
+//   shanhai_sim --battles 1 --seed 42 --record battle.shrp
+//   shanhai_sim --replay battle.shrp
+#include <QCoreApplication>
+#include <QCommandLineParser>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QTextStream>
+#include <QStringList>
+#include <QVector>
+#include <cstdio>
+#include <memory>
+#include "core/creature.h"
+#include "core/speciescatalog.h"
+#include "battle/battlesystem.h"
+#include "battle/battlereplay.h"
+#include "battle/skillregistry.h"
+#include "simcommon.h"
+#include "alloccounter.h"
+
+namespace {
+
+// 全速重放一份回放文件，检查结果与回合数是否与录制时一致
+int replayFile(const QString &path, QTextStream &out, QTextStream &err)
+{
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly)) {
+        err << "无法打开回放文件: " << path << Qt::endl;
+        return 1;
+    }
+    BattleReplay replay;
+    QString error;
+    if (!BattleReplay::deserialize(file.readAll(), replay, &error)) {
+        err << error << Qt::endl;
+        return 1;
+    }
+
+    BattleSystem battle;
+    battle.setLogSink(nullptr);
+    BattleReplayer replayer(replay);
+    if (!replayer.start(battle, &error)) {
+        err << error << Qt::endl;
+        return 1;
+    }
+    QElapsedTimer timer;
+    timer.start();
+    replayer.run();
+    const qint64 elapsedNs = timer.nsecsElapsed();
+
+    out << "replay:         " << path << " (" << file.size() << " bytes)" << Qt::endl;
+    out << "seed:           " << replay.seed << Qt::endl;
+    out << "actions:        " << replay.actions.size() << Qt::endl;
+    out << "turns:          " << battle.getCurrentTurn() << " (recorded " << replay.turnCount << ")" << Qt::endl;
+    out << "result:         " << static_cast<int>(battle.getBattleResult()) << " (recorded " << static_cast<int>(replay.result) << ")" << Qt::endl;
+    out << "elapsed:        " << QString::number(elapsedNs / 1000.0, 'f', 1) << " us" << Qt::endl;
+    out << "turn hashes:    " << battle.getTurnHashes().size() << " (recorded " << replay.turnHashes.size() << ")" << Qt::endl;
+    if (!replayer.matchesRecording()) {
+        if (replayer.getFirstDivergentTurn() > 0) {
+            out << "first divergent turn: " << replayer.getFirstDivergentTurn() << Qt::endl;
+        }
+        out << "MISMATCH" << Qt::endl;
+        return 2;
+    }
+    out << "match" << Qt::endl;
+    return 0;
+}
+
+} // namespace
+
+int main(int argc, char *argv[])
+{
+    // 只创建QCoreApplication用于解析命令行，不调用exec()，整个模拟过程没有事件循环
+    QCoreApplication app(argc, argv);
+    QCoreApplication::setApplicationName("shanhai_sim");
+    QCoreApplication::setApplicationVersion("1.0");
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription("山海之战 无界面战斗模拟器");
+    parser.addHelpOption();
+    parser.addVersionOption();
+    QCommandLineOption battlesOption(QStringList{"n", "battles"}, "对战场数", "count", "100");
+    QCommandLineOption playerOption(QStringList{"p", "player"}, "玩家队伍，如 TungTungTung:10,LiriliLarila:8", "team", "TungTungTung:10");
+    QCommandLineOption opponentOption(QStringList{"o", "opponent"}, "对手队伍，格式同上", "team", "CappuccinoAssassino:10");
+    QCommandLineOption seedOption(QStringList{"s", "seed"}, "随机种子：第i场战斗使用 seed+i，玩家策略也由它派生", "seed", "1");
+    QCommandLineOption maxTurnsOption(QStringList{"t", "max-turns"}, "单场最大回合数，超过记为平局", "turns", "200");
+    QCommandLineOption aiDifficultyOption(QStringList{"d", "ai-difficulty"}, "对手AI难度：0为随机选招，1及以上使用搜索", "level", "0");
+    QCommandLineOption aiSearchOption(QStringList{"a", "ai-search"}, "对手AI搜索算法：mcts 或 expectiminimax", "algorithm", "mcts");
+    QCommandLineOption aiDepthOption("ai-depth", "期望极小极大的最大搜索回合数", "turns", "2");
+    QCommandLineOption logOption(QStringList{"l", "log"}, "战斗日志级别：none、counters、compact 或 full", "level", "none");
+    QCommandLineOption recordOption("record", "把第一场战斗录制为回放文件", "file");
+    QCommandLineOption replayOption("replay", "重放回放文件并检查是否与录制一致（忽略其他选项）", "file");
+    parser.addOption(battlesOption);
+    parser.addOption(playerOption);
+    parser.addOption(opponentOption);
+    parser.addOption(seedOption);
+    parser.addOption(maxTurnsOption);
+    parser.addOption(aiDifficultyOption);
+    parser.addOption(aiSearchOption);
+    parser.addOption(aiDepthOption);
+    parser.addOption(logOption);
+    parser.addOption(recordOption);
+    parser.addOption(replayOption);
+    parser.process(app);
+
+    QTextStream out(stdout);
+    QTextStream err(stderr);
+
+    if (parser.isSet(replayOption)) {
+        return replayFile(parser.value(replayOption), out, err);
+    }
+
+    QVector<TeamMember> playerMembers;
+    QVector<TeamMember> opponentMembers;
+    QString error;
+    if (!parseTeam(parser.value(playerOption), playerMembers, error) ||
+        !parseTeam(parser.value(opponentOption), opponentMembers, error)) {
+        err << error << Qt::endl;
+        return 1;
+    }
+
+    const int battleCount = qMax(1, parser.value(battlesOption).toInt());
+    const int maxTurns = qMax(1, parser.value(maxTurnsOption).toInt());
+    const quint64 baseSeed = parser.value(seedOption).toULongLong();
+    OpponentAIConfig aiConfig = OpponentAIConfig::forDifficulty(parser.value(aiDifficultyOption).toInt());
+    const QString aiSearch = parser.value(aiSearchOption);
+    if (aiSearch != "mcts" && aiSearch != "expectiminimax") {
+        err << "未知的搜索算法: " << aiSearch << Qt::endl;
+        return 1;
+    }
+    if (aiConfig.isSearchEnabled() && aiSearch == "expectiminimax") { // 难度0仍为随机选招
+        aiConfig.algorithm = AISearchAlgorithm::EXPECTIMINIMAX;
+        aiConfig.maxDepth = qMax(1, parser.value(aiDepthOption).toInt());
+    }
+    const QString logLevel = parser.value(logOption);
+    if (logLevel != "none" && logLevel != "counters" && logLevel != "compact" && logLevel != "full") {
+        err << "未知的日志级别: " << logLevel << Qt::endl;
+        return 1;
+    }
+    BattleRandom policyRng(~baseSeed);
+
+    int playerWins = 0;
+    int opponentWins = 0;
+    int draws = 0;
+    qint64 totalTurns = 0;
+    quint64 turnAllocations = 0; // 开战之后回合结算中的堆分配（不含建队与initBattle）
+
+    // 计数与紧凑日志使用外部接收者，跨场累计；完整日志由战斗系统每场清空
+    CounterLogSink counters;
+    CompactLogSink compactLog;
+    qint64 totalEvents = 0;
+
+    BattleSystem battle;
+    battle.setTurnResolutionMode(TurnResolutionMode::SYNCHRONOUS);
+    battle.setOpponentAIConfig(aiConfig);
+    if (logLevel == "none") battle.setLogSink(nullptr);
+    else if (logLevel == "counters") battle.setLogSink(&counters);
+    else if (logLevel == "compact") battle.setLogSink(&compactLog);
+    // 录制器只需要第一场，之后立即卸下，不影响批量模拟的速度
+    std::unique_ptr<BattleReplayRecorder> recorder;
+    if (parser.isSet(recordOption)) recorder.reset(new BattleReplayRecorder(&battle));
+    // 技能注册表与精灵数据目录都在第一次使用时构造，提前构造以免计入第一场战斗的回合分配
+    SkillRegistry::getInstance();
+    SpeciesCatalog::getInstance();
+    QElapsedTimer timer;
+    timer.start();
+
+    for (int i = 0; i < battleCount; ++i) {
+        QVector<Creature *> playerTeam = buildTeam(playerMembers);
+        QVector<Creature *> opponentTeam = buildTeam(opponentMembers);
+
+        // 每场战斗的随机流由种子唯一确定，可单独复现
+        battle.setRandomSeed(baseSeed + quint64(i));
+        // 同步模式：玩家提交后AI立即决策，回合在本次调用内结算完毕
+        battle.initBattle(playerTeam, opponentTeam, false);
+        const quint64 allocationsBefore = getHeapAllocationCount();
+        while (battle.getBattleResult() == BattleResult::ONGOING && battle.getCurrentTurn() <= maxTurns) {
+            submitPlayerAction(battle, policyRng);
+        }
+        turnAllocations += getHeapAllocationCount() - allocationsBefore;
+
+        totalTurns += battle.getCurrentTurn();
+        if (logLevel == "full") {
+            totalEvents += static_cast<qint64>(battle.getBattleEvents().size());
+        }
+        switch (battle.getBattleResult()) {
+            case BattleResult::PLAYER_WIN:   ++playerWins; break;
+            case BattleResult::OPPONENT_WIN: ++opponentWins; break;
+            default:                         ++draws; break; // 平局或超过回合上限
+        }
+
+        if (recorder) {
+            QFile file(parser.value(recordOption));
+            const QByteArray data = recorder->getReplay().serialize();
+            if (!file.open(QIODevice::WriteOnly) || file.write(data) != data.size()) {
+                err << "无法写入回放文件: " << parser.value(recordOption) << Qt::endl;
+                return 1;
+            }
+            out << "recorded:       " << parser.value(recordOption) << " (" << data.size() << " bytes, "
+                << battle.getCurrentTurn() << " turns)" << Qt::endl;
+            recorder.reset();
+        }
+
+        qDeleteAll(playerTeam);
+        qDeleteAll(opponentTeam);
+    }
+
+    const double seconds = qMax<qint64>(1, timer.elapsed()) / 1000.0;
+    out << "battles:        " << battleCount << Qt::endl;
+    out << "player wins:    " << playerWins << QString(" (%1%)").arg(100.0 * playerWins / battleCount, 0, 'f', 2) << Qt::endl;
+    out << "opponent wins:  " << opponentWins << QString(" (%1%)").arg(100.0 * opponentWins / battleCount, 0, 'f', 2) << Qt::endl;
+    out << "draws/timeouts: " << draws << Qt::endl;
+    out << "avg turns:      " << QString::number(double(totalTurns) / battleCount, 'f', 2) << Qt::endl;
+    out << "elapsed:        " << QString::number(seconds, 'f', 3) << " s" << Qt::endl;
+    out << "battles/sec:    " << QString::number(battleCount / seconds, 'f', 1) << Qt::endl;
+    out << "turns/sec:      " << QString::number(totalTurns / seconds, 'f', 1) << Qt::endl;
+    out << "heap allocs:    " << turnAllocations << QString(" during turns (%1 per turn)")
+                                                       .arg(double(turnAllocations) / qMax<qint64>(1, totalTurns), 0, 'f', 3) << Qt::endl;
+    if (logLevel == "counters") {
+        totalEvents = counters.getTotalCount();
+        out << "damage taken:   player " << counters.getDamageTaken(0) << ", opponent " << counters.getDamageTaken(1) << Qt::endl;
+        out << "healing:        player " << counters.getHealingReceived(0) << ", opponent " << counters.getHealingReceived(1) << Qt::endl;
+    } else if (logLevel == "compact") {
+        totalEvents = compactLog.getEventCount();
+        const qint64 bytes = compactLog.getData().size();
+        out << "log bytes:      " << bytes << QString(" (%1 bytes/event)").arg(double(bytes) / qMax<qint64>(1, totalEvents), 0, 'f', 2) << Qt::endl;
+    }
+    if (logLevel != "none") {
+        out << "log events:     " << totalEvents << Qt::endl;
+    }
+    return 0;
+}
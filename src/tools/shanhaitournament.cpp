@@ -0,0 +1,249 @@
+// src/tools/shanhaitournament.cpp
+// 并行循环赛：名单中每一对精灵（含自身镜像，双方位置各算一组）对战K场，
+// 用工作窃取线程池占满所有核心，输出胜率矩阵、带95%置信区间的综合胜率以及每秒对战数。
+// 用于调整BaseStats/Talent数值后的平衡性回归。
+//
+// 用法示例：
+//   shanhai_tournament --battles 10000
+//   shanhai_tournament --roster TungTungTung:10,LiriliLarila:12 --battles 2000 --threads 8
+#include <QCoreApplication>
+#include <QCommandLineParser>
+#include <QElapsedTimer>
+#include <QTextStream>
+#include <QStringList>
+#include <QVector>
+#include <QtMath>
+#include <memory>
+#include <vector>
+#include "core/creature.h"
+#include "battle/battlesystem.h"
+#include "simcommon.h"
+#include "workstealingpool.h"
+
+namespace {
+
+// 95%置信区间对应的正态分位数
+const double CONFIDENCE_Z = 1.96;
+
+// 一组对阵（或一个任务分片）的统计
+struct MatchStats
+{
+    qint64 battles = 0;
+    qint64 wins = 0;   // 玩家一方（行）获胜
+    qint64 losses = 0;
+    qint64 draws = 0;  // 平局或超过回合上限
+    qint64 turns = 0;
+
+    void merge(const MatchStats &other)
+    {
+        battles += other.battles;
+        wins += other.wins;
+        losses += other.losses;
+        draws += other.draws;
+        turns += other.turns;
+    }
+};
+
+// 得分（胜1、平0.5、负0）的均值与95%置信区间半宽（按每场得分的样本方差计算，平局也能正确处理）
+void scoreInterval(qint64 wins, qint64 draws, qint64 battles, double &score, double &halfWidth)
+{
+    score = 0.0;
+    halfWidth = 0.0;
+    if (battles <= 0) return;
+    const double n = static_cast<double>(battles);
+    score = (wins + 0.5 * draws) / n;
+    const double meanSquare = (wins + 0.25 * draws) / n;
+    const double variance = qMax(0.0, meanSquare - score * score);
+    halfWidth = CONFIDENCE_Z * qSqrt(variance / n);
+}
+
+// 一个任务：某组对阵中连续的一段对战
+struct MatchTask
+{
+    int row;      // 玩家一方在名单中的下标
+    int column;   // 对手一方在名单中的下标
+    int first;    // 该组对阵中的起始场次
+    int count;
+};
+
+} // namespace
+
+int main(int argc, char *argv[])
+{
+    QCoreApplication app(argc, argv);
+    QCoreApplication::setApplicationName("shanhai_tournament");
+    QCoreApplication::setApplicationVersion("1.0");
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription("山海之战 并行循环赛");
+    parser.addHelpOption();
+    parser.addVersionOption();
+    QCommandLineOption rosterOption(QStringList{"r", "roster"}, "参赛名单，如 TungTungTung:10,LiriliLarila:8（默认全部精灵种类）", "roster");
+    QCommandLineOption levelOption("level", "使用默认名单时的等级", "level", "10");
+    QCommandLineOption battlesOption(QStringList{"n", "battles"}, "每组对阵的场数", "count", "1000");
+    QCommandLineOption seedOption(QStringList{"s", "seed"}, "随机种子：每场战斗的种子由它与对阵、场次唯一确定", "seed", "1");
+    QCommandLineOption maxTurnsOption(QStringList{"t", "max-turns"}, "单场最大回合数，超过记为平局", "turns", "200");
+    QCommandLineOption threadsOption(QStringList{"j", "threads"}, "工作线程数，0为全部核心", "count", "0");
+    QCommandLineOption chunkOption("chunk", "每个任务包含的场数", "count", "250");
+    parser.addOption(rosterOption);
+    parser.addOption(levelOption);
+    parser.addOption(battlesOption);
+    parser.addOption(seedOption);
+    parser.addOption(maxTurnsOption);
+    parser.addOption(threadsOption);
+    parser.addOption(chunkOption);
+    parser.process(app);
+
+    QTextStream out(stdout);
+    QTextStream err(stderr);
+
+    QString rosterText = parser.value(rosterOption);
+    if (rosterText.isEmpty()) {
+        const int level = qBound(1, parser.value(levelOption).toInt(), MAX_LEVEL);
+        QStringList entries;
+        for (const QString &key : Creature::getSpeciesKeys()) entries.append(QString("%1:%2").arg(key).arg(level));
+        rosterText = entries.join(",");
+    }
+    QVector<TeamMember> roster;
+    QString error;
+    if (!parseTeam(rosterText, roster, error)) {
+        err << error << Qt::endl;
+        return 1;
+    }
+
+    const int rosterSize = roster.size();
+    const int battlesPerPairing = qMax(1, parser.value(battlesOption).toInt());
+    const int maxTurns = qMax(1, parser.value(maxTurnsOption).toInt());
+    const int chunk = qMax(1, parser.value(chunkOption).toInt());
+    const quint64 baseSeed = parser.value(seedOption).toULongLong();
+
+    WorkStealingPool pool(parser.value(threadsOption).toInt());
+    const int threadCount = pool.getThreadCount();
+
+    // 每个工作线程一个战斗系统，跨任务复用；日志关闭，对手为随机选招
+    std::vector<std::unique_ptr<BattleSystem>> battles;
+    for (int i = 0; i < threadCount; ++i) {
+        std::unique_ptr<BattleSystem> battle(new BattleSystem);
+        battle->setTurnResolutionMode(TurnResolutionMode::SYNCHRONOUS);
+        battle->setOpponentAIConfig(OpponentAIConfig::forDifficulty(0));
+        battle->setLogSink(nullptr);
+        battles.push_back(std::move(battle));
+    }
+
+    // 拆分任务：每个任务的结果写入自己的槽位，线程之间不共享任何计数
+    std::vector<MatchTask> tasks;
+    for (int row = 0; row < rosterSize; ++row) {
+        for (int column = 0; column < rosterSize; ++column) {
+            for (int first = 0; first < battlesPerPairing; first += chunk) {
+                tasks.push_back(MatchTask{row, column, first, qMin(chunk, battlesPerPairing - first)});
+            }
+        }
+    }
+    std::vector<MatchStats> taskStats(tasks.size());
+
+    for (size_t t = 0; t < tasks.size(); ++t) {
+        pool.submit([&, t](int worker) {
+            const MatchTask &task = tasks[t];
+            BattleSystem &battle = *battles[worker];
+            MatchStats &stats = taskStats[t];
+            const quint64 pairingSeed = baseSeed + quint64(task.row * rosterSize + task.column) * quint64(battlesPerPairing);
+            for (int k = task.first; k < task.first + task.count; ++k) {
+                // 种子只取决于对阵与场次，结果与线程数、调度顺序无关
+                const quint64 battleSeed = pairingSeed + quint64(k);
+                BattleRandom policyRng(~battleSeed);
+                QVector<Creature *> playerTeam = buildTeam(QVector<TeamMember>{roster[task.row]});
+                QVector<Creature *> opponentTeam = buildTeam(QVector<TeamMember>{roster[task.column]});
+
+                battle.setRandomSeed(battleSeed);
+                battle.initBattle(playerTeam, opponentTeam, false);
+                while (battle.getBattleResult() == BattleResult::ONGOING && battle.getCurrentTurn() <= maxTurns) {
+                    submitPlayerAction(battle, policyRng);
+                }
+
+                ++stats.battles;
+                stats.turns += battle.getCurrentTurn();
+                switch (battle.getBattleResult()) {
+                    case BattleResult::PLAYER_WIN:   ++stats.wins; break;
+                    case BattleResult::OPPONENT_WIN: ++stats.losses; break;
+                    default:                         ++stats.draws; break;
+                }
+
+                qDeleteAll(playerTeam);
+                qDeleteAll(opponentTeam);
+            }
+        });
+    }
+
+    QElapsedTimer timer;
+    timer.start();
+    pool.run();
+    const double seconds = qMax<qint64>(1, timer.elapsed()) / 1000.0;
+
+    // 按任务顺序合并
+    std::vector<MatchStats> pairings(rosterSize * rosterSize);
+    MatchStats total;
+    for (size_t t = 0; t < tasks.size(); ++t) {
+        pairings[tasks[t].row * rosterSize + tasks[t].column].merge(taskStats[t]);
+        total.merge(taskStats[t]);
+    }
+
+    auto label = [&roster](int i) {
+        return QString("%1:%2").arg(roster[i].speciesKey).arg(roster[i].level);
+    };
+    int labelWidth = 8;
+    for (int i = 0; i < rosterSize; ++i) labelWidth = qMax(labelWidth, label(i).size());
+
+    out << "roster:         " << rosterSize << " entries, " << battlesPerPairing << " battles per pairing, "
+        << rosterSize * rosterSize << " pairings" << Qt::endl;
+    out << "threads:        " << threadCount << " (" << tasks.size() << " tasks, " << pool.getStolenCount() << " stolen)" << Qt::endl;
+    out << Qt::endl;
+
+    // 胜率矩阵：行为玩家一方，列为对手一方，数值为行的得分率及其95%置信区间半宽(%)
+    const int cellWidth = 14;
+    out << "score % ± 95% CI (row = player side, column = opponent side)" << Qt::endl;
+    out << QString(labelWidth, ' ');
+    for (int column = 0; column < rosterSize; ++column) out << QString("%1").arg(column + 1, cellWidth);
+    out << Qt::endl;
+    for (int row = 0; row < rosterSize; ++row) {
+        out << QString("%1").arg(label(row), -labelWidth);
+        for (int column = 0; column < rosterSize; ++column) {
+            const MatchStats &stats = pairings[row * rosterSize + column];
+            double score = 0.0;
+            double halfWidth = 0.0;
+            scoreInterval(stats.wins, stats.draws, stats.battles, score, halfWidth);
+            out << QString("%1 ± %2").arg(100.0 * score, cellWidth - 6, 'f', 1).arg(100.0 * halfWidth, 3, 'f', 1);
+        }
+        out << "  (" << row + 1 << ")" << Qt::endl;
+    }
+    out << Qt::endl;
+
+    // 综合得分：双方位置的全部对阵，不计自身镜像
+    out << "overall score (both sides, mirrors excluded, 95% CI)" << Qt::endl;
+    for (int i = 0; i < rosterSize; ++i) {
+        qint64 wins = 0;
+        qint64 draws = 0;
+        qint64 count = 0;
+        for (int j = 0; j < rosterSize; ++j) {
+            if (i == j) continue;
+            const MatchStats &asPlayer = pairings[i * rosterSize + j];
+            const MatchStats &asOpponent = pairings[j * rosterSize + i];
+            wins += asPlayer.wins + asOpponent.losses;
+            draws += asPlayer.draws + asOpponent.draws;
+            count += asPlayer.battles + asOpponent.battles;
+        }
+        double score = 0.0;
+        double halfWidth = 0.0;
+        scoreInterval(wins, draws, count, score, halfWidth);
+        out << QString("%1").arg(label(i), -labelWidth)
+            << QString("%1% ± %2%").arg(100.0 * score, 6, 'f', 2).arg(100.0 * halfWidth, 0, 'f', 2)
+            << "  (" << count << " battles, " << draws << " draws)" << Qt::endl;
+    }
+    out << Qt::endl;
+
+    out << "battles:        " << total.battles << Qt::endl;
+    out << "draws/timeouts: " << total.draws << Qt::endl;
+    out << "avg turns:      " << QString::number(double(total.turns) / qMax<qint64>(1, total.battles), 'f', 2) << Qt::endl;
+    out << "elapsed:        " << QString::number(seconds, 'f', 3) << " s" << Qt::endl;
+    out << "battles/sec:    " << QString::number(total.battles / seconds, 'f', 1) << Qt::endl;
+    return 0;
+}
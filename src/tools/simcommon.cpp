@@ -0,0 +1,84 @@
+// src/tools/simcommon.cpp
+#include "simcommon.h"
+#include <QStringList>
+#include "core/creature.h"
+#include "battle/battlesystem.h"
+
+bool parseTeam(const QString &text, QVector<TeamMember> &team, QString &error)
+{
+    team.clear();
+    const QStringList entries = text.split(',');
+    for (const QString &entry : entries) {
+        const QStringList parts = entry.trimmed().split(':');
+        if (parts.isEmpty() || parts[0].isEmpty()) continue;
+
+        TeamMember member;
+        member.speciesKey = parts[0];
+        member.level = 10;
+        if (parts.size() > 1) {
+            bool ok = false;
+            member.level = parts[1].toInt(&ok);
+            if (!ok || member.level < 1 || member.level > MAX_LEVEL) {
+                error = QString("无效的等级: %1").arg(entry);
+                return false;
+            }
+        }
+        member.species = Creature::findSpecies(member.speciesKey);
+        if (member.species == SpeciesId::NONE) {
+            error = QString("未知的精灵种类: %1（可选: %2）").arg(member.speciesKey).arg(Creature::getSpeciesKeys().join(", "));
+            return false;
+        }
+        team.append(member);
+    }
+    if (team.isEmpty()) {
+        error = "队伍不能为空";
+        return false;
+    }
+    return true;
+}
+
+QVector<Creature *> buildTeam(const QVector<TeamMember> &members)
+{
+    QVector<Creature *> team;
+    for (const TeamMember &member : members) {
+        team.append(Creature::createSpecies(member.species, member.level));
+    }
+    return team;
+}
+
+void submitPlayerAction(BattleSystem &battle, BattleRandom &rng)
+{
+    Creature *active = battle.getPlayerActiveCreature();
+    if (!active) return;
+
+    if (active->isDead()) {
+        const QVector<Creature *> team = battle.getPlayerTeam();
+        for (int i = 0; i < team.size(); ++i) {
+            if (team[i] && !team[i]->isDead()) {
+                battle.playerSubmittedAction(BattleAction::SWITCH_CREATURE, i);
+                return;
+            }
+        }
+        return;
+    }
+
+    if (!active->canAct()) {
+        battle.playerSubmittedAction(BattleAction::USE_SKILL, 0); // 无法行动时由战斗系统记为跳过
+        return;
+    }
+
+    int usableSkillIndices[MAX_SKILL_COUNT + 1];
+    int usableSkillCount = 0;
+    for (int i = 0; i < active->getSkillCount() && i < MAX_SKILL_COUNT; ++i) {
+        Skill *skill = active->getSkill(i);
+        if (skill && active->getCurrentPP() >= skill->getPPCost()) usableSkillIndices[usableSkillCount++] = i;
+    }
+    Skill *fifthSkill = active->getFifthSkill();
+    if (fifthSkill && active->getCurrentPP() >= fifthSkill->getPPCost()) usableSkillIndices[usableSkillCount++] = -1;
+
+    if (usableSkillCount == 0) {
+        battle.playerSubmittedAction(BattleAction::RESTORE_PP);
+        return;
+    }
+    battle.playerSubmittedAction(BattleAction::USE_SKILL, usableSkillIndices[rng.bounded(usableSkillCount)]);
+}
@@ -0,0 +1,32 @@
+// src/tools/simcommon.h
+#ifndef SIMCOMMON_H
+#define SIMCOMMON_H
+
+#include <QString>
+#include <QVector>
+
+class Creature;
+enum class SpeciesId : quint16;
+class BattleSystem;
+class BattleRandom;
+
+// 命令行工具（模拟器、循环赛）共用的队伍解析与玩家一方策略
+
+// 队伍描述中的一项：精灵模板键名 + 等级
+struct TeamMember
+{
+    QString speciesKey; // 用于输出
+    SpeciesId species;  // 解析时由键名换算，建队时直接使用
+    int level;
+};
+
+// 解析 "TungTungTung:10,LiriliLarila:8" 形式的队伍描述
+bool parseTeam(const QString &text, QVector<TeamMember> &team, QString &error);
+
+// 按描述创建精灵，调用方负责释放
+QVector<Creature *> buildTeam(const QVector<TeamMember> &members);
+
+// 玩家一方的简单策略：与内置AI相同，随机选择一个PP足够的技能；濒死时换上下一只可战斗的精灵
+void submitPlayerAction(BattleSystem &battle, BattleRandom &rng);
+
+#endif // SIMCOMMON_H
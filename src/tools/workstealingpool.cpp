@@ -0,0 +1,82 @@
+// src/tools/workstealingpool.cpp
+#include "workstealingpool.h"
+#include <QMutexLocker>
+#include <QThread>
+#include <QVector>
+
+WorkStealingPool::WorkStealingPool(int threadCount)
+    : m_nextQueue(0),
+      m_stolenCount(0)
+{
+    const int count = qMax(1, threadCount > 0 ? threadCount : QThread::idealThreadCount());
+    for (int i = 0; i < count; ++i)
+    {
+        m_queues.push_back(std::unique_ptr<WorkQueue>(new WorkQueue));
+    }
+}
+
+void WorkStealingPool::submit(Task task)
+{
+    WorkQueue &queue = *m_queues[m_nextQueue];
+    m_nextQueue = (m_nextQueue + 1) % getThreadCount();
+    QMutexLocker locker(&queue.mutex);
+    queue.tasks.push_back(std::move(task));
+}
+
+bool WorkStealingPool::takeTask(int worker, Task &task)
+{
+    // 先取自己队列的头部
+    {
+        WorkQueue &own = *m_queues[worker];
+        QMutexLocker locker(&own.mutex);
+        if (!own.tasks.empty())
+        {
+            task = std::move(own.tasks.front());
+            own.tasks.pop_front();
+            return true;
+        }
+    }
+    // 再从其他队列的尾部窃取，从相邻的线程开始，避免所有线程都去抢同一个队列
+    const int count = getThreadCount();
+    for (int offset = 1; offset < count; ++offset)
+    {
+        WorkQueue &victim = *m_queues[(worker + offset) % count];
+        QMutexLocker locker(&victim.mutex);
+        if (!victim.tasks.empty())
+        {
+            task = std::move(victim.tasks.back());
+            victim.tasks.pop_back();
+            ++m_stolenCount;
+            return true;
+        }
+    }
+    return false;
+}
+
+void WorkStealingPool::workerLoop(int worker)
+{
+    Task task;
+    while (takeTask(worker, task))
+    {
+        task(worker);
+    }
+}
+
+void WorkStealingPool::run()
+{
+    m_stolenCount = 0;
+    QVector<QThread *> threads;
+    for (int i = 1; i < getThreadCount(); ++i)
+    {
+        QThread *thread = QThread::create([this, i]() { workerLoop(i); });
+        threads.append(thread);
+        thread->start();
+    }
+    workerLoop(0);
+    for (QThread *thread : threads)
+    {
+        thread->wait();
+        delete thread;
+    }
+    m_nextQueue = 0;
+}
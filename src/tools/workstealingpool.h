@@ -0,0 +1,48 @@
+// src/tools/workstealingpool.h
+#ifndef WORKSTEALINGPOOL_H
+#define WORKSTEALINGPOOL_H
+
+#include <QMutex>
+#include <atomic>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <vector>
+
+// 工作窃取线程池（批处理用）
+// 任务在run()之前全部提交，按轮转分配到各工作线程自己的队列；
+// 每个线程从自己队列的头部取任务，队列空了就从其他线程队列的尾部窃取，
+// 因此耗时不均的任务（如长短不一的对战）也能让所有核心一直有活干。
+// 任务执行中不会再产生新任务，所有队列都空了即可结束。
+class WorkStealingPool
+{
+public:
+    // 参数为执行该任务的工作线程编号（0..threadCount-1），用于访问线程私有的数据
+    using Task = std::function<void(int worker)>;
+
+    // threadCount <= 0 时使用 QThread::idealThreadCount()
+    explicit WorkStealingPool(int threadCount = 0);
+
+    int getThreadCount() const { return static_cast<int>(m_queues.size()); }
+    void submit(Task task);
+    // 执行全部任务，调用线程作为0号工作线程参与，返回时所有任务均已完成
+    void run();
+    // 上一次run中从其他线程窃取的任务数
+    int getStolenCount() const { return m_stolenCount.load(); }
+
+private:
+    struct WorkQueue
+    {
+        QMutex mutex;
+        std::deque<Task> tasks;
+    };
+
+    bool takeTask(int worker, Task &task);
+    void workerLoop(int worker);
+
+    std::vector<std::unique_ptr<WorkQueue>> m_queues;
+    int m_nextQueue;
+    std::atomic<int> m_stolenCount;
+};
+
+#endif // WORKSTEALINGPOOL_H
@@ -1,6 +1,7 @@
 // src/ui/battlescene.cpp
 #include "battlescene.h"
 #include "../battle/battlesystem.h" // 引入战斗系统
+#include "../battle/battlesignaladapter.h"
 #include "../core/creature.h"     // 引入精灵类
 #include "../battle/skill.h"      // 引入技能类
 #include <QLabel>
@@ -17,6 +18,9 @@
 #include <QFont>
 #include <QPixmap>
 
+// 回合结算后依次播放伤害/治疗动画的间隔（毫秒）
+const int TURN_ANIMATION_INTERVAL_MS = 350;
+
 // 技能按钮类实现
 class SkillButton : public QPushButton
 {
@@ -161,6 +165,7 @@ private:
 BattleScene::BattleScene(GameEngine *gameEngine, QWidget *parent) : QWidget(parent),
                                                                     m_gameEngine(gameEngine),
                                                                     m_battleSystem(gameEngine->getBattleSystem()),
+                                                                    m_battleSignals(nullptr),
                                                                     m_playerCreatureLabel(nullptr),
                                                                     m_opponentCreatureLabel(nullptr),
                                                                     m_playerHPBar(nullptr),
@@ -175,6 +180,7 @@ BattleScene::BattleScene(GameEngine *gameEngine, QWidget *parent) : QWidget(pare
                                                                     m_escapeButton(nullptr),
                                                                     m_fifthSkillButton(nullptr),
                                                                     m_restorePPButton(nullptr),
+                                                                    m_replayStepButton(nullptr),
                                                                     m_mainLayout(nullptr),
                                                                     m_battlefieldLayout(nullptr),
                                                                     m_playerLayout(nullptr),
@@ -185,32 +191,22 @@ BattleScene::BattleScene(GameEngine *gameEngine, QWidget *parent) : QWidget(pare
 {
     setupUI();  // 初始化UI元素
 
-    // 连接战斗系统信号到场景的槽函数
-    connect(m_battleSystem, &BattleSystem::battleStarted, this, &BattleScene::initScene);
-    connect(m_battleSystem, &BattleSystem::battleEnded, this, [this](BattleResult result)
+    // 连接战斗系统信号到场景的槽函数（经由适配器，战斗系统本身不发信号）
+    m_battleSignals = new BattleSignalAdapter(m_battleSystem, this);
+    connect(m_battleSignals, &BattleSignalAdapter::battleStarted, this, &BattleScene::initScene);
+    connect(m_battleSignals, &BattleSignalAdapter::battleEnded, this, [this](BattleResult result)
             {
-        // 显示战斗结果
-        QString resultMessage;
-        // 根据战斗结果设置消息文本
-        switch (result) {
-            case BattleResult::PLAYER_WIN: resultMessage = "你赢了!"; break;
-            case BattleResult::OPPONENT_WIN: resultMessage = "你输了!"; break;
-            case BattleResult::DRAW: resultMessage = "平局!"; break;
-            case BattleResult::ESCAPE: resultMessage = "成功逃脱!"; break;
-            default: resultMessage = "战斗结束";
-        }
-        updateBattleLog(resultMessage); // 在日志中显示结果
-        disableAllActionButtons();      // 战斗结束，禁用所有行动按钮
+        // 回合结算中结束的战斗由变化集统一显示结果
+        if (m_battleSystem && m_battleSystem->isCollectingTurnChanges()) return;
+        showBattleResult(result);
     });
 
-    connect(m_battleSystem, &BattleSystem::turnStarted, this, &BattleScene::onTurnStarted);
-    connect(m_battleSystem, &BattleSystem::turnEnded, this, &BattleScene::onTurnEnded);
-    connect(m_battleSystem, &BattleSystem::damageCaused, this, &BattleScene::onDamageCaused);
-    connect(m_battleSystem, &BattleSystem::healingReceived, this, &BattleScene::onHealingReceived);
-    connect(m_battleSystem, &BattleSystem::creatureSwitched, this, &BattleScene::onCreatureSwitched);
-    connect(m_battleSystem, &BattleSystem::battleLogUpdated, this, &BattleScene::onBattleLogUpdated);
-    connect(m_battleSystem, &BattleSystem::playerActionConfirmed, this, &BattleScene::onPlayerActionConfirmed);
-    connect(m_battleSystem, &BattleSystem::opponentActionConfirmed, this, &BattleScene::onOpponentActionConfirmed);
+    connect(m_battleSignals, &BattleSignalAdapter::turnStarted, this, &BattleScene::onTurnStarted);
+    connect(m_battleSignals, &BattleSignalAdapter::turnEnded, this, &BattleScene::onTurnEnded);
+    connect(m_battleSignals, &BattleSignalAdapter::battleEventAdded, this, &BattleScene::onBattleEventAdded);
+    connect(m_battleSignals, &BattleSignalAdapter::turnChangesReady, this, &BattleScene::onTurnChangesReady);
+    connect(m_battleSignals, &BattleSignalAdapter::playerActionConfirmed, this, &BattleScene::onPlayerActionConfirmed);
+    connect(m_battleSignals, &BattleSignalAdapter::opponentActionConfirmed, this, &BattleScene::onOpponentActionConfirmed);
 
     // 设置动画计时器
     m_animationTimer = new QTimer(this);
@@ -228,6 +224,10 @@ void BattleScene::disableAllActionButtons() {
 }
 // 辅助函数：启用玩家行动按钮
 void BattleScene::enablePlayerActionButtons() {
+    if (isReplaying()) { // 回放时行动按钮始终禁用
+        disableAllActionButtons();
+        return;
+    }
     Creature* playerCreature = nullptr;
     if (m_battleSystem) playerCreature = m_battleSystem->getPlayerActiveCreature();
 
@@ -313,6 +313,7 @@ void BattleScene::setupUI()
     m_opponentPPBar->setMinimum(0);
     m_opponentPPBar->setTextVisible(true);
     m_opponentPPBar->setFormat("PP: %v/%m");
+    m_opponentPPBar->setStyleSheet("QProgressBar { text-align: center; } QProgressBar::chunk { background-color: blue; }");
     oppStatusLayout->addWidget(m_opponentPPBar);
 
     m_opponentLayout->addLayout(oppStatusLayout);
@@ -339,6 +340,7 @@ void BattleScene::setupUI()
     m_playerPPBar->setMinimum(0);
     m_playerPPBar->setTextVisible(true);
     m_playerPPBar->setFormat("PP: %v/%m");
+    m_playerPPBar->setStyleSheet("QProgressBar { text-align: center; } QProgressBar::chunk { background-color: blue; }"); // PP条通常为蓝色
     playerStatusLayout->addWidget(m_playerPPBar);
 
     m_playerLayout->addLayout(playerStatusLayout);
@@ -413,6 +415,12 @@ void BattleScene::setupUI()
     connect(m_escapeButton, &QPushButton::clicked, this, &BattleScene::onEscapeButtonClicked);
     m_actionLayout->addWidget(m_escapeButton, 2, 1); // 放置在技能按钮下方
 
+    // 回放单步按钮，平时隐藏
+    m_replayStepButton = new QPushButton("下一回合", this);
+    connect(m_replayStepButton, &QPushButton::clicked, this, &BattleScene::onReplayStepButtonClicked);
+    m_actionLayout->addWidget(m_replayStepButton, 2, 2);
+    m_replayStepButton->hide();
+
     // 将各部分布局添加到主布局
     m_mainLayout->addLayout(m_battlefieldLayout, 3); // 战场占3份伸缩因子
     m_mainLayout->addLayout(m_logLayout, 1);         // 日志占1份
@@ -440,42 +448,40 @@ void BattleScene::initScene()
     if(m_escapeButton && m_battleSystem) m_escapeButton->setEnabled(!m_battleSystem->isPvPBattle()); // PvP中通常不能逃跑
     if(m_restorePPButton) m_restorePPButton->setEnabled(true); // 初始时允许恢复PP
 
+    // 回放：双方行动都来自录像，只保留单步按钮
+    if (m_replayStepButton) {
+        m_replayStepButton->setVisible(isReplaying());
+        m_replayStepButton->setEnabled(isReplaying());
+    }
+    if (isReplaying()) disableAllActionButtons();
+
     // 添加初始战斗日志
-    updateBattleLog("<b>战斗开始!</b>");
+    updateBattleLog(isReplaying() ? "<b>回放开始!</b>" : "<b>战斗开始!</b>");
 }
 
-void BattleScene::updatePlayerUI()
+void BattleScene::updatePlayerUI(bool reloadSprite)
 {
     if (!m_battleSystem) return;
     Creature *playerCreature = m_battleSystem->getPlayerActiveCreature();
     if (!playerCreature) return; // 如果没有玩家精灵，则不更新
 
-    // 更新精灵图像
-    QPixmap creaturePixmap(QString(":/sprites/%1_back.png").arg(playerCreature->getResourceName()));
-    if (creaturePixmap.isNull()) // 如果找不到特定精灵的图片，使用默认图片
-    {
-        creaturePixmap = QPixmap(":/sprites/default_back.png"); // 默认背面图
+    // 更新精灵图像（只在出场精灵变化时需要）
+    if (reloadSprite) {
+        QPixmap creaturePixmap(QString(":/sprites/%1_back.png").arg(playerCreature->getResourceName()));
+        if (creaturePixmap.isNull()) // 如果找不到特定精灵的图片，使用默认图片
+        {
+            creaturePixmap = QPixmap(":/sprites/default_back.png"); // 默认背面图
+        }
+        if(m_playerCreatureLabel) m_playerCreatureLabel->setPixmap(creaturePixmap.scaled(200, 200, Qt::KeepAspectRatio, Qt::SmoothTransformation));
     }
-    if(m_playerCreatureLabel) m_playerCreatureLabel->setPixmap(creaturePixmap.scaled(200, 200, Qt::KeepAspectRatio, Qt::SmoothTransformation));
 
     // 更新HP条
-    if(m_playerHPBar) {
-        m_playerHPBar->setMaximum(playerCreature->getMaxHP());
-        m_playerHPBar->setValue(playerCreature->getCurrentHP());
-        // 根据HP百分比设置HP条颜色
-        double hpRatio = static_cast<double>(playerCreature->getCurrentHP()) / playerCreature->getMaxHP();
-        QString hpColor;
-        if (hpRatio > 0.5) hpColor = "green";
-        else if (hpRatio > 0.25) hpColor = "yellow";
-        else hpColor = "red";
-        m_playerHPBar->setStyleSheet(QString("QProgressBar { text-align: center; } QProgressBar::chunk { background-color: %1; }").arg(hpColor));
-    }
+    updateHPBar(m_playerHPBar, playerCreature);
 
     // 更新PP条 (显示全局PP)
     if(m_playerPPBar) {
         m_playerPPBar->setMaximum(playerCreature->getMaxPP());
         m_playerPPBar->setValue(playerCreature->getCurrentPP());
-        m_playerPPBar->setStyleSheet("QProgressBar { text-align: center; } QProgressBar::chunk { background-color: blue; }"); // PP条通常为蓝色
     }
 
     // 更新状态标签 (名称、等级、类型、能力变化、异常状态)
@@ -499,38 +505,29 @@ void BattleScene::updatePlayerUI()
     }
 }
 
-void BattleScene::updateOpponentUI()
+void BattleScene::updateOpponentUI(bool reloadSprite)
 {
     if (!m_battleSystem) return;
     Creature *opponentCreature = m_battleSystem->getOpponentActiveCreature();
     if (!opponentCreature) return; // 如果没有对手精灵，则不更新
 
     // 更新精灵图像 (假设图片资源路径为 :/sprites/精灵名小写_front.png)
-    QPixmap creaturePixmap(QString(":/sprites/%1_front.png").arg(opponentCreature->getName().toLower().replace(' ', '_')));
-    if (creaturePixmap.isNull()) // 如果找不到特定精灵的图片，使用默认图片
-    {
-        creaturePixmap = QPixmap(":/sprites/default_front.png"); // 默认正面图
+    if (reloadSprite) {
+        QPixmap creaturePixmap(QString(":/sprites/%1_front.png").arg(opponentCreature->getName().toLower().replace(' ', '_')));
+        if (creaturePixmap.isNull()) // 如果找不到特定精灵的图片，使用默认图片
+        {
+            creaturePixmap = QPixmap(":/sprites/default_front.png"); // 默认正面图
+        }
+        if(m_opponentCreatureLabel) m_opponentCreatureLabel->setPixmap(creaturePixmap.scaled(200, 200, Qt::KeepAspectRatio, Qt::SmoothTransformation));
     }
-    if(m_opponentCreatureLabel) m_opponentCreatureLabel->setPixmap(creaturePixmap.scaled(200, 200, Qt::KeepAspectRatio, Qt::SmoothTransformation));
 
     // 更新HP条
-    if(m_opponentHPBar) {
-        m_opponentHPBar->setMaximum(opponentCreature->getMaxHP());
-        m_opponentHPBar->setValue(opponentCreature->getCurrentHP());
-        // 根据HP百分比设置HP条颜色
-        double hpRatio = static_cast<double>(opponentCreature->getCurrentHP()) / opponentCreature->getMaxHP();
-        QString hpColor;
-        if (hpRatio > 0.5) hpColor = "green";
-        else if (hpRatio > 0.25) hpColor = "yellow";
-        else hpColor = "red";
-        m_opponentHPBar->setStyleSheet(QString("QProgressBar { text-align: center; } QProgressBar::chunk { background-color: %1; }").arg(hpColor));
-    }
+    updateHPBar(m_opponentHPBar, opponentCreature);
 
     // 更新PP条 (显示全局PP)
     if(m_opponentPPBar) {
         m_opponentPPBar->setMaximum(opponentCreature->getMaxPP());
         m_opponentPPBar->setValue(opponentCreature->getCurrentPP());
-        m_opponentPPBar->setStyleSheet("QProgressBar { text-align: center; } QProgressBar::chunk { background-color: blue; }");
     }
 
     // 更新状态标签
@@ -554,6 +551,43 @@ void BattleScene::updateOpponentUI()
     }
 }
 
+// 更新HP条；颜色档位不变时不重设样式表，避免无谓的样式重算
+void BattleScene::updateHPBar(QProgressBar *bar, Creature *creature)
+{
+    if (!bar || !creature) return;
+    bar->setMaximum(creature->getMaxHP());
+    bar->setValue(creature->getCurrentHP());
+    // 根据HP百分比设置HP条颜色
+    double hpRatio = static_cast<double>(creature->getCurrentHP()) / creature->getMaxHP();
+    QString hpColor;
+    if (hpRatio > 0.5) hpColor = "green";
+    else if (hpRatio > 0.25) hpColor = "yellow";
+    else hpColor = "red";
+    if (bar->property("hpColor").toString() == hpColor) return;
+    bar->setProperty("hpColor", hpColor);
+    bar->setStyleSheet(QString("QProgressBar { text-align: center; } QProgressBar::chunk { background-color: %1; }").arg(hpColor));
+}
+
+// 技能提示中的伤害预估：按当前双方状态计算的伤害范围、期望与击倒率
+QString BattleScene::getDamagePreviewText(Creature *attacker, Skill *skill) const
+{
+    if (!m_battleSystem || !attacker || !skill) return QString();
+    Creature *defender = m_battleSystem->getOpponentActiveCreature();
+    if (!defender || defender->isDead()) return QString();
+
+    const DamageDistribution distribution = m_battleSystem->getDamageDistribution(attacker, defender, skill);
+    if (!distribution.isAttack) return QString();
+
+    return QString("<br><br><b>预计伤害:</b> %1-%2（期望 %3）<br>"
+                   "<b>命中率:</b> %4%<br>"
+                   "<b>击倒率:</b> %5%")
+        .arg(distribution.minDamage)
+        .arg(distribution.maxDamage)
+        .arg(distribution.expectedDamage, 0, 'f', 1)
+        .arg(distribution.hitProbability * 100.0, 0, 'f', 0)
+        .arg(distribution.koProbability * 100.0, 0, 'f', 1);
+}
+
 void BattleScene::updateSkillButtons()
 {
     if (!m_battleSystem) return;
@@ -585,6 +619,9 @@ void BattleScene::updateSkillButtons()
                 skill = playerCreature->getSkill(i);
             }
             m_skillButtons[i]->setSkill(skill, playerCreature); // 传递精灵指针以检查PP
+            if (skill) {
+                m_skillButtons[i]->setToolTip(m_skillButtons[i]->toolTip() + getDamagePreviewText(playerCreature, skill));
+            }
         }
     }
 
@@ -627,7 +664,7 @@ void BattleScene::updateSkillButtons()
                 .arg(playerCreature->getCurrentPP())
                 .arg(fifthSkill->getDescription());
                 
-            m_fifthSkillButton->setToolTip(tooltipText);
+            m_fifthSkillButton->setToolTip(tooltipText + getDamagePreviewText(playerCreature, fifthSkill));
             
             // 根据PP是否足够设置按钮样式
             if(!canUse) {
@@ -671,23 +708,55 @@ void BattleScene::updateSkillButtons()
 }
 
 void BattleScene::updateBattleLog(const QString &message)
+{
+    appendBattleLog(QStringList{message});
+}
+
+// 一次追加多条日志：只设置一次文本、滚动一次
+void BattleScene::appendBattleLog(const QStringList &messages)
 {
     if(!m_battleLogLabel) return;
     QString currentText = m_battleLogLabel->text();
-    if (!currentText.isEmpty())
+    bool changed = false;
+    for (const QString &message : messages)
     {
-        currentText += "<br>"; // HTML换行
+        if (message.isEmpty()) continue;
+        if (!currentText.isEmpty())
+        {
+            currentText += "<br>"; // HTML换行
+        }
+        currentText += message;
+        changed = true;
     }
-    currentText += message;
+    if (!changed) return;
     m_battleLogLabel->setText(currentText);
 
-    // 自动滚动到底部 (需要 QScrollArea 和其内部的 QScrollBar)
-    QScrollArea* scrollArea = m_battleLogLabel->parentWidget()->parentWidget()->findChild<QScrollArea*>();
+    // 自动滚动到底部
+    QScrollArea* scrollArea = nullptr;
+    if (m_battleLogLabel->parentWidget() && m_battleLogLabel->parentWidget()->parentWidget()) {
+        scrollArea = qobject_cast<QScrollArea*>(m_battleLogLabel->parentWidget()->parentWidget());
+    }
     if (scrollArea) {
         scrollArea->verticalScrollBar()->setValue(scrollArea->verticalScrollBar()->maximum());
     }
 }
 
+void BattleScene::showBattleResult(BattleResult result)
+{
+    // 显示战斗结果
+    QString resultMessage;
+    // 根据战斗结果设置消息文本
+    switch (result) {
+        case BattleResult::PLAYER_WIN: resultMessage = "你赢了!"; break;
+        case BattleResult::OPPONENT_WIN: resultMessage = "你输了!"; break;
+        case BattleResult::DRAW: resultMessage = "平局!"; break;
+        case BattleResult::ESCAPE: resultMessage = "成功逃脱!"; break;
+        default: resultMessage = "战斗结束";
+    }
+    updateBattleLog(resultMessage); // 在日志中显示结果
+    disableAllActionButtons();      // 战斗结束，禁用所有行动按钮
+}
+
 // --- 按钮点击处理函数 ---
 // 玩家点击技能按钮（普通或第五技能）
 void BattleScene::onSkillButtonClicked(int skillIndex) {
@@ -747,11 +816,29 @@ void BattleScene::onEscapeButtonClicked() {
     m_battleSystem->playerSubmittedAction(BattleAction::ESCAPE);
 }
 
+// 回放：提交录像中的下一回合行动，回合在本次调用内结算并通过变化集刷新界面
+void BattleScene::onReplayStepButtonClicked() {
+    if (!isReplaying()) return;
+    m_gameEngine->getReplayer()->step();
+}
+
+bool BattleScene::isReplaying() const {
+    return m_gameEngine && m_gameEngine->getReplayer();
+}
+
 // --- 响应行动确认 ---
 void BattleScene::onPlayerActionConfirmed() {
     disableAllActionButtons(); // 玩家提交行动后，禁用所有行动按钮
     // BattleSystem 会记录更具体的日志，例如 "玩家选择了XX"
     // updateBattleLog("<i>等待对手行动...</i>"); 
+
+    // 人机对战时由界面负责AI的“思考”演出延迟，战斗系统本身不再依赖定时器
+    if (m_battleSystem && !m_battleSystem->isPvPBattle() &&
+        m_battleSystem->getTurnResolutionMode() == TurnResolutionMode::INTERACTIVE) {
+        Creature *playerCreature = m_battleSystem->getPlayerActiveCreature();
+        int thinkDelay = (playerCreature && playerCreature->canAct()) ? 500 : 100; // 玩家无法行动时缩短等待
+        QTimer::singleShot(thinkDelay, m_battleSystem, &BattleSystem::decideAIAction);
+    }
 }
 
 void BattleScene::onOpponentActionConfirmed() {
@@ -761,39 +848,71 @@ void BattleScene::onOpponentActionConfirmed() {
 }
 
 // --- 回合管理槽函数 ---
-void BattleScene::onBattleLogUpdated(const QString &message) // 使用传入的 message
+void BattleScene::onBattleEventAdded(const BattleEvent &event)
 {
-    if(!m_battleLogLabel) return;
-    QString currentText = m_battleLogLabel->text();
-    if (!currentText.isEmpty() && !message.isEmpty()) // 只有在旧文本和新消息都不为空时才加换行
-    {
-        currentText += "<br>"; // HTML换行
-    }
-    currentText += message; // 追加新的消息
-    m_battleLogLabel->setText(currentText);
+    if(!m_battleSystem) return;
+    // 回合结算中的事件稍后随变化集一起处理
+    if (m_battleSystem->isCollectingTurnChanges()) return;
+    // 结算之外的事件（回合开始、行动提交等）不改变精灵状态，只追加日志
+    appendBattleLog(QStringList{m_battleSystem->formatBattleEvent(event)});
+}
 
-    // 自动滚动到底部
-    QScrollArea* scrollArea = nullptr;
-    if (m_battleLogLabel && m_battleLogLabel->parentWidget() && m_battleLogLabel->parentWidget()->parentWidget()) {
-        scrollArea = qobject_cast<QScrollArea*>(m_battleLogLabel->parentWidget()->parentWidget());
+// 一个回合结算完毕：日志、控件与动画在这里一次性处理
+void BattleScene::onTurnChangesReady(const BattleTurnChanges &changes)
+{
+    if(!m_battleSystem) return;
+
+    // 1. 日志：整回合的消息拼接后只设置一次文本
+    QStringList messages;
+    messages.reserve(static_cast<int>(changes.events.size()));
+    for (const BattleEvent &event : changes.events) {
+        messages.append(m_battleSystem->formatBattleEvent(event));
     }
-    if (scrollArea) {
-        scrollArea->verticalScrollBar()->setValue(scrollArea->verticalScrollBar()->maximum());
+    appendBattleLog(messages);
+
+    // 2. 控件：每一侧最多刷新一次，出场精灵变化时才重新加载图像
+    Creature *activeCreatures[2] = {m_battleSystem->getPlayerActiveCreature(), m_battleSystem->getOpponentActiveCreature()};
+    for (int side = 0; side < 2; ++side) {
+        const bool switched = changes.isActiveChanged(side);
+        if (!switched && !changes.findCreature(side, changes.activeAfter[side])) continue; // 出场精灵没有变化
+        if (side == 0) updatePlayerUI(switched);
+        else updateOpponentUI(switched);
     }
-
-    // 日志更新可能意味着精灵状态改变，刷新UI和技能按钮
-    updatePlayerUI();
-    updateOpponentUI();
     updateSkillButtons();
+    if (isReplaying()) disableAllActionButtons();
+
+    // 3. 动画：按事件顺序依次播放结算后仍在场上的精灵的伤害与治疗
+    int step = 0;
+    for (const BattleEvent &event : changes.events) {
+        const bool isDamage = event.kind == BattleEventKind::SKILL_DAMAGE || event.kind == BattleEventKind::DAMAGED;
+        if (!isDamage && event.kind != BattleEventKind::HEALED) continue;
+        if (event.targetSide < 0 || event.targetIndex != changes.activeAfter[event.targetSide] || event.amount <= 0) continue;
+        QLabel *label = (event.targetSide == 0) ? m_playerCreatureLabel : m_opponentCreatureLabel;
+        Creature *target = activeCreatures[event.targetSide];
+        const int amount = event.amount;
+        QTimer::singleShot(step * TURN_ANIMATION_INTERVAL_MS, this, [this, label, target, isDamage, amount]() {
+            // 动画排队期间可能已开始新的战斗或换了精灵
+            if (!m_battleSystem || (target != m_battleSystem->getPlayerActiveCreature() &&
+                                    target != m_battleSystem->getOpponentActiveCreature())) return;
+            if (isDamage) animateDamage(label, amount);
+            else animateHealing(label, amount);
+        });
+        ++step;
+    }
+
+    if (static_cast<BattleResult>(changes.result) != BattleResult::ONGOING) {
+        showBattleResult(static_cast<BattleResult>(changes.result));
+    }
+    if (isReplaying() && m_replayStepButton) {
+        m_replayStepButton->setEnabled(!m_gameEngine->getReplayer()->isFinished());
+    }
 }
 
 // 当新回合的输入阶段开始时调用
 void BattleScene::onTurnStarted(int turn, bool isPlayerTurn_unused /* 此参数现在意义不大，因为总是玩家先输入 */) {
     if(m_turnLabel) m_turnLabel->setText(QString("回合: %1").arg(turn));
 
-    // 刷新双方UI状态
-    updatePlayerUI();
-    updateOpponentUI();
+    // 双方状态已在initScene或上一回合的变化集中刷新过
     
     // 如果战斗仍在进行，则为玩家启用行动按钮
     if (m_battleSystem && m_battleSystem->getBattleResult() == BattleResult::ONGOING) {
@@ -808,76 +927,11 @@ void BattleScene::onTurnStarted(int turn, bool isPlayerTurn_unused /* 此参数
 
 // 当一个完整回合的执行阶段结束后调用
 void BattleScene::onTurnEnded(int turn) {
-    // 刷新UI，以反映回合结束效果（如中毒掉血、PP恢复等）
-    updatePlayerUI();
-    updateOpponentUI();
-    updateSkillButtons(); // 技能按钮的可用状态可能因PP变化而改变
+    // 回合结束效果（如中毒掉血、PP恢复等）已随变化集刷新到界面
     // BattleSystem 的 processTurnInputPhase 会记录下一回合的开始
     updateBattleLog(QString("<i>第 %1 回合行动结算完毕.</i>").arg(turn));
 }
 
-void BattleScene::onDamageCaused(Creature *creature, int damage)
-{
-    QLabel *targetLabel = nullptr; // 受到伤害的精灵的图片标签
-
-    if (m_battleSystem && creature == m_battleSystem->getPlayerActiveCreature())
-    {
-        targetLabel = m_playerCreatureLabel;
-    }
-    else if (m_battleSystem && creature == m_battleSystem->getOpponentActiveCreature())
-    {
-        targetLabel = m_opponentCreatureLabel;
-    }
-    else
-    {
-        return; // 无效目标
-    }
-
-    animateDamage(targetLabel, damage); // 执行伤害动画
-
-    // 更新UI (HP条等会变化)
-    updatePlayerUI();
-    updateOpponentUI();
-}
-
-void BattleScene::onHealingReceived(Creature *creature, int amount)
-{
-    QLabel *targetLabel = nullptr; // 接受治疗的精灵的图片标签
-
-    if (m_battleSystem && creature == m_battleSystem->getPlayerActiveCreature())
-    {
-        targetLabel = m_playerCreatureLabel;
-    }
-    else if (m_battleSystem && creature == m_battleSystem->getOpponentActiveCreature())
-    {
-        targetLabel = m_opponentCreatureLabel;
-    }
-    else
-    {
-        return;
-    }
-
-    animateHealing(targetLabel, amount); // 执行治疗动画
-
-    // 更新UI
-    updatePlayerUI();
-    updateOpponentUI();
-}
-
-void BattleScene::onCreatureSwitched(Creature *oldCreature, Creature *newCreature, bool isPlayer)
-{
-    // 添加日志："[玩家/对手] 切换到了 [新精灵名]!"
-    QString message = QString("%1 切换到了 %2!")
-                          .arg(isPlayer ? "你" : "对手")
-                          .arg(newCreature ? newCreature->getName() : "未知精灵");
-    updateBattleLog(message);
-
-    // 更新UI以反映新上场的精灵
-    updatePlayerUI();
-    updateOpponentUI();
-    updateSkillButtons(); // 新精灵的技能和PP需要更新按钮
-}
-
 void BattleScene::animateDamage(QLabel *label, int damage)
 {
     if (!label) return;
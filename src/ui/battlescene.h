@@ -12,9 +12,12 @@
 #include <QTimer>
 
 #include "../core/gameengine.h" // 引入游戏引擎核心
+#include "../battle/battleevent.h" // 结构化战斗事件
+#include "../battle/battleturnchanges.h" // 回合结算变化集
 
 // 前向声明
 class BattleSystem; // 战斗系统类
+class BattleSignalAdapter; // 战斗信号适配器
 class SkillButton;  // 技能按钮类
 class Creature;     // 精灵类
 
@@ -42,12 +45,10 @@ private slots:
     void onEscapeButtonClicked();
 
     // 战斗相关信号响应
-    void onBattleLogUpdated(const QString &message); // 战斗日志更新
+    void onBattleEventAdded(const BattleEvent &event); // 战斗事件（格式化后追加到日志）
     void onTurnStarted(int turn, bool isPlayerTurn); // 回合开始
     void onTurnEnded(int turn);                      // 回合结束
-    void onDamageCaused(Creature *creature, int damage); // 造成伤害
-    void onHealingReceived(Creature *creature, int amount); // 受到治疗
-    void onCreatureSwitched(Creature *oldCreature, Creature *newCreature, bool isPlayer); // 精灵切换
+    void onTurnChangesReady(const BattleTurnChanges &changes); // 回合结算变化集（一次性刷新界面、安排动画）
     void onPlayerActionConfirmed();    // 响应玩家行动已确认的信号
     void onOpponentActionConfirmed();  // 响应对手行动已确认的信号（可选，用于UI反馈）
 
@@ -57,10 +58,14 @@ private slots:
     // 恢复PP按钮点击响应
     void onRestorePPButtonClicked();
 
+    // 回放时推进一个回合
+    void onReplayStepButtonClicked();
+
 private:
     // 游戏引擎和战斗系统
     GameEngine *m_gameEngine;       // 游戏引擎实例指针
     BattleSystem *m_battleSystem;   // 战斗系统实例指针
+    BattleSignalAdapter *m_battleSignals; // 把战斗观察者回调转成信号
 
     // UI组件
     QLabel *m_playerCreatureLabel;      // 玩家精灵图片标签
@@ -85,6 +90,9 @@ private:
     // 恢复PP按钮
     QPushButton *m_restorePPButton;     // 恢复PP按钮
 
+    // 回放单步按钮（只在回放时显示）
+    QPushButton *m_replayStepButton;
+
     // 布局
     QVBoxLayout *m_mainLayout;          // 主垂直布局
     QHBoxLayout *m_battlefieldLayout;   // 战场水平布局 (精灵显示区域)
@@ -100,12 +108,16 @@ private:
     void setupUI();
 
     // 更新UI显示
-    void updatePlayerUI();      // 更新玩家侧UI
-    void updateOpponentUI();    // 更新对手侧UI
+    void updatePlayerUI(bool reloadSprite = true);   // 更新玩家侧UI
+    void updateOpponentUI(bool reloadSprite = true); // 更新对手侧UI
+    void updateHPBar(QProgressBar *bar, Creature *creature); // 更新HP条数值与颜色
     void updateSkillButtons();  // 更新技能按钮状态和文本
     void updateBattleLog(const QString &message); // 更新战斗日志显示
+    void appendBattleLog(const QStringList &messages); // 一次追加多条日志
+    void showBattleResult(BattleResult result); // 显示战斗结果并禁用行动按钮
     void disableAllActionButtons(); // 辅助函数：禁用所有玩家行动按钮
     void enablePlayerActionButtons(); // 辅助函数：启用玩家行动按钮
+    bool isReplaying() const; // 当前战斗是否为回放
     
     // 动画效果 (伤害和治疗的数字跳动)
     void animateDamage(QLabel *label, int damage);  // 伤害动画
@@ -114,6 +126,7 @@ private:
     // 获取精灵状态文本
     QString getStatusText(StatusCondition condition); // 获取异常状态的文本描述
     QString getStatStageText(const StatStages &stages); // 获取能力等级变化的文本描述
+    QString getDamagePreviewText(Creature *attacker, Skill *skill) const; // 对当前对手的伤害范围与击倒率
 };
 
 #endif // BATTLESCENE_H
\ No newline at end of file
@@ -173,6 +173,7 @@ PrepareScene::PrepareScene(GameEngine* gameEngine, QWidget *parent) :
     m_removeButton(nullptr),
     m_startPvEButton(nullptr),
     m_startPvPButton(nullptr),
+    m_replayButton(nullptr),
     m_creatureLibraryTab(nullptr),
     m_availableCreaturesList(nullptr),
     m_availableCreatureDetail(nullptr),
@@ -251,6 +252,10 @@ void PrepareScene::setupUI() {
     m_startPvPButton->setStyleSheet("background-color: #FF9800; color: white;");
     teamButtonLayout->addWidget(m_startPvPButton);
 
+    m_replayButton = new QPushButton("回放上一场", m_teamTab);
+    m_replayButton->setEnabled(false); // 打过一场战斗后启用
+    teamButtonLayout->addWidget(m_replayButton);
+
     teamButtonLayout->addStretch(); // 弹性空间
 
     QPushButton* backButton = new QPushButton("返回主菜单", m_teamTab);
@@ -324,6 +329,7 @@ void PrepareScene::setupUI() {
     connect(m_addButton, &QPushButton::clicked, this, &PrepareScene::onAddCreatureClicked);
     connect(m_startPvEButton, &QPushButton::clicked, this, &PrepareScene::onStartPvEBattleClicked);
     connect(m_startPvPButton, &QPushButton::clicked, this, &PrepareScene::onStartPvPBattleClicked);
+    connect(m_replayButton, &QPushButton::clicked, this, &PrepareScene::onReplayLastBattleClicked);
     connect(backButton, &QPushButton::clicked, this, &PrepareScene::onBackToMainMenuClicked);
 }
 
@@ -348,6 +354,7 @@ void PrepareScene::refreshScene() {
     bool teamIsNotEmpty = !m_gameEngine->getPlayerTeam().isEmpty();
     if (m_startPvEButton) m_startPvEButton->setEnabled(teamIsNotEmpty);
     if (m_startPvPButton) m_startPvPButton->setEnabled(teamIsNotEmpty);
+    if (m_replayButton) m_replayButton->setEnabled(!m_gameEngine->getLastBattleReplay().playerTeam.isEmpty());
 }
 
 void PrepareScene::updatePlayerCreaturesList() {
@@ -442,7 +449,10 @@ void PrepareScene::onAddCreatureClicked() {
         if (m_gameEngine->getPlayerTeam().size() < 6) { // 检查队伍数量是否已满 (最多6只)
             // 重要：不能直接添加模板，需要创建模板的一个新实例
             // GameEngine 应该提供一个方法根据模板名或类型创建新实例
-            Creature* newCreatureInstance = m_gameEngine->createCreature(creatureTemplate->getName(), creatureTemplate->getLevel()); // 假设等级与模板一致
+            // 按种类复制模板（精灵名称可能与种类键名不同），才能保留具体种类
+            Creature* newCreatureInstance = creatureTemplate->getSpeciesId() != SpeciesId::NONE
+                ? m_gameEngine->createCreature(creatureTemplate->getSpeciesId(), creatureTemplate->getLevel()) // 假设等级与模板一致
+                : m_gameEngine->createCreature(creatureTemplate->getName(), creatureTemplate->getLevel());
             if (newCreatureInstance) {
                 m_gameEngine->addCreatureToPlayerTeam(newCreatureInstance);
                 // refreshScene(); // playerTeamChanged信号会自动触发刷新
@@ -495,6 +505,15 @@ void PrepareScene::onStartPvPBattleClicked() {
     m_gameEngine->startPvPBattle(); // 通知游戏引擎开始PvP战斗 (目前可能也是打AI)
 }
 
+void PrepareScene::onReplayLastBattleClicked() {
+    if (!m_gameEngine) return;
+    // 复制一份：回放开始时录制器会开始录制新的一场
+    const BattleReplay replay = m_gameEngine->getLastBattleReplay();
+    if (replay.playerTeam.isEmpty() || !m_gameEngine->startReplay(replay)) {
+        QMessageBox::warning(this, "无法回放", "没有可以回放的战斗。");
+    }
+}
+
 void PrepareScene::onBackToMainMenuClicked() {
     if (m_gameEngine) {
         // 在返回主菜单前，询问是否保存当前进度
@@ -60,6 +60,7 @@ private slots:
     void onRemoveCreatureClicked();               // "从队伍移除"按钮点击
     void onStartPvEBattleClicked();               // "开始PvE对战"按钮点击
     void onStartPvPBattleClicked();               // "开始PvP对战"按钮点击
+    void onReplayLastBattleClicked();             // "回放上一场"按钮点击
     void onBackToMainMenuClicked();               // "返回主菜单"按钮点击
 
     // 游戏引擎信号响应槽函数
@@ -83,6 +84,7 @@ private:
     QPushButton* m_removeButton;            // 从队伍移除精灵的按钮
     QPushButton* m_startPvEButton;          // 开始PvE对战的按钮
     QPushButton* m_startPvPButton;          // 开始PvP对战的按钮
+    QPushButton* m_replayButton;            // 回放上一场战斗的按钮
 
     // "精灵库" 标签页相关组件
     QWidget* m_creatureLibraryTab;                // "精灵库"标签页的Widget